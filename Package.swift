@@ -80,6 +80,7 @@ let notSyncServerSources: [String] = [
     "realm/group_writer.cpp",
     "realm/history.cpp",
     "realm/impl",
+    "realm/index_sorted.cpp",
     "realm/index_string.cpp",
     "realm/link_translator.cpp",
     "realm/list.cpp",
@@ -90,6 +91,7 @@ let notSyncServerSources: [String] = [
     "realm/object_converter.cpp",
     "realm/object_id.cpp",
     "realm/query.cpp",
+    "realm/query_cache.cpp",
     "realm/query_engine.cpp",
     "realm/query_expression.cpp",
     "realm/query_value.cpp",
@@ -186,6 +186,21 @@ public:
     {
         return m_result;
     }
+    // Add the sum of 'count' values computed elsewhere
+    void add(ResultType sum, size_t count)
+    {
+        if constexpr (std::is_integral_v<ResultType> && std::is_signed_v<ResultType>) {
+            m_result = std::make_unsigned_t<ResultType>(m_result) + sum;
+        }
+        else {
+            m_result += sum;
+        }
+        m_count += count;
+    }
+    void combine(const Sum& other)
+    {
+        add(other.m_result, other.m_count);
+    }
     size_t items_counted() const
     {
         return m_count;
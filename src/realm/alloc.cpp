@@ -107,6 +107,28 @@ Allocator& Allocator::get_default() noexcept
     return default_alloc;
 }
 
+void Allocator::prefetch(ref_type ref, size_t size) const noexcept
+{
+    RefTranslation* ref_translation_ptr = m_ref_translation_ptr.load(std::memory_order_acquire);
+    size_t baseline = m_baseline.load(std::memory_order_relaxed);
+    if (!ref_translation_ptr || ref == 0 || ref >= baseline)
+        return;
+    size_t idx = get_section_index(ref);
+    RefTranslation& txl = ref_translation_ptr[idx];
+    if (!txl.mapping_addr)
+        return;
+    // The primary mapping of a section covers the file up to the baseline,
+    // but never beyond the end of the section.
+    size_t offset = ref - get_section_base(idx);
+    size = std::min({size, section_size() - offset, baseline - ref});
+    if (txl.encrypted_mapping) {
+        // Decrypt the pages ahead of time instead
+        util::do_encryption_prefetch(txl.mapping_addr + offset, size, txl.encrypted_mapping);
+        return;
+    }
+    util::madvise(txl.mapping_addr + offset, size, util::AccessPattern::will_need);
+}
+
 // This function is called to handle translation of a ref which is above the limit for its
 // memory mapping. This requires one of three:
 // * bumping the limit of the mapping. (if the entire array is inside the mapping)
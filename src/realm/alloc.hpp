@@ -124,6 +124,24 @@ public:
     {
         m_is_read_only = ro;
     }
+
+    /// Hint to the operating system that the \a size bytes starting at the
+    /// specified 'ref' will be accessed soon, so that the pages can be read
+    /// into the page cache ahead of time. For encrypted files the pages are
+    /// decrypted ahead of time instead. Only refs in the immutable part of a
+    /// file mapping are considered; for anything else this is a no-op.
+    void prefetch(ref_type ref, size_t size) const noexcept;
+
+    /// When enabled, cluster traversals ask for the next cluster to be
+    /// prefetched while the current one is being processed.
+    bool get_prefetch_clusters() const noexcept
+    {
+        return m_prefetch_clusters;
+    }
+    void set_prefetch_clusters(bool enable) noexcept
+    {
+        m_prefetch_clusters = enable;
+    }
     /// Returns a simple allocator that can be used with free-standing
     /// Realm objects (such as a free-standing table). A
     /// free-standing object is one that is not part of a Group, and
@@ -317,6 +335,7 @@ protected:
 
 private:
     bool m_is_read_only = false; // prevent any alloc or free operations
+    bool m_prefetch_clusters = false;
 
     friend class Table;
     friend class ClusterTree;
@@ -337,6 +356,7 @@ public:
         m_baseline.store(m_alloc->m_baseline, std::memory_order_relaxed);
         m_debug_watch = 0;
         m_ref_translation_ptr.store(m_alloc->m_ref_translation_ptr);
+        set_prefetch_clusters(m_alloc->get_prefetch_clusters());
     }
 
     ~WrappedAllocator() {}
@@ -346,6 +366,7 @@ public:
         m_alloc = &underlying_allocator;
         m_baseline.store(m_alloc->m_baseline, std::memory_order_relaxed);
         m_debug_watch = 0;
+        set_prefetch_clusters(m_alloc->get_prefetch_clusters());
         refresh_ref_translation();
     }
 
@@ -105,15 +105,19 @@ void SlabAlloc::init_streaming_header(Header* streaming_header, int file_format_
     };
 }
 
-inline SlabAlloc::Slab::Slab(ref_type r, size_t s)
+inline SlabAlloc::Slab::Slab(ref_type r, size_t s, util::HugePages huge_pages)
     : ref_end(r)
     , size(s)
+    , mapped(huge_pages != util::HugePages::off)
 {
     // Ensure that allocation is aligned to at least 8 bytes
     static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= 8);
 
+    if (mapped)
+        addr = static_cast<char*>(util::mmap_anon(size, huge_pages)); // Throws
+    else
+        addr = new char[size];
     total_slab_allocated.fetch_add(s, std::memory_order_relaxed);
-    addr = new char[size];
     REALM_ASSERT((reinterpret_cast<size_t>(addr) & 0x7ULL) == 0);
 #if REALM_ENABLE_ALLOC_SET_ZERO
     std::fill(addr, addr + size, 0);
@@ -123,8 +127,12 @@ inline SlabAlloc::Slab::Slab(ref_type r, size_t s)
 SlabAlloc::Slab::~Slab()
 {
     total_slab_allocated.fetch_sub(size, std::memory_order_relaxed);
-    if (addr)
-        delete[] addr;
+    if (addr) {
+        if (mapped)
+            util::munmap(addr, size);
+        else
+            delete[] addr;
+    }
 }
 
 void SlabAlloc::detach(bool keep_file_open) noexcept
@@ -260,7 +268,18 @@ SlabAlloc::FreeBlock* SlabAlloc::get_next_block_if_mergeable(SlabAlloc::FreeBloc
 SlabAlloc::FreeList SlabAlloc::find(int size)
 {
     FreeList retval;
-    retval.it = m_block_map.lower_bound(size);
+    if (size < small_block_limit) {
+        int bin = find_small_bin(size / 8);
+        if (bin >= 0) {
+            retval.size = bin * 8;
+            return retval;
+        }
+        // all remaining free blocks are large ones
+        retval.it = m_block_map.begin();
+    }
+    else {
+        retval.it = m_block_map.lower_bound(size);
+    }
     if (retval.it != m_block_map.end()) {
         retval.size = retval.it->first;
     }
@@ -273,21 +292,55 @@ SlabAlloc::FreeList SlabAlloc::find(int size)
 SlabAlloc::FreeList SlabAlloc::find_larger(FreeList hint, int size)
 {
     int needed_size = size + sizeof(BetweenBlocks) + sizeof(FreeBlock);
-    while (hint.it != m_block_map.end() && hint.it->first < needed_size)
-        ++hint.it;
-    if (hint.it == m_block_map.end())
-        hint.size = 0; // indicate "not found"
-    return hint;
+    if (hint.size >= needed_size)
+        return hint;
+    return find(needed_size);
 }
 
-SlabAlloc::FreeBlock* SlabAlloc::pop_freelist_entry(FreeList list)
+int SlabAlloc::find_small_bin(int bin) const noexcept
 {
-    FreeBlock* retval = list.it->second;
-    FreeBlock* header = retval->next;
-    if (header == retval)
-        m_block_map.erase(list.it);
+    int word = bin / bins_per_mask_word;
+    size_t bits = m_small_block_mask[word] & (~size_t(0) << (bin % bins_per_mask_word));
+    for (;;) {
+        if (bits)
+            return word * bins_per_mask_word + ctz(bits);
+        if (++word == num_small_bins / bins_per_mask_word)
+            return -1;
+        bits = m_small_block_mask[word];
+    }
+}
+
+void SlabAlloc::mark_small_bin(int bin, bool non_empty) noexcept
+{
+    size_t bit = size_t(1) << (bin % bins_per_mask_word);
+    if (non_empty)
+        m_small_block_mask[bin / bins_per_mask_word] |= bit;
     else
-        list.it->second = header;
+        m_small_block_mask[bin / bins_per_mask_word] &= ~bit;
+}
+
+SlabAlloc::FreeBlock* SlabAlloc::pop_freelist_entry(FreeList list)
+{
+    FreeBlock* retval;
+    if (list.size < small_block_limit) {
+        FreeBlock*& header = m_small_blocks[list.size / 8];
+        retval = header;
+        if (retval->next == retval) {
+            header = nullptr;
+            mark_small_bin(list.size / 8, false);
+        }
+        else {
+            header = retval->next;
+        }
+    }
+    else {
+        retval = list.it->second;
+        FreeBlock* header = retval->next;
+        if (header == retval)
+            m_block_map.erase(list.it);
+        else
+            list.it->second = header;
+    }
     retval->unlink();
     return retval;
 }
@@ -301,18 +354,39 @@ void SlabAlloc::FreeBlock::unlink()
     clear_links();
 }
 
+void SlabAlloc::FreeBlock::link_in_front_of(FreeBlock* header)
+{
+    next = header;
+    prev = header->prev;
+    prev->next = this;
+    next->prev = this;
+}
+
 void SlabAlloc::remove_freelist_entry(FreeBlock* entry)
 {
     int size = bb_before(entry)->block_after_size;
-    auto it = m_block_map.find(size);
-    REALM_ASSERT_EX(it != m_block_map.end(), get_file_path_for_assertions());
-    auto header = it->second;
-    if (header == entry) {
-        header = entry->next;
-        if (header == entry)
-            m_block_map.erase(it);
-        else
-            it->second = header;
+    if (size < small_block_limit) {
+        FreeBlock*& header = m_small_blocks[size / 8];
+        REALM_ASSERT_EX(header, get_file_path_for_assertions());
+        if (header == entry) {
+            header = entry->next;
+            if (header == entry) {
+                header = nullptr;
+                mark_small_bin(size / 8, false);
+            }
+        }
+    }
+    else {
+        auto it = m_block_map.find(size);
+        REALM_ASSERT_EX(it != m_block_map.end(), get_file_path_for_assertions());
+        auto header = it->second;
+        if (header == entry) {
+            header = entry->next;
+            if (header == entry)
+                m_block_map.erase(it);
+            else
+                it->second = header;
+        }
     }
     entry->unlink();
 }
@@ -320,18 +394,25 @@ void SlabAlloc::remove_freelist_entry(FreeBlock* entry)
 void SlabAlloc::push_freelist_entry(FreeBlock* entry)
 {
     int size = bb_before(entry)->block_after_size;
-    FreeBlock* header;
+    if (size < small_block_limit) {
+        FreeBlock*& header = m_small_blocks[size / 8];
+        if (header) {
+            entry->link_in_front_of(header);
+        }
+        else {
+            entry->next = entry->prev = entry;
+            mark_small_bin(size / 8, true);
+        }
+        header = entry;
+        return;
+    }
+
     auto it = m_block_map.find(size);
     if (it != m_block_map.end()) {
-        header = it->second;
+        entry->link_in_front_of(it->second);
         it->second = entry;
-        entry->next = header;
-        entry->prev = header->prev;
-        entry->prev->next = entry;
-        entry->next->prev = entry;
     }
     else {
-        header = nullptr;
         m_block_map[size] = entry;
         entry->next = entry->prev = entry;
     }
@@ -402,6 +483,8 @@ SlabAlloc::FreeBlock* SlabAlloc::slab_to_entry(const Slab& slab, ref_type ref_st
 void SlabAlloc::clear_freelists()
 {
     m_block_map.clear();
+    std::fill(std::begin(m_small_blocks), std::end(m_small_blocks), nullptr);
+    std::fill(std::begin(m_small_block_mask), std::end(m_small_block_mask), 0);
 }
 
 void SlabAlloc::rebuild_freelists_from_slab()
@@ -464,6 +547,11 @@ SlabAlloc::FreeBlock* SlabAlloc::grow_slab(int size)
         new_size = already_allocated;
     if (new_size > maximal_alloc)
         new_size = maximal_alloc;
+    // Slabs backed by huge pages are whole huge pages
+    if (new_size < minimal_slab_size())
+        new_size = minimal_slab_size();
+    else if (m_huge_pages != util::HugePages::off)
+        new_size = (new_size + util::huge_page_size - 1) & ~(util::huge_page_size - 1);
 
     ref_type ref;
     if (m_slabs.empty()) {
@@ -486,7 +574,7 @@ SlabAlloc::FreeBlock* SlabAlloc::grow_slab(int size)
 
     std::lock_guard<std::mutex> lock(m_mapping_mutex);
     // Create new slab and add to list of slabs
-    m_slabs.emplace_back(ref_end, new_size); // Throws
+    m_slabs.emplace_back(ref_end, new_size, m_huge_pages); // Throws
     const Slab& slab = m_slabs.back();
     extend_fast_mapping_with_slab(slab.addr);
 
@@ -922,7 +1010,7 @@ ref_type SlabAlloc::attach_buffer(const char* data, size_t size)
 void SlabAlloc::init_in_memory_buffer()
 {
     m_attach_mode = attach_Heap;
-    m_virtual_file_buffer.emplace_back(64 * 1024 * 1024, 0);
+    m_virtual_file_buffer.emplace_back(64 * 1024 * 1024, 0, m_huge_pages);
     m_data = m_virtual_file_buffer.back().addr;
     m_virtual_file_size = sizeof(empty_file_header);
     memcpy(const_cast<char*>(m_data), &empty_file_header, m_virtual_file_size);
@@ -1113,7 +1201,7 @@ void SlabAlloc::reset_free_space_tracking()
 
     // release slabs.. keep the initial allocation if it's a minimal allocation,
     // otherwise release it as well. This saves map/unmap for small transactions.
-    while (m_slabs.size() > 1 || (m_slabs.size() == 1 && m_slabs[0].size > minimal_alloc)) {
+    while (m_slabs.size() > 1 || (m_slabs.size() == 1 && m_slabs[0].size > minimal_slab_size())) {
         auto& last_slab = m_slabs.back();
         auto& last_translation = m_ref_translation_ptr[m_translation_table_size - 1];
         REALM_ASSERT(last_translation.mapping_addr == last_slab.addr);
@@ -1271,6 +1359,19 @@ void SlabAlloc::update_reader_view(size_t file_size)
         }
 
         std::move(new_mappings.begin(), new_mappings.end(), std::back_inserter(m_mappings));
+
+        // Apply the read-ahead policy and huge page preference to the mappings
+        // which were added or extended. Encrypted pages are read through the decryption layer, so
+        // hints on the mapping itself would be meaningless.
+        if (!m_file.get_encryption()) {
+            for (size_t i = old_num_mappings > 0 ? old_num_mappings - 1 : 0; i < m_mappings.size(); ++i) {
+                auto& mapping = m_mappings[i].primary_mapping;
+                if (m_access_pattern != util::AccessPattern::normal)
+                    util::madvise(mapping.get_addr(), mapping.get_size(), m_access_pattern);
+                if (m_huge_pages != util::HugePages::off)
+                    util::advise_huge_pages(mapping.get_addr(), mapping.get_size());
+            }
+        }
     }
 
     m_baseline.store(file_size, std::memory_order_relaxed);
@@ -1516,7 +1617,7 @@ void SlabAlloc::resize_file(size_t new_file_size)
             current_size += b.size;
         }
         if (new_file_size > current_size) {
-            m_virtual_file_buffer.emplace_back(64 * 1024 * 1024, current_size);
+            m_virtual_file_buffer.emplace_back(64 * 1024 * 1024, current_size, m_huge_pages);
         }
         m_virtual_file_size = new_file_size;
     }
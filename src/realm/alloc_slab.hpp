@@ -190,6 +190,27 @@ public:
         return m_attach_mode == attach_Heap;
     }
 
+    /// Select the read-ahead policy which is applied to the read-only file
+    /// mappings. The policy takes effect for mappings established or
+    /// extended after the call. It has no effect on encrypted files or
+    /// in-memory realms.
+    void set_read_ahead(util::AccessPattern pattern) noexcept
+    {
+        m_access_pattern = pattern;
+    }
+
+    /// Back the slabs and in-memory buffers allocated after the call with huge
+    /// pages, and ask for the file mappings to use them where the filesystem
+    /// supports it.
+    void set_huge_pages(util::HugePages huge_pages) noexcept
+    {
+        m_huge_pages = huge_pages;
+    }
+    util::HugePages get_huge_pages() const noexcept
+    {
+        return m_huge_pages;
+    }
+
     /// Reads file format from file header. Must be called from within a write
     /// transaction.
     int get_committed_file_format_version() noexcept;
@@ -421,8 +442,9 @@ private:
         ref_type ref_end;
         char* addr;
         size_t size;
+        bool mapped; // Allocated with util::mmap_anon() rather than new
 
-        Slab(ref_type r, size_t s);
+        Slab(ref_type r, size_t s, util::HugePages huge_pages);
         ~Slab();
 
         Slab(const Slab&) = delete;
@@ -430,6 +452,7 @@ private:
             : ref_end(other.ref_end)
             , addr(other.addr)
             , size(other.size)
+            , mapped(other.mapped)
         {
             other.addr = nullptr;
             other.size = 0;
@@ -444,6 +467,7 @@ private:
         char* addr;
         size_t size;
         ref_type start_ref;
+        bool mapped = false; // Allocated with util::mmap_anon() rather than new
 
         MemBuffer()
             : addr(nullptr)
@@ -451,22 +475,28 @@ private:
             , start_ref(0)
         {
         }
-        MemBuffer(size_t s, ref_type ref)
-            : addr(new char[s])
-            , size(s)
+        MemBuffer(size_t s, ref_type ref, util::HugePages huge_pages)
+            : size(s)
             , start_ref(ref)
+            , mapped(huge_pages != util::HugePages::off)
         {
+            addr = mapped ? static_cast<char*>(util::mmap_anon(s, huge_pages)) : new char[s];
         }
         ~MemBuffer()
         {
-            if (addr)
-                delete[] addr;
+            if (addr) {
+                if (mapped)
+                    util::munmap(addr, size);
+                else
+                    delete[] addr;
+            }
         }
 
         MemBuffer(MemBuffer&& other) noexcept
             : addr(other.addr)
             , size(other.size)
             , start_ref(other.start_ref)
+            , mapped(other.mapped)
         {
             other.addr = nullptr;
             other.size = 0;
@@ -490,6 +520,7 @@ private:
             prev = next = nullptr;
         }
         void unlink();
+        void link_in_front_of(FreeBlock* header);
     };
     struct BetweenBlocks {         // stores sizes and used/free status of blocks before and after.
         int32_t block_before_size; // negated if block is in use,
@@ -500,11 +531,21 @@ private:
     using FreeListMap = std::map<int, FreeBlock*>; // log(N) addressing for larger blocks
     FreeListMap m_block_map;
 
+    // Small blocks are kept in size-segregated bins, bin i holding the free
+    // blocks of exactly 8 * i bytes. A bit is set in m_small_block_mask for
+    // every non-empty bin, so that the smallest bin which can satisfy a
+    // request is found with a couple of bit scans.
+    static constexpr int small_block_limit = 1024;
+    static constexpr int num_small_bins = small_block_limit / 8;
+    static constexpr int bins_per_mask_word = int(sizeof(size_t) * 8);
+    FreeBlock* m_small_blocks[num_small_bins] = {};
+    size_t m_small_block_mask[num_small_bins / bins_per_mask_word] = {};
+
     // abstract notion of a freelist - used to hide whether a freelist
     // is residing in the small blocks or the large blocks structures.
     struct FreeList {
-        int size = 0; // size of every element in the list, 0 if not found
-        FreeListMap::iterator it;
+        int size = 0;             // size of every element in the list, 0 if not found
+        FreeListMap::iterator it; // only used for large blocks
         bool found_something()
         {
             return size != 0;
@@ -560,6 +601,9 @@ private:
     // Searching/manipulating freelists
     FreeList find(int size);
     FreeList find_larger(FreeList hint, int size);
+    // index of the first non-empty small bin at or after 'bin', or -1 if none
+    int find_small_bin(int bin) const noexcept;
+    void mark_small_bin(int bin, bool non_empty) noexcept;
     FreeBlock* pop_freelist_entry(FreeList list);
     void push_freelist_entry(FreeBlock* entry);
     void remove_freelist_entry(FreeBlock* element);
@@ -663,6 +707,8 @@ private:
     size_t m_initial_section_size = 0;
     int m_section_shifts = 0;
     AttachMode m_attach_mode = attach_None;
+    util::AccessPattern m_access_pattern = util::AccessPattern::normal;
+    util::HugePages m_huge_pages = util::HugePages::off;
     enum FeeeSpaceState {
         free_space_Clean,
         free_space_Dirty,
@@ -670,6 +716,11 @@ private:
     };
     constexpr static int minimal_alloc = 128 * 1024;
     constexpr static int maximal_alloc = 1 << section_shift;
+    // The smallest slab, which is also kept between transactions
+    size_t minimal_slab_size() const noexcept
+    {
+        return m_huge_pages == util::HugePages::off ? minimal_alloc : util::huge_page_size;
+    }
 
     /// When set to free_space_Invalid, the free lists are no longer
     /// up-to-date. This happens if do_free() or
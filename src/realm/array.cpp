@@ -25,11 +25,13 @@
 #include <realm/array_integer.hpp>
 #include <realm/array_key.hpp>
 #include <realm/impl/array_writer.hpp>
+#include <realm/util/safe_int_ops.hpp>
 
 #include <array>
 #include <cstring> // std::memcpy
 #include <iomanip>
 #include <limits>
+#include <memory>
 #include <tuple>
 
 #ifdef REALM_DEBUG
@@ -71,6 +73,11 @@
 //        0    |  number of bits      |  ceil(width * size / 8)
 //        1    |  number of bytes     |  width * size
 //        2    |  ignored             |  size
+//        3    |  number of bits      |  ceil(width * size / 64) * 8 + 8
+//
+//      With width scheme 3 (frame-of-reference encoding) every element is
+//      stored as a non-negative offset from a 64-bit base value. The base
+//      value is placed immediately after the 8-byte aligned offsets.
 //
 //  5: 'width_ndx' (3 bits)
 //
@@ -224,7 +231,8 @@ void Array::set_type(Type type)
 {
     REALM_ASSERT(is_attached());
 
-    copy_on_write(); // Throws
+    expand_offset_encoding(); // Throws
+    copy_on_write();          // Throws
 
     bool init_is_inner_bptree_node = false, init_has_refs = false;
     switch (type) {
@@ -305,6 +313,127 @@ ref_type Array::do_write_deep(_impl::ArrayWriterBase& out, bool only_if_modified
 }
 
 
+ref_type Array::write_with_children(ref_type ref, Allocator& alloc, _impl::ArrayWriterBase& out,
+                                    util::FunctionRef<ref_type(size_t, ref_type)> write_child)
+{
+    if (alloc.is_read_only(ref))
+        return ref;
+
+    Array array(alloc);
+    array.init_from_ref(ref);
+    REALM_ASSERT(array.m_has_refs);
+
+    // Temp array for updated refs
+    Array new_array(Allocator::get_default());
+    new_array.create(array.get_type(), array.m_context_flag); // Throws
+    _impl::ShallowArrayDestroyGuard dg(&new_array);
+
+    size_t n = array.size();
+    for (size_t i = 0; i < n; ++i) {
+        int_fast64_t value = array.get(i);
+        bool is_ref = (value != 0 && (value & 1) == 0);
+        if (is_ref) {
+            ref_type new_subref = write_child(i, to_ref(value)); // Throws
+            value = from_ref(new_subref);
+        }
+        new_array.add(value); // Throws
+    }
+
+    return new_array.do_write_shallow(out); // Throws
+}
+
+
+ref_type Array::write_offset_encoded(_impl::ArrayWriterBase& out, bool only_if_modified) const
+{
+    REALM_ASSERT(is_attached());
+    REALM_ASSERT(!m_has_refs);
+
+    if (only_if_modified && m_alloc.is_read_only(m_ref))
+        return m_ref;
+
+    if (m_offset_encoded || m_size == 0)
+        return do_write_shallow(out); // Throws
+
+    int64_t min_value = get(0);
+    int64_t max_value = min_value;
+    for (size_t i = 1; i < m_size; ++i) {
+        int64_t v = get(i);
+        min_value = std::min(min_value, v);
+        max_value = std::max(max_value, v);
+    }
+
+    // The offsets must be representable as non-negative 64-bit integers
+    int64_t range = max_value;
+    if (util::int_subtract_with_overflow_detect(range, min_value))
+        return do_write_shallow(out); // Throws
+
+    size_t width = bit_width(range);
+    size_t byte_size = calc_byte_size(wtype_Offset, m_size, width);
+    if (byte_size >= get_byte_size())
+        return do_write_shallow(out); // Throws
+
+    std::unique_ptr<char[]> buffer(new char[byte_size]()); // Throws
+    char* header = buffer.get();
+    init_header(header, false, false, m_context_flag, wtype_Offset, int(width), m_size, byte_size);
+    char* data = get_data_from_header(header);
+    for (size_t i = 0; i < m_size; ++i)
+        set_direct(data, width, i, get(i) - min_value);
+    // The smallest and largest value double as a summary of the leaf that
+    // lets queries skip it without looking at the values
+    int64_t* summary = reinterpret_cast<int64_t*>(data + get_base_pos(m_size, uint_least8_t(width)));
+    summary[0] = min_value;
+    summary[1] = max_value;
+
+    uint32_t dummy_checksum = 0x41414141UL;                                // "AAAA" in ASCII
+    ref_type new_ref = out.write_array(header, byte_size, dummy_checksum); // Throws
+    REALM_ASSERT_3(new_ref % 8, ==, 0);                                    // 8-byte alignment
+    return new_ref;
+}
+
+
+ref_type Array::write_offset_encoded(ref_type ref, Allocator& alloc, _impl::ArrayWriterBase& out,
+                                     bool only_if_modified)
+{
+    if (only_if_modified && alloc.is_read_only(ref))
+        return ref;
+
+    Array array(alloc);
+    array.init_from_ref(ref);
+    return array.write_offset_encoded(out, false); // Throws
+}
+
+
+void Array::do_expand_offset_encoding()
+{
+    REALM_ASSERT_DEBUG(m_offset_encoded);
+
+    const char* old_header = get_header_from_data(m_data);
+    const char* old_data = m_data;
+    ref_type old_ref = m_ref;
+    size_t old_width = m_width;
+    int64_t base = m_base;
+
+    // The base is the smallest value, so the required width is decided by
+    // either the base or the largest value.
+    int64_t max_value = base;
+    for (size_t i = 0; i < m_size; ++i)
+        max_value = std::max(max_value, base + get_direct(old_data, old_width, i));
+    size_t width = std::max(bit_width(base), bit_width(max_value));
+
+    MemRef mem = create_node(m_size, m_alloc, m_context_flag, get_type(), wtype_Bits, int(width)); // Throws
+    char* new_data = get_data_from_header(mem.get_addr());
+    for (size_t i = 0; i < m_size; ++i)
+        set_direct(new_data, width, i, base + get_direct(old_data, old_width, i));
+
+    m_ref = mem.get_ref();
+    m_data = new_data;
+    update_width_cache_from_header();
+    update_parent(); // Throws
+
+    m_alloc.free_(old_ref, old_header);
+}
+
+
 void Array::move(size_t begin, size_t end, size_t dest_begin)
 {
     REALM_ASSERT_3(begin, <=, end);
@@ -314,7 +443,8 @@ void Array::move(size_t begin, size_t end, size_t dest_begin)
     REALM_ASSERT(!(dest_begin >= begin && dest_begin < end)); // Required by std::copy
 
     // Check if we need to copy before modifying
-    copy_on_write(); // Throws
+    expand_offset_encoding(); // Throws
+    copy_on_write();          // Throws
 
     size_t bits_per_elem = m_width;
     const char* header = get_header_from_data(m_data);
@@ -342,7 +472,9 @@ void Array::move(Array& dst, size_t ndx)
 {
     size_t dest_begin = dst.m_size;
     size_t nb_to_move = m_size - ndx;
+    dst.expand_offset_encoding();
     dst.copy_on_write();
+    dst.ensure_minimum_width(this->m_lbound);
     dst.ensure_minimum_width(this->m_ubound);
     dst.alloc(dst.m_size + nb_to_move, dst.m_width); // Make room for the new elements
 
@@ -366,7 +498,8 @@ void Array::set(size_t ndx, int64_t value)
         return;
 
     // Check if we need to copy before modifying
-    copy_on_write(); // Throws
+    expand_offset_encoding(); // Throws
+    copy_on_write();          // Throws
 
     // Grow the array if needed to store this value
     ensure_minimum_width(value); // Throws
@@ -420,6 +553,8 @@ void Array::insert(size_t ndx, int_fast64_t value)
 {
     REALM_ASSERT_DEBUG(ndx <= m_size);
 
+    expand_offset_encoding(); // Throws
+
     const auto old_width = m_width;
     const auto old_size = m_size;
     const Getter old_getter = m_getter; // Save old getter before potential width expansion
@@ -476,7 +611,8 @@ void Array::truncate(size_t new_size)
     if (new_size == m_size)
         return;
 
-    copy_on_write(); // Throws
+    expand_offset_encoding(); // Throws
+    copy_on_write();          // Throws
 
     // Update size in accessor and in header. This leaves the capacity
     // unchanged.
@@ -500,7 +636,8 @@ void Array::truncate_and_destroy_children(size_t new_size)
     if (new_size == m_size)
         return;
 
-    copy_on_write(); // Throws
+    expand_offset_encoding(); // Throws
+    copy_on_write();          // Throws
 
     if (m_has_refs) {
         size_t offset = new_size;
@@ -523,6 +660,9 @@ void Array::truncate_and_destroy_children(size_t new_size)
 
 void Array::do_ensure_minimum_width(int_fast64_t value)
 {
+    expand_offset_encoding(); // Throws
+    if (value >= m_lbound && value <= m_ubound)
+        return;
 
     // Make room for the new value
     const size_t width = bit_width(value);
@@ -543,9 +683,64 @@ void Array::do_ensure_minimum_width(int_fast64_t value)
 
 int64_t Array::sum(size_t start, size_t end) const
 {
+    if (REALM_UNLIKELY(m_offset_encoded)) {
+        if (end == size_t(-1))
+            end = m_size;
+        int64_t s;
+        REALM_TEMPEX(s = sum, m_width, (start, end));
+        return s + m_base * int64_t(end - start);
+    }
     REALM_TEMPEX(return sum, m_width, (start, end));
 }
 
+bool Array::minimum(int64_t& result, size_t start, size_t end, size_t* return_ndx) const
+{
+    return minmax<false>(result, start, end, return_ndx);
+}
+
+bool Array::maximum(int64_t& result, size_t start, size_t end, size_t* return_ndx) const
+{
+    return minmax<true>(result, start, end, return_ndx);
+}
+
+template <bool find_max>
+bool Array::minmax(int64_t& result, size_t start, size_t end, size_t* return_ndx) const
+{
+    if (end == size_t(-1))
+        end = m_size;
+    REALM_ASSERT_EX(end <= m_size && start <= end, start, end, m_size);
+    if (start == end)
+        return false;
+
+    int64_t value;
+    if (m_offset_encoded && start == 0 && end == m_size) {
+        // The bounds of an encoded leaf are its exact smallest and largest value
+        value = find_max ? m_ubound : m_lbound;
+    }
+    else {
+        REALM_TEMPEX2(value = minmax, find_max, m_width, (start, end));
+        if (m_offset_encoded)
+            value += m_base;
+    }
+    result = value;
+    if (return_ndx)
+        *return_ndx = find_first(value, start, end);
+    return true;
+}
+
+template <bool find_max, size_t w>
+int64_t Array::minmax(size_t start, size_t end) const
+{
+    // Nothing but the running extreme is carried from one element to the
+    // next, so the compiler vectorizes this for the byte sized widths
+    int64_t result = get<w>(start);
+    for (size_t i = start + 1; i < end; ++i) {
+        int64_t v = get<w>(i);
+        result = find_max ? std::max(result, v) : std::min(result, v);
+    }
+    return result;
+}
+
 template <size_t w>
 int64_t Array::sum(size_t start, size_t end) const
 {
@@ -711,6 +906,12 @@ int64_t Array::sum(size_t start, size_t end) const
 
 size_t Array::count(int64_t value) const noexcept
 {
+    if (REALM_UNLIKELY(m_offset_encoded)) {
+        if (value < m_lbound || value > m_ubound)
+            return 0;
+        value -= m_base;
+    }
+
     const uint64_t* next = reinterpret_cast<uint64_t*>(m_data);
     size_t value_count = 0;
     const size_t end = m_size;
@@ -877,9 +1078,10 @@ size_t Array::count(int64_t value) const noexcept
         return value_count;
     }
 
-    // Check remaining elements
+    // Check remaining elements. These are compared as stored, as `value` has
+    // been made relative to the base of an offset encoded leaf above.
     for (; i < end; ++i)
-        if (value == get(i))
+        if (value == get_direct(m_data, m_width, i))
             ++value_count;
 
     return value_count;
@@ -1027,6 +1229,16 @@ bool Array::find_vtable(int64_t value, size_t start, size_t end, size_t baseinde
 }
 
 
+// This is the one installed into the m_vtable->finder slots for leaves using
+// the frame-of-reference encoding.
+template <class cond>
+bool Array::find_vtable_offset(int64_t value, size_t start, size_t end, size_t baseindex,
+                               QueryStateBase* state) const
+{
+    return ArrayWithFind(*this).find<cond>(value, start, end, baseindex, state);
+}
+
+
 template <size_t width>
 struct Array::VTableForWidth {
     struct PopulatedVTable : Array::VTable {
@@ -1041,24 +1253,60 @@ struct Array::VTableForWidth {
             finder[cond_Less] = &Array::find_vtable<Less, width>;
         }
     };
+    struct PopulatedOffsetVTable : Array::VTable {
+        PopulatedOffsetVTable()
+        {
+            getter = &Array::get_offset_encoded<width>;
+            // The leaf is always expanded before it is modified
+            setter = nullptr;
+            chunk_getter = &Array::get_chunk_offset_encoded<width>;
+            finder[cond_Equal] = &Array::find_vtable_offset<Equal>;
+            finder[cond_NotEqual] = &Array::find_vtable_offset<NotEqual>;
+            finder[cond_Greater] = &Array::find_vtable_offset<Greater>;
+            finder[cond_Less] = &Array::find_vtable_offset<Less>;
+        }
+    };
     static const PopulatedVTable vtable;
+    static const PopulatedOffsetVTable offset_vtable;
 };
 
 template <size_t width>
 const typename Array::VTableForWidth<width>::PopulatedVTable Array::VTableForWidth<width>::vtable;
 
+template <size_t width>
+const typename Array::VTableForWidth<width>::PopulatedOffsetVTable Array::VTableForWidth<width>::offset_vtable;
+
 void Array::update_width_cache_from_header() noexcept
 {
-    auto width = get_width_from_header(get_header());
-    m_lbound = lbound_for_width(width);
-    m_ubound = ubound_for_width(width);
-
+    const char* header = get_header();
+    auto width = get_width_from_header(header);
     m_width = width;
 
-    REALM_TEMPEX(m_vtable = &VTableForWidth, width, ::vtable);
+    if (REALM_UNLIKELY(get_wtype_from_header(header) == wtype_Offset)) {
+        m_offset_encoded = true;
+        m_base = get_base_from_header(header);
+        m_lbound = m_base;
+        m_ubound = get_max_from_header(header);
+        REALM_TEMPEX(m_vtable = &VTableForWidth, width, ::offset_vtable);
+    }
+    else {
+        m_offset_encoded = false;
+        m_base = 0;
+        m_lbound = lbound_for_width(width);
+        m_ubound = ubound_for_width(width);
+        REALM_TEMPEX(m_vtable = &VTableForWidth, width, ::vtable);
+    }
     m_getter = m_vtable->getter;
 }
 
+template <size_t w>
+void Array::get_chunk_offset_encoded(size_t ndx, int64_t res[8]) const noexcept
+{
+    get_chunk<w>(ndx, res);
+    for (size_t i = 0; i + ndx < m_size && i < 8; i++)
+        res[i] += m_base;
+}
+
 // This method reads 8 concecutive values into res[8], starting from index 'ndx'. It's allowed for the 8 values to
 // exceed array length; in this case, remainder of res[8] will be be set to 0.
 template <size_t w>
@@ -1254,11 +1502,25 @@ void Array::verify() const
 
 size_t Array::lower_bound_int(int64_t value) const noexcept
 {
+    if (REALM_UNLIKELY(m_offset_encoded)) {
+        if (value <= m_lbound)
+            return 0;
+        if (value > m_ubound)
+            return m_size;
+        value -= m_base;
+    }
     REALM_TEMPEX(return lower_bound, m_width, (m_data, m_size, value));
 }
 
 size_t Array::upper_bound_int(int64_t value) const noexcept
 {
+    if (REALM_UNLIKELY(m_offset_encoded)) {
+        if (value < m_lbound)
+            return 0;
+        if (value >= m_ubound)
+            return m_size;
+        value -= m_base;
+    }
     REALM_TEMPEX(return upper_bound, m_width, (m_data, m_size, value));
 }
 
@@ -1273,6 +1535,8 @@ int_fast64_t Array::get(const char* header, size_t ndx) noexcept
 {
     const char* data = get_data_from_header(header);
     uint_least8_t width = get_width_from_header(header);
+    if (REALM_UNLIKELY(get_wtype_from_header(header) == wtype_Offset))
+        return get_base_from_header(header) + get_direct(data, width, ndx);
     return get_direct(data, width, ndx);
 }
 
@@ -1282,6 +1546,10 @@ std::pair<int64_t, int64_t> Array::get_two(const char* header, size_t ndx) noexc
     const char* data = get_data_from_header(header);
     uint_least8_t width = get_width_from_header(header);
     std::pair<int64_t, int64_t> p = ::get_two(data, width, ndx);
+    if (REALM_UNLIKELY(get_wtype_from_header(header) == wtype_Offset)) {
+        int64_t base = get_base_from_header(header);
+        return std::make_pair(base + p.first, base + p.second);
+    }
     return std::make_pair(p.first, p.second);
 }
 
@@ -1297,6 +1565,15 @@ bool QueryStateCount::match(size_t) noexcept
     return (m_limit > m_match_count);
 }
 
+bool QueryStateCount::match_pattern(size_t, uint64_t pattern)
+{
+    size_t count = fast_popcount64(pattern);
+    if (m_limit - m_match_count < count)
+        return false;
+    m_match_count += count;
+    return true;
+}
+
 bool QueryStateFindFirst::match(size_t index, Mixed) noexcept
 {
     m_match_count++;
@@ -1332,6 +1609,22 @@ bool QueryStateFindAll<std::vector<ObjKey>>::match(size_t index) noexcept
     return (m_limit > m_match_count);
 }
 
+template <>
+bool QueryStateFindAll<std::vector<ObjKey>>::match_pattern(size_t index, uint64_t pattern)
+{
+    size_t count = fast_popcount64(pattern);
+    if (m_limit - m_match_count < count)
+        return false;
+    m_match_count += count;
+    while (pattern) {
+        size_t i = index + ctz(size_t(pattern));
+        int64_t key_value = (m_key_values ? m_key_values->get(i) : i) + m_key_offset;
+        m_keys.push_back(ObjKey(key_value));
+        pattern &= pattern - 1;
+    }
+    return true;
+}
+
 template <>
 bool QueryStateFindAll<IntegerColumn>::match(size_t index, Mixed) noexcept
 {
@@ -1349,3 +1642,17 @@ bool QueryStateFindAll<IntegerColumn>::match(size_t index) noexcept
 
     return (m_limit > m_match_count);
 }
+
+template <>
+bool QueryStateFindAll<IntegerColumn>::match_pattern(size_t index, uint64_t pattern)
+{
+    size_t count = fast_popcount64(pattern);
+    if (m_limit - m_match_count < count)
+        return false;
+    m_match_count += count;
+    while (pattern) {
+        m_keys.add(index + ctz(size_t(pattern)));
+        pattern &= pattern - 1;
+    }
+    return true;
+}
@@ -23,6 +23,7 @@
 #include <realm/query_state.hpp>
 #include <realm/column_fwd.hpp>
 #include <realm/array_direct.hpp>
+#include <realm/util/function_ref.hpp>
 
 namespace realm {
 
@@ -71,6 +72,7 @@ public:
     }
     bool match(size_t index, Mixed) noexcept final;
     bool match(size_t index) noexcept final;
+    bool match_pattern(size_t index, uint64_t pattern) final;
 
 private:
     T& m_keys;
@@ -192,6 +194,7 @@ public:
 
     void alloc(size_t init_size, size_t new_width)
     {
+        expand_offset_encoding(); // Throws
         REALM_ASSERT_3(m_width, ==, get_width_from_header(get_header()));
         REALM_ASSERT_3(m_size, ==, get_size_from_header(get_header()));
         Node::alloc(init_size, new_width);
@@ -323,6 +326,12 @@ public:
         return sum(start, end);
     }
 
+    /// Find the smallest (or largest) value among the elements in [start,
+    /// end). Returns false if the range is empty. If `return_ndx` is given, the
+    /// index of the first element holding that value is stored there.
+    bool minimum(int64_t& result, size_t start = 0, size_t end = size_t(-1), size_t* return_ndx = nullptr) const;
+    bool maximum(int64_t& result, size_t start = 0, size_t end = size_t(-1), size_t* return_ndx = nullptr) const;
+
     /// This information is guaranteed to be cached in the array accessor.
     bool is_inner_bptree_node() const noexcept;
 
@@ -379,6 +388,44 @@ public:
     /// cases where you do not already have an array accessor available.
     static ref_type write(ref_type, Allocator&, _impl::ArrayWriterBase&, bool only_if_modified);
 
+    /// Same as write() for a leaf of plain integers, except that the leaf is
+    /// written using the frame-of-reference encoding (wtype_Offset) when that
+    /// makes it smaller. The values are then stored as bit-packed offsets from
+    /// the smallest value in the leaf. Such a leaf is read transparently by all
+    /// accessor functions, and is expanded back to the regular representation
+    /// the first time it is modified. Must only be used for leaves whose values
+    /// are not interpreted as refs.
+    ref_type write_offset_encoded(_impl::ArrayWriterBase& out, bool only_if_modified) const;
+
+    /// Same as non-static write_offset_encoded(). This is for the cases where
+    /// you do not already have an array accessor available.
+    static ref_type write_offset_encoded(ref_type, Allocator&, _impl::ArrayWriterBase&, bool only_if_modified);
+
+    /// Same as the static write() with \a only_if_modified set to true, except
+    /// that every modified child is written by \a write_child, which is passed
+    /// the index and ref of the child, and must return the ref of the written
+    /// copy. This allows the caller to choose how each subtree is written.
+    static ref_type write_with_children(ref_type, Allocator&, _impl::ArrayWriterBase&,
+                                        util::FunctionRef<ref_type(size_t, ref_type)> write_child);
+
+    /// True if this leaf currently uses the frame-of-reference encoding.
+    bool is_offset_encoded() const noexcept
+    {
+        return m_offset_encoded;
+    }
+
+    /// Bounds that all values in this array lie within. These are the exact
+    /// smallest and largest value for a leaf using the frame-of-reference
+    /// encoding, and the range of the current bit width otherwise.
+    int64_t get_lower_bound() const noexcept
+    {
+        return m_lbound;
+    }
+    int64_t get_upper_bound() const noexcept
+    {
+        return m_ubound;
+    }
+
     size_t find_first(int64_t value, size_t begin = 0, size_t end = size_t(-1)) const;
 
     // Wrappers for backwards compatibility and for simple use without
@@ -474,11 +521,25 @@ private:
 
     void do_ensure_minimum_width(int_fast64_t);
 
+    /// Convert a leaf using the frame-of-reference encoding back to the
+    /// regular representation. Must be called before the payload is modified.
+    void expand_offset_encoding()
+    {
+        if (REALM_UNLIKELY(m_offset_encoded))
+            do_expand_offset_encoding(); // Throws
+    }
+    void do_expand_offset_encoding();
+
     int64_t sum(size_t start, size_t end) const;
 
     template <size_t w>
     int64_t sum(size_t start, size_t end) const;
 
+    template <bool find_max>
+    bool minmax(int64_t& result, size_t start, size_t end, size_t* return_ndx) const;
+    template <bool find_max, size_t w>
+    int64_t minmax(size_t start, size_t end) const;
+
 protected:
     /// It is an error to specify a non-zero value unless the width
     /// type is wtype_Bits. It is also an error to specify a non-zero
@@ -509,9 +570,16 @@ protected:
     template <size_t w>
     struct VTableForWidth;
 
+    template <size_t w>
+    int64_t get_offset_encoded(size_t ndx) const noexcept;
+    template <size_t w>
+    void get_chunk_offset_encoded(size_t ndx, int64_t res[8]) const noexcept;
+
     // This is the one installed into the m_vtable->finder slots.
     template <class cond, size_t bitwidth>
     bool find_vtable(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
+    template <class cond>
+    bool find_vtable_offset(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
 
     template <size_t w>
     int64_t get_universal(const char* const data, const size_t ndx) const;
@@ -526,13 +594,15 @@ protected:
     Getter m_getter = nullptr; // cached to avoid indirection
     const VTable* m_vtable = nullptr;
 
-    int64_t m_lbound;          // min number that can be stored with current m_width
-    int64_t m_ubound;          // max number that can be stored with current m_width
+    int64_t m_lbound;          // min number that can be stored with current m_width (min value if encoded)
+    int64_t m_ubound;          // max number that can be stored with current m_width (max value if encoded)
+    int64_t m_base = 0;        // value that all offsets are relative to (wtype_Offset only)
 
     uint8_t m_width = 0;         // Size of an element (meaning depend on type of array).
     bool m_is_inner_bptree_node; // This array is an inner node of B+-tree.
     bool m_has_refs;             // Elements whose first bit is zero are refs to subarrays.
     bool m_context_flag;         // Meaning depends on context.
+    bool m_offset_encoded = false; // Payload holds offsets from m_base (wtype_Offset)
 
 private:
     ref_type do_write_shallow(_impl::ArrayWriterBase&) const;
@@ -808,6 +878,7 @@ inline bool Array::get_context_flag() const noexcept
 inline void Array::set_context_flag(bool value) noexcept
 {
     if (m_context_flag != value) {
+        expand_offset_encoding();
         copy_on_write();
         m_context_flag = value;
         set_context_flag_in_header(value, get_header());
@@ -978,11 +1049,17 @@ inline ref_type Array::get_child_ref(size_t child_ndx) const noexcept
 
 inline void Array::ensure_minimum_width(int_fast64_t value)
 {
-    if (value >= m_lbound && value <= m_ubound)
+    if (value >= m_lbound && value <= m_ubound && !m_offset_encoded)
         return;
     do_ensure_minimum_width(value);
 }
 
+template <size_t w>
+inline int64_t Array::get_offset_encoded(size_t ndx) const noexcept
+{
+    return m_base + get_universal<w>(m_data, ndx);
+}
+
 
 } // namespace realm
 
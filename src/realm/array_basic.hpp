@@ -84,6 +84,15 @@ public:
 
     size_t find_first(T value, size_t begin = 0, size_t end = npos) const;
 
+    /// Sum of the values in [begin, end) that are neither null nor NaN. The
+    /// number of them is stored in `count`.
+    double sum(size_t begin, size_t end, size_t& count) const;
+    /// Find the smallest (or largest) value in [begin, end) that is neither
+    /// null nor NaN. Returns false if there is none. If `return_ndx` is given,
+    /// the index of the first element holding that value is stored there.
+    bool minimum(T& result, size_t begin, size_t end, size_t* return_ndx = nullptr) const;
+    bool maximum(T& result, size_t begin, size_t end, size_t* return_ndx = nullptr) const;
+
     /// Get the specified element without the cost of constructing an
     /// array instance. If an array instance is already available, or
     /// you need to get multiple values, then this method will be
@@ -118,6 +127,9 @@ private:
     /// of the header. The result will be upwards aligned to the
     /// closest 8-byte boundary.
     static size_t calc_aligned_byte_size(size_t size);
+
+    template <bool find_max>
+    bool minmax(T& result, size_t begin, size_t end, size_t* return_ndx) const;
 };
 
 template <class T>
@@ -20,6 +20,7 @@
 #define REALM_ARRAY_BASIC_TPL_HPP
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include <realm/array_basic.hpp>
@@ -200,6 +201,77 @@ inline size_t BasicArray<T>::find_first(T value, size_t begin, size_t end) const
     return i == data + end ? not_found : size_t(i - data);
 }
 
+template <class T>
+double BasicArray<T>::sum(size_t begin, size_t end, size_t& count) const
+{
+    REALM_ASSERT(begin <= end && end <= m_size);
+    const T* data = reinterpret_cast<const T*>(m_data);
+
+    // Floating point additions cannot be reordered by the compiler, so the
+    // values are spread over independent partial sums which it can keep in
+    // the lanes of a vector register. Null is a NaN, so both are skipped by
+    // testing the value against itself.
+    constexpr size_t lanes = 4;
+    double sums[lanes] = {};
+    size_t counts[lanes] = {};
+    size_t i = begin;
+    for (; i + lanes <= end; i += lanes) {
+        for (size_t j = 0; j < lanes; ++j) {
+            T v = data[i + j];
+            bool valid = !std::isnan(v);
+            sums[j] += valid ? double(v) : 0.0;
+            counts[j] += valid;
+        }
+    }
+    for (; i < end; ++i) {
+        T v = data[i];
+        if (!std::isnan(v)) {
+            sums[0] += v;
+            ++counts[0];
+        }
+    }
+    count = (counts[0] + counts[1]) + (counts[2] + counts[3]);
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+template <class T>
+bool BasicArray<T>::minimum(T& result, size_t begin, size_t end, size_t* return_ndx) const
+{
+    return minmax<false>(result, begin, end, return_ndx);
+}
+
+template <class T>
+bool BasicArray<T>::maximum(T& result, size_t begin, size_t end, size_t* return_ndx) const
+{
+    return minmax<true>(result, begin, end, return_ndx);
+}
+
+template <class T>
+template <bool find_max>
+bool BasicArray<T>::minmax(T& result, size_t begin, size_t end, size_t* return_ndx) const
+{
+    REALM_ASSERT(begin <= end && end <= m_size);
+    const T* data = reinterpret_cast<const T*>(m_data);
+
+    size_t first = begin;
+    while (first < end && std::isnan(data[first]))
+        ++first;
+    if (first == end)
+        return false;
+
+    // Any comparison with NaN (and so null) is false, so those never replace
+    // the current extreme
+    T best = data[first];
+    for (size_t i = first + 1; i < end; ++i) {
+        T v = data[i];
+        best = (find_max ? v > best : v < best) ? v : best;
+    }
+    result = best;
+    if (return_ndx)
+        *return_ndx = size_t(std::find(data + first, data + end, best) - data);
+    return true;
+}
+
 template <class T>
 size_t BasicArrayNull<T>::find_first_null(size_t begin, size_t end) const
 {
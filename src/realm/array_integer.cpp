@@ -202,6 +202,60 @@ size_t ArrayIntNull::find_first_in_range(int64_t from, int64_t to, size_t start,
     return realm::not_found;
 }
 
+int64_t ArrayIntNull::sum(size_t start, size_t end, size_t& count) const
+{
+    // Most leaves hold few nulls, so the runs of values between them are each
+    // summed in one go. Element i is stored at index i + 1.
+    int64_t null = null_value();
+    uint64_t s = 0;
+    count = 0;
+    for (size_t i = start + 1; i <= end;) {
+        size_t next_null = Array::find_first(null, i, end + 1);
+        if (next_null == not_found)
+            next_null = end + 1;
+        s += uint64_t(get_sum(i, next_null));
+        count += next_null - i;
+        i = next_null + 1;
+    }
+    return int64_t(s);
+}
+
+bool ArrayIntNull::minimum(int64_t& result, size_t start, size_t end, size_t* return_ndx) const
+{
+    return minmax<false>(result, start, end, return_ndx);
+}
+
+bool ArrayIntNull::maximum(int64_t& result, size_t start, size_t end, size_t* return_ndx) const
+{
+    return minmax<true>(result, start, end, return_ndx);
+}
+
+template <bool find_max>
+bool ArrayIntNull::minmax(int64_t& result, size_t start, size_t end, size_t* return_ndx) const
+{
+    QueryStateFindFirst first_null;
+    find<Equal>(util::none, start, end, &first_null);
+    if (first_null.m_state == realm::not_found) {
+        bool found = find_max ? Array::maximum(result, start + 1, end + 1, return_ndx)
+                              : Array::minimum(result, start + 1, end + 1, return_ndx);
+        if (found && return_ndx)
+            --*return_ndx;
+        return found;
+    }
+
+    bool found = false;
+    for (size_t i = start; i < end; ++i) {
+        auto val = get(i);
+        if (val && (!found || (find_max ? *val > result : *val < result))) {
+            result = *val;
+            found = true;
+            if (return_ndx)
+                *return_ndx = i;
+        }
+    }
+    return found;
+}
+
 void ArrayIntNull::get_chunk(size_t ndx, value_type res[8]) const noexcept
 {
     // FIXME: Optimize this
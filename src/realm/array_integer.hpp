@@ -72,6 +72,14 @@ public:
     bool find(value_type value, size_t start, size_t end, QueryStateBase* state) const;
 
     size_t find_first_in_range(int64_t from, int64_t to, size_t start, size_t end) const;
+
+    /// Sum of the values in [start, end), with the same signature as for the
+    /// leaves that may hold nulls.
+    int64_t sum(size_t start, size_t end, size_t& count) const
+    {
+        count = end - start;
+        return get_sum(start, end);
+    }
 };
 
 class ArrayIntNull : public Array, public ArrayPayload {
@@ -142,6 +150,13 @@ public:
     size_t find_first(value_type value, size_t begin = 0, size_t end = npos) const;
     size_t find_first_in_range(int64_t from, int64_t to, size_t start, size_t end) const;
 
+    /// Sum of the non-null values in [start, end). The number of them is
+    /// stored in `count`.
+    int64_t sum(size_t start, size_t end, size_t& count) const;
+    /// As Array::minimum() and Array::maximum(), but nulls are skipped.
+    bool minimum(int64_t& result, size_t start, size_t end, size_t* return_ndx = nullptr) const;
+    bool maximum(int64_t& result, size_t start, size_t end, size_t* return_ndx = nullptr) const;
+
 protected:
     void avoid_null_collision(int64_t value);
 
@@ -153,6 +168,8 @@ private:
     bool find_impl(int cond, value_type value, size_t start, size_t end, QueryStateBase* state) const;
     template <class cond>
     bool find_impl(value_type value, size_t start, size_t end, QueryStateBase* state) const;
+    template <bool find_max>
+    bool minmax(int64_t& result, size_t start, size_t end, size_t* return_ndx) const;
 };
 
 
@@ -18,6 +18,10 @@
 
 #include <realm/array_with_find.hpp>
 
+#ifdef REALM_COMPILER_AVX
+#include <immintrin.h>
+#endif
+
 namespace realm {
 
 void ArrayWithFind::find_all(IntegerColumn* result, int64_t value, size_t col_offset, size_t begin, size_t end) const
@@ -80,4 +84,148 @@ size_t ArrayWithFind::first_set_bit64(int64_t v) const
 }
 
 
+#ifdef REALM_COMPILER_AVX
+
+// The vectorized kernels are compiled for the respective instruction set
+// extensions regardless of the target of the rest of the library, and are only
+// called after the runtime check in sseavx().
+#if defined(__GNUC__) || defined(__clang__)
+#define REALM_TARGET_AVX2 __attribute__((target("avx2")))
+#define REALM_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define REALM_TARGET_AVX2
+#define REALM_TARGET_AVX512
+#endif
+
+namespace {
+
+template <class cond, size_t width>
+REALM_TARGET_AVX2 inline __m256i compare_avx2(__m256i data, __m256i search) noexcept
+{
+    constexpr bool eq = std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual>;
+    constexpr bool gt = std::is_same_v<cond, Greater>;
+    // For Less the operands are swapped: data < search <=> search > data
+    __m256i a = gt || eq ? data : search;
+    __m256i b = gt || eq ? search : data;
+    if constexpr (width == 8)
+        return eq ? _mm256_cmpeq_epi8(a, b) : _mm256_cmpgt_epi8(a, b);
+    else if constexpr (width == 16)
+        return eq ? _mm256_cmpeq_epi16(a, b) : _mm256_cmpgt_epi16(a, b);
+    else if constexpr (width == 32)
+        return eq ? _mm256_cmpeq_epi32(a, b) : _mm256_cmpgt_epi32(a, b);
+    else
+        return eq ? _mm256_cmpeq_epi64(a, b) : _mm256_cmpgt_epi64(a, b);
+}
+
+template <size_t width>
+REALM_TARGET_AVX2 inline __m256i broadcast_avx2(int64_t value) noexcept
+{
+    if constexpr (width == 8)
+        return _mm256_set1_epi8(static_cast<char>(value));
+    else if constexpr (width == 16)
+        return _mm256_set1_epi16(static_cast<short>(value));
+    else if constexpr (width == 32)
+        return _mm256_set1_epi32(static_cast<int>(value));
+    else
+        return _mm256_set1_epi64x(value);
+}
+
+} // anonymous namespace
+
+template <class cond, size_t width>
+REALM_TARGET_AVX2 uint64_t ArrayWithFind::match_mask_avx2(const char* data, int64_t value) noexcept
+{
+    static_assert(width == 8 || width == 16 || width == 32 || width == 64);
+    const __m256i search = broadcast_avx2<width>(value);
+    const __m256i* p = reinterpret_cast<const __m256i*>(data);
+    uint64_t mask = 0;
+
+    if constexpr (width == 8) {
+        // 32 elements per vector
+        for (size_t i = 0; i < 2; ++i) {
+            __m256i r = compare_avx2<cond, width>(_mm256_loadu_si256(p + i), search);
+            mask |= uint64_t(uint32_t(_mm256_movemask_epi8(r))) << (i * 32);
+        }
+    }
+    else if constexpr (width == 16) {
+        // Pack the 16-bit results of two vectors into one vector of 8-bit
+        // results. The packing works per 128-bit lane, so the 64-bit quarters
+        // have to be put back in order afterwards.
+        for (size_t i = 0; i < 2; ++i) {
+            __m256i r0 = compare_avx2<cond, width>(_mm256_loadu_si256(p + 2 * i), search);
+            __m256i r1 = compare_avx2<cond, width>(_mm256_loadu_si256(p + 2 * i + 1), search);
+            __m256i r = _mm256_permute4x64_epi64(_mm256_packs_epi16(r0, r1), 0xd8);
+            mask |= uint64_t(uint32_t(_mm256_movemask_epi8(r))) << (i * 32);
+        }
+    }
+    else if constexpr (width == 32) {
+        // 8 elements per vector
+        for (size_t i = 0; i < 8; ++i) {
+            __m256i r = compare_avx2<cond, width>(_mm256_loadu_si256(p + i), search);
+            mask |= uint64_t(uint32_t(_mm256_movemask_ps(_mm256_castsi256_ps(r)))) << (i * 8);
+        }
+    }
+    else {
+        // 4 elements per vector
+        for (size_t i = 0; i < 16; ++i) {
+            __m256i r = compare_avx2<cond, width>(_mm256_loadu_si256(p + i), search);
+            mask |= uint64_t(uint32_t(_mm256_movemask_pd(_mm256_castsi256_pd(r)))) << (i * 4);
+        }
+    }
+
+    return std::is_same_v<cond, NotEqual> ? ~mask : mask;
+}
+
+template <class cond, size_t width>
+REALM_TARGET_AVX512 uint64_t ArrayWithFind::match_mask_avx512(const char* data, int64_t value) noexcept
+{
+    static_assert(width == 8 || width == 16 || width == 32 || width == 64);
+    constexpr int op = std::is_same_v<cond, Equal>      ? _MM_CMPINT_EQ
+                       : std::is_same_v<cond, NotEqual> ? _MM_CMPINT_NE
+                       : std::is_same_v<cond, Greater>  ? _MM_CMPINT_NLE
+                                                        : _MM_CMPINT_LT;
+    uint64_t mask = 0;
+
+    if constexpr (width == 8) {
+        __m512i search = _mm512_set1_epi8(static_cast<char>(value));
+        mask = _mm512_cmp_epi8_mask(_mm512_loadu_si512(data), search, op);
+    }
+    else if constexpr (width == 16) {
+        __m512i search = _mm512_set1_epi16(static_cast<short>(value));
+        for (size_t i = 0; i < 2; ++i)
+            mask |= uint64_t(_mm512_cmp_epi16_mask(_mm512_loadu_si512(data + i * 64), search, op)) << (i * 32);
+    }
+    else if constexpr (width == 32) {
+        __m512i search = _mm512_set1_epi32(static_cast<int>(value));
+        for (size_t i = 0; i < 4; ++i)
+            mask |= uint64_t(_mm512_cmp_epi32_mask(_mm512_loadu_si512(data + i * 64), search, op)) << (i * 16);
+    }
+    else {
+        __m512i search = _mm512_set1_epi64(value);
+        for (size_t i = 0; i < 8; ++i)
+            mask |= uint64_t(_mm512_cmp_epi64_mask(_mm512_loadu_si512(data + i * 64), search, op)) << (i * 8);
+    }
+
+    return mask;
+}
+
+#define REALM_INSTANTIATE_MATCH_MASK(cond)                                                                           \
+    template uint64_t ArrayWithFind::match_mask_avx2<cond, 8>(const char*, int64_t) noexcept;                       \
+    template uint64_t ArrayWithFind::match_mask_avx2<cond, 16>(const char*, int64_t) noexcept;                      \
+    template uint64_t ArrayWithFind::match_mask_avx2<cond, 32>(const char*, int64_t) noexcept;                      \
+    template uint64_t ArrayWithFind::match_mask_avx2<cond, 64>(const char*, int64_t) noexcept;                      \
+    template uint64_t ArrayWithFind::match_mask_avx512<cond, 8>(const char*, int64_t) noexcept;                     \
+    template uint64_t ArrayWithFind::match_mask_avx512<cond, 16>(const char*, int64_t) noexcept;                    \
+    template uint64_t ArrayWithFind::match_mask_avx512<cond, 32>(const char*, int64_t) noexcept;                    \
+    template uint64_t ArrayWithFind::match_mask_avx512<cond, 64>(const char*, int64_t) noexcept;
+
+REALM_INSTANTIATE_MATCH_MASK(Equal)
+REALM_INSTANTIATE_MATCH_MASK(NotEqual)
+REALM_INSTANTIATE_MATCH_MASK(Greater)
+REALM_INSTANTIATE_MATCH_MASK(Less)
+
+#undef REALM_INSTANTIATE_MATCH_MASK
+
+#endif // REALM_COMPILER_AVX
+
 } // namespace realm
@@ -33,6 +33,9 @@ Searching: The main finding function is:
 
 #include <realm/array.hpp>
 #include <realm/query_conditions.hpp>
+#include <realm/util/safe_int_ops.hpp>
+
+#include <limits>
 
 /*
     MMX: mmintrin.h
@@ -94,6 +97,12 @@ public:
     template <class cond>
     bool find(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
 
+    // Find for leaves using the frame-of-reference encoding. The value is
+    // translated into an offset and the regular finders are run on the offsets.
+    template <class cond>
+    bool find_offset_encoded(int64_t value, size_t start, size_t end, size_t baseindex,
+                             QueryStateBase* state) const;
+
     void find_all(IntegerColumn* result, int64_t value, size_t col_offset = 0, size_t begin = 0,
                   size_t end = size_t(-1)) const;
 
@@ -131,6 +140,23 @@ public:
 
 #endif
 
+// AVX2/AVX-512 find for the four functions Equal/NotEqual/Less/Greater. Compares
+// blocks of 64 elements at a time and hands the resulting bitmask to the query
+// state, falling back to calling match() for each bit.
+#ifdef REALM_COMPILER_AVX
+    template <class cond, size_t width>
+    bool find_avx(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
+
+    // Bitmask of the elements among the 64 at 'data' matching 'value'. Only
+    // instantiated for byte aligned widths, and only to be called when
+    // sseavx<2>() or sseavx<512>() respectively is true.
+    template <class cond, size_t width>
+    static uint64_t match_mask_avx2(const char* data, int64_t value) noexcept;
+
+    template <class cond, size_t width>
+    static uint64_t match_mask_avx512(const char* data, int64_t value) noexcept;
+#endif
+
     template <size_t width>
     inline bool test_zero(uint64_t value) const; // Tests value for 0-elements
 
@@ -159,6 +185,8 @@ public:
     bool find_optimized(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const;
 
 private:
+    class OffsetQueryState;
+
     const Array& m_array;
 
     template <size_t bitwidth>
@@ -281,6 +309,15 @@ REALM_NOINLINE bool ArrayWithFind::find_all_will_match(size_t start2, size_t end
                                                        QueryStateBase* state) const
 {
     REALM_ASSERT_DEBUG(state->match_count() < state->limit());
+    if (state->match_range(start2 + baseindex, end + baseindex))
+        return true;
+    // States that can take whole blocks of matches are handed them without
+    // looking at the individual elements
+    while (end - start2 >= 64 && state->match_pattern(start2 + baseindex, ~uint64_t(0))) {
+        if (state->match_count() >= state->limit())
+            return false;
+        start2 += 64;
+    }
     size_t process = state->limit() - state->match_count();
     size_t end2 = end - start2 > process ? start2 + process : end;
     for (; start2 < end2; start2++)
@@ -324,6 +361,14 @@ bool ArrayWithFind::find_optimized(int64_t value, size_t start, size_t end, size
     // finder cannot handle this bitwidth
     REALM_ASSERT_3(m_array.m_width, !=, 0);
 
+#if defined(REALM_COMPILER_AVX)
+    if constexpr (bitwidth >= 8 && (std::is_same_v<cond, Equal> || std::is_same_v<cond, NotEqual> ||
+                                    std::is_same_v<cond, Greater> || std::is_same_v<cond, Less>)) {
+        if (end - start2 >= 64 && sseavx<2>())
+            return find_avx<cond, bitwidth>(value, start2, end, baseindex, state);
+    }
+#endif
+
 #if defined(REALM_COMPILER_SSE)
     // Only use SSE if payload is at least one SSE chunk (128 bits) in size. Also note taht SSE doesn't support
     // Less-than comparison for 64-bit values.
@@ -373,6 +418,36 @@ bool ArrayWithFind::find_optimized(int64_t value, size_t start, size_t end, size
 #endif
 }
 
+#ifdef REALM_COMPILER_AVX
+template <class cond, size_t width>
+bool ArrayWithFind::find_avx(int64_t value, size_t start, size_t end, size_t baseindex,
+                             QueryStateBase* state) const
+{
+    const bool avx512 = sseavx<512>();
+    while (end - start >= 64) {
+        const char* data = m_array.m_data + start * width / 8;
+        uint64_t mask =
+            avx512 ? match_mask_avx512<cond, width>(data, value) : match_mask_avx2<cond, width>(data, value);
+        if (mask) {
+            if (state->match_pattern(start + baseindex, mask)) {
+                if (state->match_count() >= state->limit())
+                    return false;
+            }
+            else {
+                do {
+                    if (!state->match(start + ctz(size_t(mask)) + baseindex))
+                        return false;
+                    mask &= mask - 1;
+                } while (mask);
+            }
+        }
+        start += 64;
+    }
+
+    return compare<cond, width>(value, start, end, baseindex, state);
+}
+#endif
+
 // Tests if any chunk in 'value' is 0
 template <size_t width>
 inline bool ArrayWithFind::test_zero(uint64_t value) const
@@ -641,9 +716,76 @@ inline bool ArrayWithFind::compare_equality(int64_t value, size_t start, size_t
 template <class cond>
 bool ArrayWithFind::find(int64_t value, size_t start, size_t end, size_t baseindex, QueryStateBase* state) const
 {
+    if (REALM_UNLIKELY(m_array.m_offset_encoded))
+        return find_offset_encoded<cond>(value, start, end, baseindex, state);
     REALM_TEMPEX2(return find_optimized, cond, m_array.m_width, (value, start, end, baseindex, state));
 }
 
+// Passes the matches found among the offsets on to the actual query state,
+// adding the base back onto the reported values.
+class ArrayWithFind::OffsetQueryState : public QueryStateBase {
+public:
+    OffsetQueryState(QueryStateBase* state, int64_t base) noexcept
+        : QueryStateBase(state->limit())
+        , m_state(state)
+        , m_base(base)
+    {
+        m_match_count = state->match_count();
+    }
+
+    bool match(size_t index, Mixed value) noexcept override
+    {
+        if (value.is_type(type_Int))
+            value = Mixed(m_base + value.get_int());
+        bool cont = m_state->match(index, value);
+        m_match_count = m_state->match_count();
+        return cont;
+    }
+
+    bool match(size_t index) noexcept override
+    {
+        bool cont = m_state->match(index);
+        m_match_count = m_state->match_count();
+        return cont;
+    }
+
+    bool match_pattern(size_t index, uint64_t pattern) override
+    {
+        bool consumed = m_state->match_pattern(index, pattern);
+        m_match_count = m_state->match_count();
+        return consumed;
+    }
+
+private:
+    QueryStateBase* m_state;
+    int64_t m_base;
+};
+
+template <class cond>
+bool ArrayWithFind::find_offset_encoded(int64_t value, size_t start, size_t end, size_t baseindex,
+                                        QueryStateBase* state) const
+{
+    // The leaf stores its smallest and largest value, which often rules out
+    // (or guarantees) a match for all of its elements
+    cond c;
+    if (!c.can_match(value, m_array.m_lbound, m_array.m_ubound))
+        return true;
+    if (c.will_match(value, m_array.m_lbound, m_array.m_ubound)) {
+        if (end == npos)
+            end = m_array.m_size;
+        return find_all_will_match<0>(start, end, baseindex, state);
+    }
+
+    // All offsets are non-negative, so a value that cannot be expressed as an
+    // offset can be clamped without changing the result of the comparison.
+    int64_t offset = value;
+    if (util::int_subtract_with_overflow_detect(offset, m_array.m_base))
+        offset = value < m_array.m_base ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+
+    OffsetQueryState offset_state(state, m_array.m_base);
+    REALM_TEMPEX2(return find_optimized, cond, m_array.m_width, (offset, start, end, baseindex, &offset_state));
+}
+
 #ifdef REALM_COMPILER_SSE
 // 'items' is the number of 16-byte SSE chunks. Returns index of packed element relative to first integer of first
 // chunk
@@ -747,6 +889,16 @@ bool ArrayWithFind::compare_leafs(const Array* foreign, size_t start, size_t end
     if (start == end)
         return true;
 
+    if (REALM_UNLIKELY(m_array.m_offset_encoded || foreign->m_offset_encoded)) {
+        for (; start < end; ++start) {
+            int64_t v = m_array.get(start);
+            if (c(v, foreign->get(start))) {
+                if (!state->match(start + baseindex, v))
+                    return false;
+            }
+        }
+        return true;
+    }
 
     int64_t v;
 
@@ -71,7 +71,7 @@ public:
         return m_sub_tree_depth;
     }
 
-    bool traverse(ClusterTree::TraverseFunction func, int64_t) const;
+    bool traverse(ClusterTree::TraverseFunction func, int64_t, bool prefetch) const;
     void update(ClusterTree::UpdateFunction func, int64_t);
 
     size_t node_size() const override
@@ -121,6 +121,8 @@ public:
     void dump_objects(int64_t key_offset, std::string lead) const override;
 
 private:
+    friend class ClusterTree;
+
     static constexpr size_t s_key_ref_index = 0;
     static constexpr size_t s_sub_tree_depth_index = 1;
     static constexpr size_t s_sub_tree_size = 2;
@@ -680,7 +682,29 @@ size_t ClusterNodeInner::update_sub_tree_size()
     return sub_tree_size;
 }
 
-bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset) const
+namespace {
+
+// Amount of data prefetched from the start of each column leaf of a cluster
+constexpr size_t s_prefetch_leaf_size = 0x4000;
+
+// Ask for the column leaves of the cluster at 'ref' to be paged in. Only the
+// top array of the cluster is touched here.
+void prefetch_cluster_leaves(const Allocator& alloc, ref_type ref) noexcept
+{
+    const char* header = alloc.translate(ref);
+    if (Array::get_is_inner_bptree_node_from_header(header))
+        return;
+    size_t sz = NodeHeader::get_size_from_header(header);
+    for (size_t i = 0; i < sz; i++) {
+        RefOrTagged rot = Array::get_as_ref_or_tagged(header, i);
+        if (rot.is_ref() && rot.get_as_ref())
+            alloc.prefetch(rot.get_as_ref(), s_prefetch_leaf_size);
+    }
+}
+
+} // anonymous namespace
+
+bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_offset, bool prefetch) const
 {
     auto sz = node_size();
 
@@ -688,6 +712,14 @@ bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_
         ref_type ref = _get_child_ref(i);
         char* header = m_alloc.translate(ref);
         bool child_is_leaf = !Array::get_is_inner_bptree_node_from_header(header);
+        if (prefetch && child_is_leaf) {
+            // Let the OS page in the cluster after the next one while the
+            // leaves of the next one are requested and this one is processed
+            if (i + 2 < sz)
+                m_alloc.prefetch(_get_child_ref(i + 2), util::page_size());
+            if (i + 1 < sz)
+                prefetch_cluster_leaves(m_alloc, _get_child_ref(i + 1));
+        }
         MemRef mem(header, ref, m_alloc);
         int64_t offs = (m_keys.is_attached() ? m_keys.get(i) : i << m_shift_factor) + key_offset;
         if (child_is_leaf) {
@@ -700,7 +732,7 @@ bool ClusterNodeInner::traverse(ClusterTree::TraverseFunction func, int64_t key_
         else {
             ClusterNodeInner node(m_alloc, m_tree_top);
             node.init(mem);
-            if (node.traverse(func, offs)) {
+            if (node.traverse(func, offs, prefetch)) {
                 return true;
             }
         }
@@ -1031,13 +1063,55 @@ bool ClusterTree::get_leaf(ObjKey key, ClusterNode::IteratorState& state) const
 }
 
 bool ClusterTree::traverse(TraverseFunction func) const
+{
+    return traverse(func, m_alloc.get_prefetch_clusters());
+}
+
+bool ClusterTree::traverse(TraverseFunction func, bool prefetch) const
 {
     if (m_root->is_leaf()) {
         return func(static_cast<Cluster*>(m_root.get())) == IteratorControl::Stop;
     }
     else {
-        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0);
+        return static_cast<ClusterNodeInner*>(m_root.get())->traverse(func, 0, prefetch);
+    }
+}
+
+std::vector<ClusterTree::Subtree> ClusterTree::split(size_t min_parts) const
+{
+    std::vector<Subtree> parts{{m_root->get_ref(), 0}};
+    while (parts.size() < min_parts) {
+        // The tree is balanced, so either all the parts are leaves or none of them are
+        if (!Array::get_is_inner_bptree_node_from_header(m_alloc.translate(parts[0].ref)))
+            break;
+
+        std::vector<Subtree> children;
+        for (auto& part : parts) {
+            ClusterNodeInner node(m_alloc, *this);
+            node.init(MemRef(m_alloc.translate(part.ref), part.ref, m_alloc));
+            auto sz = node.node_size();
+            for (unsigned i = 0; i < sz; i++) {
+                int64_t offs = (node.m_keys.is_attached() ? node.m_keys.get(i) : i << node.m_shift_factor);
+                children.push_back({node._get_child_ref(i), offs + part.key_offset});
+            }
+        }
+        parts = std::move(children);
+    }
+    return parts;
+}
+
+bool ClusterTree::traverse(const Subtree& subtree, TraverseFunction func, bool prefetch) const
+{
+    char* header = m_alloc.translate(subtree.ref);
+    MemRef mem(header, subtree.ref, m_alloc);
+    if (!Array::get_is_inner_bptree_node_from_header(header)) {
+        Cluster leaf(subtree.key_offset, m_alloc, *this);
+        leaf.init(mem);
+        return func(&leaf) == IteratorControl::Stop;
     }
+    ClusterNodeInner node(m_alloc, *this);
+    node.init(mem);
+    return node.traverse(func, subtree.key_offset, prefetch);
 }
 
 void ClusterTree::update(UpdateFunction func)
@@ -1083,6 +1157,28 @@ void ClusterTree::verify() const
 #endif
 }
 
+ref_type ClusterTree::typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc) const
+{
+    bool only_if_modified = true;
+    if (Array::get_is_inner_bptree_node_from_header(alloc.translate(ref))) {
+        return Array::write_with_children(ref, alloc, out, [&](size_t ndx, ref_type child_ref) {
+            if (ndx < ClusterNodeInner::s_first_node_index)
+                return Array::write(child_ref, alloc, out, only_if_modified); // Throws
+            return typed_write(child_ref, out, alloc);                      // Throws
+        });
+    }
+
+    return Array::write_with_children(ref, alloc, out, [&](size_t ndx, ref_type child_ref) {
+        if (ndx >= Cluster::s_first_col_index) {
+            ColKey col_key = m_owner->leaf_ndx2colkey(ColKey::Idx{unsigned(ndx - Cluster::s_first_col_index)});
+            if (col_key && col_key.get_type() == col_type_Int && !col_key.is_nullable() &&
+                !col_key.is_collection())
+                return Array::write_offset_encoded(child_ref, alloc, out, only_if_modified); // Throws
+        }
+        return Array::write(child_ref, alloc, out, only_if_modified); // Throws
+    });
+}
+
 void ClusterTree::nullify_incoming_links(ObjKey obj_key, CascadeState& state)
 {
     REALM_ASSERT(state.m_group);
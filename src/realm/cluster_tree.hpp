@@ -177,6 +177,21 @@ public:
     // Visit all leaves and call the supplied function. Stop when function returns IteratorControl::Stop.
     // Not allowed to modify the tree
     bool traverse(TraverseFunction func) const;
+    // As above, but explicitly enable or disable prefetching of the clusters ahead
+    bool traverse(TraverseFunction func, bool prefetch) const;
+
+    // A subtree holding a run of consecutive clusters
+    struct Subtree {
+        ref_type ref;
+        int64_t key_offset;
+    };
+    // Split the tree into subtrees which together hold all the clusters in key order. The
+    // tree is split at the first level having at least 'min_parts' nodes, or into the leaves
+    // if there are fewer clusters than that.
+    std::vector<Subtree> split(size_t min_parts) const;
+    // Visit all leaves of one of the subtrees returned by split(). The subtrees of a tree may
+    // be traversed concurrently.
+    bool traverse(const Subtree& subtree, TraverseFunction func, bool prefetch) const;
     // Visit all leaves and call the supplied function. The function can modify the leaf.
     void update(UpdateFunction func);
 
@@ -190,6 +205,12 @@ public:
     }
     void verify() const;
 
+    /// Write the modified parts of the cluster tree rooted at \a ref. Integer
+    /// columns are written using the frame-of-reference encoding where that
+    /// makes the leaves smaller. All other arrays are written as by
+    /// Array::write().
+    ref_type typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc) const;
+
 protected:
     friend class Obj;
     friend class Cluster;
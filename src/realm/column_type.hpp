@@ -133,7 +133,7 @@ static_assert(!col_type_OldStringEnum.is_valid());
 static_assert(!col_type_OldTable.is_valid());
 static_assert(!col_type_OldDateTime.is_valid());
 
-enum class IndexType { None, General, Fulltext };
+enum class IndexType { None, General, Fulltext, Sorted };
 
 inline std::ostream& operator<<(std::ostream& ostr, IndexType type)
 {
@@ -147,6 +147,9 @@ inline std::ostream& operator<<(std::ostream& ostr, IndexType type)
         case IndexType::Fulltext:
             ostr << "fulltext index";
             break;
+        case IndexType::Sorted:
+            ostr << "sorted index";
+            break;
     }
     return ostr;
 }
@@ -182,6 +185,9 @@ enum ColumnAttr {
     /// Specifies that elements in the column are full-text indexed
     col_attr_FullText_Indexed = 256,
 
+    /// Specifies that the column has a sorted index
+    col_attr_Sorted_Indexed = 512,
+
     /// Either list, dictionary, or set
     col_attr_Collection = 128 + 64 + 32
 };
@@ -35,6 +35,7 @@
 #include <realm/disable_sync_to_disk.hpp>
 #include <realm/group_writer.hpp>
 #include <realm/impl/simulated_failure.hpp>
+#include <realm/query_cache.hpp>
 #include <realm/replication.hpp>
 #include <realm/util/errno.hpp>
 #include <realm/util/features.h>
@@ -306,6 +307,19 @@ TransactionRef make_transaction_ref(Args&&... args)
     return TransactionRef(new Transaction(std::forward<Args>(args)...), TransactionDeleter);
 }
 
+util::HugePages to_huge_pages(DBOptions::HugePages huge_pages) noexcept
+{
+    switch (huge_pages) {
+        case DBOptions::HugePages::Off:
+            break;
+        case DBOptions::HugePages::Transparent:
+            return util::HugePages::transparent;
+        case DBOptions::HugePages::Explicit:
+            return util::HugePages::hugetlb;
+    }
+    return util::HugePages::off;
+}
+
 } // anonymous namespace
 
 namespace realm {
@@ -919,6 +933,20 @@ void DB::open(const std::string& path, const DBOptions& options)
     SlabAlloc& alloc = m_alloc;
     ref_type top_ref = 0;
 
+    switch (options.read_ahead) {
+        case DBOptions::ReadAhead::Default:
+            alloc.set_read_ahead(util::AccessPattern::normal);
+            break;
+        case DBOptions::ReadAhead::Sequential:
+            alloc.set_read_ahead(util::AccessPattern::sequential);
+            break;
+        case DBOptions::ReadAhead::Random:
+            alloc.set_read_ahead(util::AccessPattern::random);
+            break;
+    }
+    alloc.set_prefetch_clusters(options.prefetch_clusters);
+    alloc.set_huge_pages(to_huge_pages(options.huge_pages));
+
     if (options.is_immutable) {
         SlabAlloc::Config cfg;
         cfg.read_only = true;
@@ -1528,6 +1556,7 @@ void DB::open(Replication& repl, const DBOptions& options)
     repl.initialize(*this); // Throws
     set_replication(&repl);
 
+    m_alloc.set_huge_pages(to_huge_pages(options.huge_pages));
     m_alloc.init_in_memory_buffer();
 
     set_logger(options.logger);
@@ -1728,6 +1757,23 @@ bool DB::compact(bool bump_version_number, std::optional<const char*> output_enc
     return true;
 }
 
+bool DB::compact_incrementally(size_t work_limit)
+{
+    // A blocked compaction is retried after a number of commits, so keep
+    // committing until it is either done or no longer worth it.
+    if (m_evac_stage == EvacStage::idle)
+        return false;
+
+    auto tr = start_write(); // Throws
+    m_compaction_step_work_limit = work_limit;
+    util::ScopeExit cleanup([&]() noexcept {
+        m_compaction_step_work_limit = 0;
+    });
+    tr->commit(); // Throws
+
+    return m_evac_stage != EvacStage::idle;
+}
+
 void DB::write_copy(std::string_view path, const char* output_encryption_key)
 {
     auto tr = start_read();
@@ -2547,6 +2593,11 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
 
     GroupWriter out(transaction, Durability(info->durability), m_marker_observer.get()); // Throws
     out.set_versions(new_version, top_refs, any_new_unreachables);
+    // Files still at version 24, which are opened without history and not
+    // upgraded, must stay readable by the versions of Realm they came from
+    bool offset_encode = m_offset_encode_integer_leaves && transaction.get_file_format_version() >= 25;
+    out.set_offset_encode_integer_leaves(offset_encode);
+    out.set_writer_threads(m_commit_writer_threads);
     out.prepare_evacuation();
     auto t1 = std::chrono::steady_clock::now();
     auto commit_size = m_alloc.get_commit_size();
@@ -2554,14 +2605,18 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         m_logger->log(util::LogCategory::transaction, util::Logger::Level::debug, "Initiate commit version: %1",
                       new_version);
     }
+    size_t bytes_moved = 0;
     if (auto limit = out.get_evacuation_limit()) {
         // Get a work limit based on the size of the transaction we're about to commit
         // Add 4k to ensure progress on small commits
         size_t work_limit = commit_size / 2 + out.get_free_list_size() + 0x1000;
-        transaction.cow_outliers(out.get_evacuation_progress(), limit, work_limit);
+        work_limit = std::max(work_limit, m_online_compaction_work_limit) + m_compaction_step_work_limit;
+        bytes_moved = transaction.cow_outliers(out.get_evacuation_progress(), limit, work_limit);
     }
 
     ref_type new_top_ref;
+    size_t new_file_size;
+    size_t bytes_truncated = 0;
     // Recursively write all changed arrays to end of file
     {
         // protect against race with any other DB trying to attach to the file
@@ -2574,6 +2629,8 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         m_free_space = out.get_free_space_size();
         m_locked_space = out.get_locked_space_size();
         m_used_space = out.get_logical_size() - m_free_space;
+        m_logical_file_size = out.get_logical_size();
+        m_compaction_bytes_moved += bytes_moved;
         m_evac_stage.store(EvacStage(out.get_evacuation_stage()));
         out.sync_according_to_durability();
         if (Durability(info->durability) == Durability::Full || Durability(info->durability) == Durability::Unsafe) {
@@ -2582,7 +2639,7 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
                 cm.commit(new_top_ref);
             }
         }
-        size_t new_file_size = out.get_logical_size();
+        new_file_size = out.get_logical_size();
         // We must reset the allocators free space tracking before communicating the new
         // version through the ring buffer. If not, a reader may start updating the allocators
         // mappings while the allocator is in dirty state.
@@ -2611,6 +2668,35 @@ void DB::low_level_commit(uint_fast64_t new_version, Transaction& transaction, b
         info->latest_version_number = new_version;
 
         m_new_commit_available.notify_all();
+
+#ifndef _WIN32
+        // Online compaction may have freed the end of the file. No live version
+        // refers to anything beyond the new logical size, so the file can be
+        // truncated. Mappings of the truncated part are left in place, and are
+        // not touched by this DB until the file has grown again. Other DB
+        // objects, in this or other processes, may still touch their mappings
+        // of it, e.g. through read-ahead, which would raise SIGBUS beyond the
+        // end of the file. So, as for compact(), this DB must be the only one
+        // attached, and holding the control mutex keeps others from attaching.
+        if (m_truncate_file_online && info->num_participants == 1 && commit_to_disk && !m_alloc.is_in_memory() &&
+            !m_alloc.get_file().get_encryption() && new_file_size == util::round_up_to_page_size(new_file_size)) {
+            auto physical_file_size = size_t(m_alloc.get_file().get_size());
+            if (new_file_size < physical_file_size) {
+                m_alloc.get_file().resize(new_file_size); // Throws
+                bytes_truncated = physical_file_size - new_file_size;
+            }
+        }
+#endif
+    }
+    if (bytes_truncated) {
+        {
+            CheckedLockGuard lock_guard(m_mutex);
+            m_compaction_bytes_truncated += bytes_truncated;
+        }
+        if (m_logger) {
+            m_logger->log(util::LogCategory::storage, util::Logger::Level::detail, "Truncated file to %1 bytes",
+                          new_file_size);
+        }
     }
     auto t2 = std::chrono::steady_clock::now();
     if (m_logger) {
@@ -2803,11 +2889,18 @@ void DB::async_request_write_mutex(TransactionRef& tr, util::UniqueFunction<void
 
 inline DB::DB(Private, const DBOptions& options)
     : m_upgrade_callback(std::move(options.upgrade_callback))
+    , m_offset_encode_integer_leaves(options.offset_encode_integer_leaves)
+    , m_commit_writer_threads(options.commit_writer_threads)
+    , m_online_compaction_work_limit(options.online_compaction_work_limit)
+    , m_truncate_file_online(options.truncate_file_online)
     , m_log_id(util::gen_log_id(this))
 {
     if (options.enable_async_writes) {
         m_commit_helper = std::make_unique<AsyncCommitHelper>(this);
     }
+    if (options.query_cache_size) {
+        m_query_cache = std::make_unique<QueryCache>(options.query_cache_size);
+    }
 }
 
 DBRef DB::create(const std::string& file, const DBOptions& options) NO_THREAD_SAFETY_ANALYSIS
@@ -116,6 +116,7 @@ struct FileFormatUpgradeRequired : FileAccessError {
 ///
 
 class DB;
+class QueryCache;
 using DBRef = std::shared_ptr<DB>;
 
 class DB : public std::enable_shared_from_this<DB> {
@@ -184,6 +185,12 @@ public:
         m_replication = repl;
     }
 
+    /// The cache of query results, or null if DBOptions::query_cache_size is 0
+    QueryCache* get_query_cache() const noexcept
+    {
+        return m_query_cache.get();
+    }
+
     void set_logger(const std::shared_ptr<util::Logger>& logger) noexcept;
     util::Logger* get_logger() const noexcept
     {
@@ -295,6 +302,29 @@ public:
         return m_evac_stage;
     }
 
+    struct CompactionProgress {
+        EvacStage stage = EvacStage::idle;
+        size_t logical_file_size = 0; // As of the latest commit
+        size_t bytes_moved = 0;       // In total by the commits done through this DB
+        size_t bytes_truncated = 0;   // In total by the commits done through this DB
+    };
+
+    /// Report the progress of the online compaction, as seen by the commits
+    /// done through this DB.
+    CompactionProgress get_compaction_progress() const REQUIRES(!m_mutex);
+
+    /// Do one step of online compaction without waiting for the next commit.
+    /// This commits an empty write transaction, which moves up to `work_limit`
+    /// bytes of data out of the part of the file that is being freed, and is
+    /// meant to be called from an idle timer. Readers are not blocked. Online
+    /// compaction is started by a commit when the file has grown to more than
+    /// three times the size of the data it holds.
+    ///
+    /// Returns true if the compaction is still in progress afterwards, or has
+    /// been put on hold to be retried later, and false if there was no
+    /// compaction to do.
+    bool compact_incrementally(size_t work_limit) REQUIRES(!m_mutex);
+
     /// Report the number of distinct versions stored in the database at the time
     /// of latest commit.
     /// Note: the database only cleans up versions as part of commit, so ending
@@ -304,6 +334,15 @@ public:
     /// Get the size of the currently allocated slab area
     size_t get_allocated_size() const;
 
+    /// Get the number of page faults taken so far. Faults on the file mappings
+    /// cannot be told apart from other faults, so these are the counts for the
+    /// whole process; compare two samples to see the effect of a workload or of
+    /// the read-ahead settings (DBOptions::read_ahead, prefetch_clusters).
+    static util::PageFaultCounts get_page_fault_counts() noexcept
+    {
+        return util::get_page_fault_counts();
+    }
+
     /// Compact the database file.
     /// - The method will throw if called inside a transaction.
     /// - The method will throw if called in unattached state.
@@ -490,6 +529,9 @@ private:
     size_t m_free_space GUARDED_BY(m_mutex) = 0;
     size_t m_locked_space GUARDED_BY(m_mutex) = 0;
     size_t m_used_space GUARDED_BY(m_mutex) = 0;
+    size_t m_logical_file_size GUARDED_BY(m_mutex) = 0;
+    size_t m_compaction_bytes_moved GUARDED_BY(m_mutex) = 0;
+    size_t m_compaction_bytes_truncated GUARDED_BY(m_mutex) = 0;
     std::vector<ReadLockInfo> m_local_locks_held GUARDED_BY(m_mutex); // tracks all read locks held by this DB
     std::atomic<EvacStage> m_evac_stage = EvacStage::idle;
     util::File m_file;
@@ -512,6 +554,13 @@ private:
     std::mutex m_commit_listener_mutex;
     std::vector<CommitListener*> m_commit_listeners;
     bool m_is_sync_agent = false;
+    bool m_offset_encode_integer_leaves = false;
+    unsigned m_commit_writer_threads = 0;
+    size_t m_online_compaction_work_limit = 0;
+    bool m_truncate_file_online = false;
+    std::unique_ptr<QueryCache> m_query_cache;
+    // Extra work limit for the commit done by compact_incrementally()
+    size_t m_compaction_step_work_limit = 0;
     // Id for this DB to be used in logging. We will just use some bits from the pointer.
     // The path cannot be used as this would not allow us to distinguish between two DBs opening
     // the same realm.
@@ -638,6 +687,17 @@ inline void DB::get_stats(size_t& free_space, size_t& used_space, size_t* locked
     }
 }
 
+inline DB::CompactionProgress DB::get_compaction_progress() const
+{
+    util::CheckedLockGuard lock(m_mutex);
+    CompactionProgress progress;
+    progress.stage = m_evac_stage;
+    progress.logical_file_size = m_logical_file_size;
+    progress.bytes_moved = m_compaction_bytes_moved;
+    progress.bytes_truncated = m_compaction_bytes_truncated;
+    return progress;
+}
+
 
 class DisableReplication {
 public:
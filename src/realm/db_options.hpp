@@ -34,6 +34,20 @@ struct DBOptions {
         Unsafe // If you use this, you loose ACID property
     };
 
+    /// Which kind of huge pages to back memory with, see `huge_pages`.
+    enum class HugePages {
+        Off,
+        Transparent, // Transparent huge pages, if enabled in the kernel
+        Explicit     // 2MB pages from the reserved pool, else transparent huge pages
+    };
+
+    /// The read-ahead policy of the memory mappings of the Realm file.
+    enum class ReadAhead {
+        Default,    // Leave it to the operating system
+        Sequential, // Read aggressively ahead, for workloads scanning whole tables
+        Random      // Read only the pages touched, for point lookups in large files
+    };
+
     explicit DBOptions(Durability level = Durability::Full, const char* key = nullptr)
         : durability(level)
         , encryption_key(key)
@@ -106,6 +120,67 @@ struct DBOptions {
     /// will clear and reinitialize the file.
     bool clear_on_invalid_file = false;
 
+    /// If set, leaves of non-nullable integer columns are written using a
+    /// frame-of-reference encoding at commit whenever that makes them
+    /// smaller. Each value is then stored as a bit-packed offset from the
+    /// smallest value in the leaf, which benefits columns holding large values
+    /// in a narrow range, such as timestamps or sequential ids. Encoded leaves
+    /// are expanded again the first time they are modified. The encoding needs
+    /// file format version 25, so it is not used for files of version 24
+    /// which are opened without a history and therefore not upgraded.
+    bool offset_encode_integer_leaves = false;
+
+    /// Number of threads used to write the modified arrays of a commit to the
+    /// database file. With more than one thread, the arrays are staged in memory
+    /// by the committing thread and written to their reserved positions in
+    /// parallel, with arrays that are adjacent in the file combined into a
+    /// single write. This pays off for very large commits, such as bulk imports
+    /// or the bootstrap of a synchronized Realm. The top ref is still switched
+    /// once, after all the data is written. The committing thread is helped by
+    /// the threads of util::WorkerPool::get_default(), so no more threads are
+    /// used than the pool has plus one. Ignored for encrypted and in-memory
+    /// Realms, which are always written by the committing thread.
+    unsigned commit_writer_threads = 0;
+
+    /// Minimum number of bytes of data moved out of the end of the file by
+    /// each commit while an online compaction is in progress. Without it, the
+    /// amount depends on the size of the commit, so a Realm with few and small
+    /// commits may take a long time to shrink. See also
+    /// DB::compact_incrementally().
+    size_t online_compaction_work_limit = 0;
+
+    /// Truncate the file as soon as online compaction has freed the end of it.
+    /// Otherwise the file is only truncated when it is next opened by the
+    /// first process. Readers are not blocked either way. The file is only
+    /// truncated while no other DB object, in this or another process, has it
+    /// open. Ignored on Windows, which cannot truncate a file that is mapped,
+    /// and for encrypted Realms.
+    bool truncate_file_online = false;
+
+    /// The read-ahead policy applied to the file mappings. Ignored for
+    /// encrypted and in-memory Realms, and on platforms without madvise().
+    ReadAhead read_ahead = ReadAhead::Default;
+
+    /// If set, cluster traversals (queries, aggregates, table iteration) ask
+    /// the operating system to page in the next cluster while the current one
+    /// is processed. This mostly helps when the file is not already in the
+    /// page cache. Can be overridden for a single query with
+    /// Query::prefetch_clusters().
+    bool prefetch_clusters = false;
+
+    /// Back the memory used by write transactions, and the whole database for
+    /// in-memory Realms, with huge pages, and ask for the file mappings to use
+    /// them too where the filesystem supports it. Reduces TLB misses for
+    /// random access to large Realms. Falls back to normal pages if huge pages
+    /// are unavailable. Ignored on platforms without huge page support.
+    HugePages huge_pages = HugePages::Off;
+
+    /// Maximum number of results kept by the query cache of the DB (see
+    /// QueryCache). Queries run in read and frozen transactions then reuse the
+    /// results of identical queries run on the same version, from any thread.
+    /// The cache is disabled if 0.
+    size_t query_cache_size = 0;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating DBOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
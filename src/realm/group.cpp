@@ -325,7 +325,7 @@ int Group::get_target_file_format_version_for_session(int current_file_format_ve
     // individual file format versions.
 
     if (requested_history_type == Replication::hist_None) {
-        if (current_file_format_version == 24) {
+        if (current_file_format_version == 24 || current_file_format_version == 25) {
             // We are able to open these file formats in RO mode
             return current_file_format_version;
         }
@@ -419,6 +419,9 @@ int Group::read_only_version_check(SlabAlloc& alloc, ref_type top_ref, const std
         case 0:
             file_format_ok = (top_ref == 0);
             break;
+        case 24:
+            // Version 25 only adds encodings, so files of version 24 can be
+            // read as they are
         case g_current_file_format_version:
             file_format_ok = true;
             break;
@@ -1174,6 +1177,16 @@ void Group::update_refs(ref_type top_ref) noexcept
     }
 }
 
+ref_type Group::typed_write_tables(_impl::ArrayWriterBase& out) const
+{
+    return Array::write_with_children(m_tables.get_ref(), m_alloc, out, [&](size_t ndx, ref_type child_ref) {
+        Table* table = ndx < m_table_accessors.size() ? m_table_accessors[ndx] : nullptr;
+        if (table)
+            return table->typed_write(child_ref, out, m_alloc); // Throws
+        return Array::write(child_ref, m_alloc, out, true);  // Throws
+    });
+}
+
 bool Group::operator==(const Group& g) const
 {
     for (auto tk : get_table_keys()) {
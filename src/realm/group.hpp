@@ -646,6 +646,12 @@ private:
     /// commits via shared group.
     void update_refs(ref_type top_ref) noexcept;
 
+    /// Write the modified tables as by `m_tables.write(out, true, true)`,
+    /// except that tables with an attached accessor are written by
+    /// Table::typed_write(), which may choose a more compact encoding for
+    /// some of the leaves.
+    ref_type typed_write_tables(_impl::ArrayWriterBase& out) const;
+
     // Overriding method in ArrayParent
     void update_child_ref(size_t, ref_type) override;
 
@@ -763,6 +769,9 @@ private:
     ///     Backlinks in BPlusTree
     ///     Sort order of Strings changed (affects sets and the string index)
     ///
+    ///  25 Frame-of-reference encoded integer leaves (width type 3).
+    ///     Sorted search index (column attribute col_attr_Sorted_Indexed).
+    ///
     /// IMPORTANT: When introducing a new file format version, be sure to review
     /// the file validity checks in Group::open() and DB::do_open, the file
     /// format selection logic in
@@ -770,7 +779,7 @@ private:
     /// upgrade logic in Group::upgrade_file_format(), AND the lists of accepted
     /// file formats and the version deletion list residing in "backup_restore.cpp"
 
-    static constexpr int g_current_file_format_version = 24;
+    static constexpr int g_current_file_format_version = 25;
 
     int get_file_format_version() const noexcept;
     void set_file_format_version(int) noexcept;
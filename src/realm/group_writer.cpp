@@ -29,10 +29,20 @@
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/impl/simulated_failure.hpp>
 #include <realm/util/safe_int_ops.hpp>
+#include <realm/util/scope_exit.hpp>
+#include <realm/util/worker_pool.hpp>
 
 using namespace realm;
 using namespace realm::util;
 
+namespace {
+// Amount of array data staged by GroupWriter::write_array() before it is
+// written to the file, when writing with multiple threads.
+constexpr size_t s_staged_write_batch_size = 0x2000000; // 32 MiB
+// Smallest piece of staged data handed to a single writer thread.
+constexpr size_t s_min_staged_write_size = 0x10000; // 64 KiB
+} // anonymous namespace
+
 namespace realm {
 class InMemoryWriter : public _impl::ArrayWriterBase {
 public:
@@ -70,7 +80,7 @@ private:
 class WriteWindowMgr::MapWindow {
 public:
     MapWindow(size_t alignment, util::File& f, ref_type start_ref, size_t initial_size,
-              util::WriteMarker* write_marker = nullptr);
+              util::WriteMarker* write_marker = nullptr, bool huge_pages = false);
     ~MapWindow();
 
     // translate a ref to a pointer
@@ -94,7 +104,9 @@ private:
     ref_type m_base_ref;
     ref_type aligned_to_mmap_block(ref_type start_ref);
     size_t get_window_size(util::File& f, ref_type start_ref, size_t size);
+    void map(util::File& f, size_t window_size);
     size_t m_alignment;
+    bool m_huge_pages;
 };
 
 // True if a requested block fall within a memory mapping.
@@ -151,17 +163,25 @@ bool WriteWindowMgr::MapWindow::extends_to_match(util::File& f, ref_type start_r
     size_t window_size = get_window_size(f, start_ref, size);
     m_map.sync();
     m_map.unmap();
-    m_map.map(f, File::access_ReadWrite, window_size, m_base_ref);
+    map(f, window_size);
     return true;
 }
 
+void WriteWindowMgr::MapWindow::map(util::File& f, size_t window_size)
+{
+    m_map.map(f, File::access_ReadWrite, window_size, m_base_ref);
+    if (m_huge_pages && !m_map.get_encrypted_mapping())
+        util::advise_huge_pages(m_map.get_addr(), window_size);
+}
+
 WriteWindowMgr::MapWindow::MapWindow(size_t alignment, util::File& f, ref_type start_ref, size_t size,
-                                     util::WriteMarker* write_marker)
+                                     util::WriteMarker* write_marker, bool huge_pages)
     : m_alignment(alignment)
+    , m_huge_pages(huge_pages)
 {
     m_base_ref = aligned_to_mmap_block(start_ref);
     size_t window_size = get_window_size(f, start_ref, size);
-    m_map.map(f, File::access_ReadWrite, window_size, m_base_ref);
+    map(f, window_size);
 #if REALM_ENABLE_ENCRYPTION
     if (auto p = m_map.get_encrypted_mapping())
         p->set_marker(write_marker);
@@ -227,6 +247,9 @@ WriteWindowMgr::WriteWindowMgr(SlabAlloc& alloc, Durability dura, WriteMarker* w
         m_window_alignment = wanted_size;
     }
 #endif
+    // Let windows cover whole huge pages
+    if (m_alloc.get_huge_pages() != util::HugePages::off && m_window_alignment < util::huge_page_size)
+        m_window_alignment = util::huge_page_size;
 }
 
 GroupCommitter::GroupCommitter(Transaction& group, Durability dura, WriteMarker* write_marker)
@@ -311,6 +334,10 @@ void GroupWriter::sync_according_to_durability()
         case Durability::Full:
         case Durability::Unsafe:
             m_window_mgr.sync_all_mappings();
+            // Staged arrays were written to the file directly and not
+            // through any of the mappings.
+            if (m_any_staged_writes && m_durability == Durability::Full && !get_disable_sync_to_disk())
+                m_alloc.get_file().sync();
             break;
         case Durability::MemOnly:
             m_window_mgr.flush_all_mappings();
@@ -319,6 +346,15 @@ void GroupWriter::sync_according_to_durability()
 
 GroupWriter::~GroupWriter() = default;
 
+void GroupWriter::set_writer_threads(unsigned num_threads) noexcept
+{
+    // Encrypted files must be written page by page through the mappings, and
+    // arrays of in-memory Realms never go through write_array().
+    if (m_alloc.is_in_memory() || m_alloc.get_file().get_encryption())
+        num_threads = 0;
+    m_writer_threads = num_threads > 1 ? num_threads : 0;
+}
+
 size_t GroupWriter::get_file_size() const noexcept
 {
     auto sz = to_size_t(m_alloc.get_file_size());
@@ -360,8 +396,9 @@ WriteWindowMgr::MapWindow* WriteWindowMgr::get_window(ref_type start_ref, size_t
         m_map_windows.back()->flush();
         m_map_windows.pop_back();
     }
-    auto new_window =
-        std::make_unique<MapWindow>(m_window_alignment, m_alloc.get_file(), start_ref, size, m_write_marker);
+    bool huge_pages = m_alloc.get_huge_pages() != util::HugePages::off;
+    auto new_window = std::make_unique<MapWindow>(m_window_alignment, m_alloc.get_file(), start_ref, size,
+                                                  m_write_marker, huge_pages);
     m_map_windows.insert(m_map_windows.begin(), std::move(new_window));
     return m_map_windows[0].get();
 }
@@ -667,7 +704,9 @@ ref_type GroupWriter::write_group()
         writer = in_memory_writer.get();
     }
     ref_type names_ref = m_group.m_table_names.write(*writer, deep, only_if_modified); // Throws
-    ref_type tables_ref = m_group.m_tables.write(*writer, deep, only_if_modified);     // Throws
+    ref_type tables_ref = m_offset_encode_integer_leaves
+                              ? m_group.typed_write_tables(*writer)                      // Throws
+                              : m_group.m_tables.write(*writer, deep, only_if_modified); // Throws
 
     int_fast64_t value_1 = from_ref(names_ref);
     int_fast64_t value_2 = from_ref(tables_ref);
@@ -684,6 +723,21 @@ ref_type GroupWriter::write_group()
             top.set(Group::s_hist_ref_ndx, from_ref(new_history_ref));                              // Throws
         }
     }
+    // The evacuation limit leaves room for half as much again as the data held
+    // when the compaction started. If the data has since outgrown that, what is
+    // left below the limit is too little to take the rest, so give up.
+    if (m_evacuation_limit) {
+        size_t free_below_limit = 0;
+        for (const auto& [size, ref] : m_size_map)
+            free_below_limit += size;
+        size_t free_above_limit = 0;
+        for (const auto& elem : m_under_evacuation)
+            free_above_limit += elem.size;
+        size_t used_space = m_logical_size - free_below_limit - free_above_limit;
+        if (used_space > m_evacuation_limit / 3 * 2)
+            give_up_evacuation();
+    }
+
     if (top.size() > Group::s_evacuation_point_ndx) {
         ref_type ref = top.get_as_ref(Group::s_evacuation_point_ndx);
         if (m_evacuation_limit || m_backoff) {
@@ -712,6 +766,10 @@ ref_type GroupWriter::write_group()
         }
     }
 
+    // All arrays apart from 'top' and the free-lists have now been written or
+    // staged. Get the staged ones into the file.
+    flush_staged_writes(); // Throws
+
     ALLOC_DBG_COUT("  Freelist size after allocations: " << m_size_map.size() << std::endl);
     // We now back-date (if possible) any blocks freed in versions which
     // are becoming unreachable.
@@ -1007,6 +1065,14 @@ void GroupWriter::read_in_freelist()
     std::cout << std::endl;
 #endif
 
+    // Chunks released at the same version become free at the same time, so
+    // they can be combined right away.
+    merge_adjacent_entries_in_freelist(m_not_free_in_file);
+    m_not_free_in_file.erase(std::remove_if(m_not_free_in_file.begin(), m_not_free_in_file.end(),
+                                            [](const auto& a) {
+                                                return a.size == 0;
+                                            }),
+                             m_not_free_in_file.end());
     merge_adjacent_entries_in_freelist(m_under_evacuation);
     m_under_evacuation.erase(std::remove_if(m_under_evacuation.begin(), m_under_evacuation.end(),
                                             [](const auto& a) {
@@ -1055,6 +1121,9 @@ size_t GroupWriter::recreate_freelist(size_t reserve_pos)
     std::sort(begin(free_in_file), end(free_in_file), [](auto& a, auto& b) {
         return a.ref < b.ref;
     });
+    // The chunk reserved for the free-lists must stay separate, as the space
+    // used from it is deducted later.
+    merge_adjacent_entries_in_freelist(free_in_file, reserve_pos);
 
     {
         // Copy into arrays while checking consistency
@@ -1064,6 +1133,9 @@ size_t GroupWriter::recreate_freelist(size_t reserve_pos)
         auto limit = free_in_file.size();
         for (size_t i = 0; i < limit; ++i) {
             const auto& free_space = free_in_file[i];
+            // Skip elements merged in 'merge_adjacent_entries_in_freelist'
+            if (free_space.size == 0)
+                continue;
             auto ref = free_space.ref;
             if (REALM_UNLIKELY(prev_ref + prev_size > ref)) {
                 // Check if we are freeing arrays already in 'm_not_free_in_file'
@@ -1084,7 +1156,7 @@ size_t GroupWriter::recreate_freelist(size_t reserve_pos)
                                         m_alloc.get_file_path_for_assertions());
             }
             if (reserve_pos == ref) {
-                reserve_ndx = i;
+                reserve_ndx = m_free_positions.size();
             }
             else {
                 // The reserved chunk should not be counted in now. We don't know how much of it
@@ -1105,15 +1177,18 @@ size_t GroupWriter::recreate_freelist(size_t reserve_pos)
     return reserve_ndx;
 }
 
-void GroupWriter::merge_adjacent_entries_in_freelist(std::vector<GroupWriter::FreeSpaceEntry>& list)
+void GroupWriter::merge_adjacent_entries_in_freelist(std::vector<GroupWriter::FreeSpaceEntry>& list,
+                                                     size_t keep_ref)
 {
     if (list.size() > 1) {
-        // Combine any adjacent chunks in the freelist
+        // Combine any adjacent chunks in the freelist that are released at the
+        // same version. The chunk at 'keep_ref' is left as it is.
         auto prev = list.begin();
         auto end = list.end();
         for (auto it = list.begin() + 1; it != end; ++it) {
             REALM_ASSERT(it->ref > prev->ref);
-            if (prev->ref + prev->size == it->ref) {
+            if (prev->ref + prev->size == it->ref && prev->released_at_version == it->released_at_version &&
+                prev->ref != keep_ref && it->ref != keep_ref) {
                 prev->size += it->size;
                 it->size = 0;
             }
@@ -1125,7 +1200,7 @@ void GroupWriter::merge_adjacent_entries_in_freelist(std::vector<GroupWriter::Fr
 }
 
 void GroupWriter::move_free_in_file_to_size_map(const std::vector<GroupWriter::FreeSpaceEntry>& list,
-                                                std::multimap<size_t, size_t>& size_map)
+                                                FreeChunks& size_map)
 {
     ALLOC_DBG_COUT("  Freelist (true free): ");
     for (auto& elem : list) {
@@ -1161,6 +1236,10 @@ size_t GroupWriter::get_free_space(size_t size)
         // in order to make sure that it returns a chunk from which allocation
         // can be done from the beginning
         m_size_map.emplace(rest, chunk_pos + size);
+        m_last_rest = {rest, chunk_pos + size};
+    }
+    else {
+        m_last_rest = {0, 0};
     }
     return chunk_pos;
 }
@@ -1177,7 +1256,7 @@ inline GroupWriter::FreeListElement GroupWriter::split_freelist_chunk(FreeListEl
     size_t size_first = alloc_pos - start_pos;
     size_t size_second = chunk_size - size_first;
     m_size_map.emplace(size_first, start_pos);
-    return m_size_map.emplace(size_second, alloc_pos);
+    return m_size_map.emplace(size_second, alloc_pos).first;
 }
 
 GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element(FreeListElement it, size_t size)
@@ -1205,44 +1284,55 @@ GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element
 
 GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(size_t size)
 {
-    auto it = m_size_map.lower_bound(size);
-    while (it != m_size_map.end()) {
-        // Accept either a perfect match or a block that is twice the size. Tests have shown
-        // that this is a good strategy.
-        if (it->first == size || it->first >= 2 * size) {
-            auto ret = search_free_space_in_free_list_element(it, size);
-            if (ret != m_size_map.end()) {
+    auto end = m_size_map.end();
+    auto it = m_size_map.lower_bound({size, 0});
+    // A perfect match leaves no fragment behind
+    if (it != end && it->first == size) {
+        auto ret = search_free_space_in_free_list_element(it, size);
+        if (ret != end)
+            return ret;
+    }
+    // Next, try to continue right after the previous allocation
+    if (m_last_rest.first >= size) {
+        auto last = m_size_map.find(m_last_rest);
+        if (last != end) {
+            auto ret = search_free_space_in_free_list_element(last, size);
+            if (ret != end)
                 return ret;
-            }
-            ++it;
-        }
-        else {
-            // If block was too small, search for the first that is at least twice as big.
-            it = m_size_map.lower_bound(2 * size);
         }
     }
+    // Otherwise take the smallest chunk that can hold the allocation (best fit)
+    for (; it != end; ++it) {
+        auto ret = search_free_space_in_free_list_element(it, size);
+        if (ret != end)
+            return ret;
+    }
     // No match
-    return m_size_map.end();
+    return end;
 }
 
 
+void GroupWriter::give_up_evacuation()
+{
+    // Release all kept back elements and wait 10 commits until trying again
+    for (auto& elem : m_under_evacuation) {
+        m_size_map.emplace(elem.size, elem.ref);
+    }
+    m_under_evacuation.clear();
+    m_evacuation_limit = 0;
+    m_backoff = 10;
+    if (auto logger = m_group.get_logger()) {
+        logger->log(util::Logger::Level::detail, "Give up compaction");
+    }
+}
+
 GroupWriter::FreeListElement GroupWriter::reserve_free_space(size_t size)
 {
     auto chunk = search_free_space_in_part_of_freelist(size);
     while (chunk == m_size_map.end()) {
         if (!m_under_evacuation.empty()) {
             // We have been too aggressive in setting the evacuation limit
-            // Just give up
-            // But first we will release all kept back elements
-            for (auto& elem : m_under_evacuation) {
-                m_size_map.emplace(elem.size, elem.ref);
-            }
-            m_under_evacuation.clear();
-            m_evacuation_limit = 0;
-            m_backoff = 10;
-            if (auto logger = m_group.get_logger()) {
-                logger->log(util::Logger::Level::detail, "Give up compaction");
-            }
+            give_up_evacuation();
             chunk = search_free_space_in_part_of_freelist(size);
         }
         else {
@@ -1320,7 +1410,7 @@ GroupWriter::FreeListElement GroupWriter::extend_free_space(size_t requested_siz
     size_t chunk_size = new_file_size - logical_file_size;
     REALM_ASSERT_RELEASE_EX(!(chunk_size & 7), chunk_size);
     REALM_ASSERT_RELEASE(chunk_size != 0);
-    auto it = m_size_map.emplace(chunk_size, logical_file_size);
+    auto it = m_size_map.emplace(chunk_size, logical_file_size).first;
 
     // Update the logical file size
     m_logical_size = new_file_size;
@@ -1342,6 +1432,20 @@ ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checks
     // Get position of free space to write in (expanding file if needed)
     size_t pos = get_free_space(size);
 
+    if (m_writer_threads) {
+        // Just take a copy. The block is written by flush_staged_writes()
+        if (m_staged_data.capacity() == 0)
+            m_staged_data.reserve(s_staged_write_batch_size);
+        size_t offset = m_staged_data.size();
+        m_staged_data.insert(m_staged_data.end(), reinterpret_cast<const char*>(&checksum),
+                             reinterpret_cast<const char*>(&checksum) + 4);
+        m_staged_data.insert(m_staged_data.end(), data + 4, data + size);
+        m_staged_writes.push_back({pos, offset, size});
+        if (m_staged_data.size() >= s_staged_write_batch_size)
+            flush_staged_writes(); // Throws
+        return to_ref(pos);
+    }
+
     // Write the block
     MapWindow* window = m_window_mgr.get_window(pos, size);
     char* dest_addr = window->translate(pos);
@@ -1355,6 +1459,57 @@ ref_type GroupWriter::write_array(const char* data, size_t size, uint32_t checks
     return ref;
 }
 
+void GroupWriter::flush_staged_writes()
+{
+    if (m_staged_writes.empty())
+        return;
+
+    // Space is mostly handed out in increasing order within a free chunk, so
+    // many of the staged arrays are adjacent in the file. As they are also
+    // adjacent in the staging buffer, they can be combined into one write.
+    // Runs that are larger than a fair share of the batch are split again so
+    // that the work is spread evenly across the threads.
+    size_t max_piece_size =
+        std::max(s_min_staged_write_size, m_staged_data.size() / (size_t(m_writer_threads) * 4) + 1);
+    std::vector<StagedWrite> pieces;
+    auto add_run = [&](StagedWrite run) {
+        while (run.size > max_piece_size) {
+            pieces.push_back({run.pos, run.offset, max_piece_size});
+            run.pos += max_piece_size;
+            run.offset += max_piece_size;
+            run.size -= max_piece_size;
+        }
+        pieces.push_back(run);
+    };
+    StagedWrite run = m_staged_writes.front();
+    for (auto it = m_staged_writes.begin() + 1; it != m_staged_writes.end(); ++it) {
+        if (run.pos + run.size == it->pos) {
+            run.size += it->size;
+        }
+        else {
+            add_run(run);
+            run = *it;
+        }
+    }
+    add_run(run);
+
+    File& file = m_alloc.get_file();
+    const char* data = m_staged_data.data();
+    // Staged data is cleared even if a write fails
+    auto clear_staged = util::make_scope_exit([&]() noexcept {
+        m_staged_writes.clear();
+        m_staged_data.clear();
+        m_any_staged_writes = true;
+    });
+    util::WorkerPool::get_default().run(
+        pieces.size(),
+        [&](size_t i) {
+            const StagedWrite& piece = pieces[i];
+            file.write(piece.pos, data + piece.offset, piece.size); // Throws
+        },
+        m_writer_threads); // Throws
+}
+
 template <class T>
 void GroupWriter::write_array_at(T* translator, ref_type ref, const char* data, size_t size)
 {
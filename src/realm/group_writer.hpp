@@ -22,6 +22,8 @@
 #include <cstdint> // unint8_t etc
 #include <utility>
 #include <map>
+#include <set>
+#include <vector>
 
 #include <realm/util/file.hpp>
 #include <realm/alloc.hpp>
@@ -129,6 +131,17 @@ public:
 
     void set_versions(uint64_t current, TopRefMap& top_refs, bool any_num_unreachables) noexcept;
 
+    /// Write the leaves of integer columns using the frame-of-reference
+    /// encoding where possible. See DBOptions::offset_encode_integer_leaves.
+    void set_offset_encode_integer_leaves(bool value) noexcept
+    {
+        m_offset_encode_integer_leaves = value;
+    }
+
+    /// Write the arrays of the commit using the specified number of threads.
+    /// See DBOptions::commit_writer_threads.
+    void set_writer_threads(unsigned num_threads) noexcept;
+
     /// Write all changed array nodes into free space.
     ///
     /// Returns the new top ref. When in full durability mode, call
@@ -212,9 +225,15 @@ private:
         uint64_t released_at_version;
     };
 
-    static void merge_adjacent_entries_in_freelist(std::vector<FreeSpaceEntry>& list);
+    // Free chunks as (size, position) pairs. Ordering by size first and then
+    // by position finds the smallest chunk of at least a given size with a
+    // single lookup, and lets any particular chunk be found again by its size
+    // and position.
+    using FreeChunks = std::set<std::pair<size_t, size_t>>;
+
+    static void merge_adjacent_entries_in_freelist(std::vector<FreeSpaceEntry>& list, size_t keep_ref = npos);
     static void move_free_in_file_to_size_map(const std::vector<GroupWriter::FreeSpaceEntry>& list,
-                                              std::multimap<size_t, size_t>& size_map);
+                                              FreeChunks& size_map);
 
     Transaction& m_group;
     SlabAlloc& m_alloc;
@@ -232,16 +251,34 @@ private:
     size_t m_evacuation_limit;
     int64_t m_backoff;
     size_t m_logical_size = 0;
+    bool m_offset_encode_integer_leaves = false;
+
+    // When writing with multiple threads, write_array() only reserves the
+    // space and copies the array into m_staged_data. The staged arrays are
+    // written to the file by flush_staged_writes().
+    struct StagedWrite {
+        size_t pos;    // Position in the file
+        size_t offset; // Offset into m_staged_data
+        size_t size;
+    };
+    unsigned m_writer_threads = 0;
+    std::vector<StagedWrite> m_staged_writes;
+    std::vector<char> m_staged_data;
+    bool m_any_staged_writes = false;
 
     //  m_free_in_file;
     std::vector<FreeSpaceEntry> m_not_free_in_file;
     std::vector<FreeSpaceEntry> m_under_evacuation;
-    std::multimap<size_t, size_t> m_size_map;
+    FreeChunks m_size_map;
+    // The chunk holding what was left of the chunk used for the latest
+    // allocation, or (0, 0) if nothing was left.
+    std::pair<size_t, size_t> m_last_rest = {0, 0};
     std::vector<size_t> m_evacuation_progress;
-    using FreeListElement = std::multimap<size_t, size_t>::iterator;
+    using FreeListElement = FreeChunks::iterator;
 
     void read_in_freelist();
     size_t recreate_freelist(size_t reserve_pos);
+    void give_up_evacuation();
 
     /// Allocate a chunk of free space of the specified size. The
     /// specified size must be 8-byte aligned. Extend the file if
@@ -267,8 +304,11 @@ private:
 
     FreeListElement search_free_space_in_free_list_element(FreeListElement element, size_t size);
 
-    /// Search only a range of the free list for a block as big as the
-    /// specified size. Return a pair with index and size of the found chunk.
+    /// Search the free list for a block as big as the specified size. A chunk
+    /// of exactly the requested size is preferred. Otherwise the allocation
+    /// continues where the latest one ended, so that arrays written by the
+    /// same commit stay together, and as a last resort the smallest chunk
+    /// that can hold it is used (best fit).
     FreeListElement search_free_space_in_part_of_freelist(size_t size);
 
     /// Extend the file to ensure that a chunk of free space of the
@@ -281,6 +321,8 @@ private:
     /// size, and `chunk_size` is the size of that chunk.
     FreeListElement extend_free_space(size_t requested_size);
 
+    void flush_staged_writes();
+
     template <class T>
     void write_array_at(T* translator, ref_type, const char* data, size_t size);
     FreeListElement split_freelist_chunk(FreeListElement, size_t alloc_pos);
@@ -0,0 +1,319 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/index_sorted.hpp>
+#include <realm/unicode.hpp>
+
+#include <deque>
+#include <iostream>
+
+using namespace realm;
+
+namespace {
+
+// Unresolved links are indexed as null, as by the StringIndex
+Mixed index_value(Mixed value)
+{
+    return value.is_unresolved_link() ? Mixed() : value;
+}
+
+} // anonymous namespace
+
+SortedIndex::SortedIndex(const ClusterColumn& target_column, Allocator& alloc)
+    : SearchIndex(target_column, &m_top)
+    , m_top(alloc)
+    , m_values(alloc)
+    , m_keys(alloc)
+{
+    m_top.create(Array::type_HasRefs); // Throws
+    m_values.create();                 // Throws
+    m_keys.create();                   // Throws
+    m_top.add(from_ref(m_values.get_ref()));
+    m_top.add(from_ref(m_keys.get_ref()));
+    m_values.set_parent(&m_top, 0);
+    m_keys.set_parent(&m_top, 1);
+}
+
+SortedIndex::SortedIndex(ref_type ref, ArrayParent* parent, size_t ndx_in_parent, const ClusterColumn& target_column,
+                         Allocator& alloc)
+    : SearchIndex(target_column, &m_top)
+    , m_top(alloc)
+    , m_values(alloc)
+    , m_keys(alloc)
+{
+    m_top.init_from_ref(ref);
+    m_top.set_parent(parent, ndx_in_parent);
+    m_values.set_parent(&m_top, 0);
+    m_keys.set_parent(&m_top, 1);
+    init_trees();
+}
+
+void SortedIndex::init_trees()
+{
+    m_values.init_from_parent();
+    m_keys.init_from_parent();
+}
+
+void SortedIndex::refresh_accessor_tree(const ClusterColumn& target_column)
+{
+    SearchIndex::refresh_accessor_tree(target_column);
+    init_trees();
+}
+
+void SortedIndex::update_from_parent() noexcept
+{
+    SearchIndex::update_from_parent();
+    init_trees();
+}
+
+size_t SortedIndex::lower_bound(const Mixed& value) const
+{
+    size_t begin = 0;
+    size_t end = size();
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        if (m_values.get(mid).compare(value) < 0)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+    return begin;
+}
+
+size_t SortedIndex::upper_bound(const Mixed& value) const
+{
+    size_t begin = 0;
+    size_t end = size();
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        if (m_values.get(mid).compare(value) <= 0)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+    return begin;
+}
+
+size_t SortedIndex::insert_position(ObjKey key, const Mixed& value) const
+{
+    size_t begin = lower_bound(value);
+    size_t end = upper_bound(value);
+    // Objects with the same value are ordered by key
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        if (m_keys.get(mid) < key.value)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+    return begin;
+}
+
+size_t SortedIndex::find_entry(ObjKey key, const Mixed& value) const
+{
+    size_t ndx = insert_position(key, value);
+    if (ndx < size() && m_keys.get(ndx) == key.value)
+        return ndx;
+    // The value of the object did not match the one in the index
+    ndx = m_keys.find_first(key.value);
+    REALM_ASSERT_RELEASE(ndx != npos);
+    return ndx;
+}
+
+void SortedIndex::insert(ObjKey key, const Mixed& value)
+{
+    Mixed v = index_value(value);
+    size_t ndx = insert_position(key, v);
+    m_values.insert(ndx, v);
+    m_keys.insert(ndx, key.value);
+}
+
+void SortedIndex::set(ObjKey key, const Mixed& new_value)
+{
+    erase(key);
+    insert(key, new_value);
+}
+
+void SortedIndex::erase(ObjKey key)
+{
+    size_t ndx = find_entry(key, index_value(m_target_column.get_value(key)));
+    m_values.erase(ndx);
+    m_keys.erase(ndx);
+}
+
+void SortedIndex::clear()
+{
+    m_values.clear();
+    m_keys.clear();
+}
+
+ObjKey SortedIndex::find_first(const Mixed& value) const
+{
+    size_t ndx = lower_bound(value);
+    if (ndx < size() && m_values.get(ndx).compare(value) == 0)
+        return get_key(ndx);
+    return {};
+}
+
+void SortedIndex::find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive) const
+{
+    if (case_insensitive && value.is_type(type_String)) {
+        auto folded = case_map(value.get_string(), false);
+        for (size_t i = 0; i < size(); ++i) {
+            Mixed v = m_values.get(i);
+            if (v.is_type(type_String) && case_map(v.get_string(), false) == folded)
+                result.push_back(get_key(i));
+        }
+        std::sort(result.begin(), result.end());
+        return;
+    }
+    get_keys(lower_bound(value), upper_bound(value), result);
+}
+
+FindRes SortedIndex::find_all_no_copy(Mixed value, InternalFindResult& result) const
+{
+    size_t begin = lower_bound(value);
+    size_t end = upper_bound(value);
+    if (begin == end)
+        return FindRes_not_found;
+    if (end - begin == 1) {
+        result.payload = m_keys.get(begin);
+        return FindRes_single;
+    }
+    result.payload = m_keys.get_ref();
+    result.start_ndx = begin;
+    result.end_ndx = end;
+    return FindRes_column;
+}
+
+size_t SortedIndex::count(const Mixed& value) const
+{
+    return upper_bound(value) - lower_bound(value);
+}
+
+bool SortedIndex::has_duplicate_values() const noexcept
+{
+    for (size_t i = 1; i < size(); ++i) {
+        if (m_values.get(i - 1).compare(m_values.get(i)) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool SortedIndex::is_empty() const
+{
+    return size() == 0;
+}
+
+void SortedIndex::insert_bulk(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values,
+                              ArrayPayload& values)
+{
+    if (!is_empty()) {
+        for (size_t i = 0; i < num_values; ++i)
+            insert(ObjKey((keys ? keys->get(i) : i) + key_offset), values.get_any(i));
+        return;
+    }
+
+    // Filling an empty index: the values are sorted here and appended
+    std::vector<std::pair<Mixed, ObjKey>> entries;
+    std::deque<std::string> buffers;
+    entries.reserve(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+        Mixed value = index_value(values.get_any(i));
+        if (value.is_type(type_String, type_Binary))
+            value.use_buffer(buffers.emplace_back());
+        entries.emplace_back(value, ObjKey((keys ? keys->get(i) : i) + key_offset));
+    }
+    std::sort(entries.begin(), entries.end(), [](auto& a, auto& b) {
+        int c = a.first.compare(b.first);
+        return c ? c < 0 : a.second < b.second;
+    });
+    for (auto& [value, key] : entries) {
+        m_values.add(value);
+        m_keys.add(key.value);
+    }
+}
+
+void SortedIndex::insert_bulk_list(const ArrayUnsigned*, uint64_t, size_t, ArrayInteger&)
+{
+    REALM_UNREACHABLE(); // Collections are not supported
+}
+
+void SortedIndex::get_keys(size_t begin, size_t end, std::vector<ObjKey>& keys) const
+{
+    keys.reserve(keys.size() + (end - begin));
+    for (size_t i = begin; i < end; ++i)
+        keys.push_back(get_key(i));
+}
+
+void SortedIndex::for_each_in_order(bool ascending, util::FunctionRef<bool(ObjKey)> func) const
+{
+    size_t sz = size();
+    if (ascending) {
+        for (size_t i = 0; i < sz; ++i) {
+            if (!func(get_key(i)))
+                return;
+        }
+        return;
+    }
+
+    // Walk the runs of equal values from the back, each of them from the front
+    size_t end = sz;
+    while (end > 0) {
+        size_t begin = end - 1;
+        Mixed value = m_values.get(begin);
+        std::string buffer;
+        if (value.is_type(type_String, type_Binary))
+            value.use_buffer(buffer);
+        while (begin > 0 && m_values.get(begin - 1).compare(value) == 0)
+            --begin;
+        for (size_t i = begin; i < end; ++i) {
+            if (!func(get_key(i)))
+                return;
+        }
+        end = begin;
+    }
+}
+
+void SortedIndex::verify() const
+{
+#ifdef REALM_DEBUG
+    m_top.verify();
+    m_values.verify();
+    m_keys.verify();
+    REALM_ASSERT(m_values.size() == m_keys.size());
+    REALM_ASSERT(m_keys.size() == m_target_column.size());
+    for (size_t i = 0; i < size(); ++i) {
+        ObjKey key = get_key(i);
+        Mixed value = m_values.get(i);
+        REALM_ASSERT(index_value(m_target_column.get_value(key)).compare(value) == 0);
+        if (i > 0) {
+            int c = m_values.get(i - 1).compare(value);
+            REALM_ASSERT(c < 0 || (c == 0 && get_key(i - 1) < key));
+        }
+    }
+#endif
+}
+
+#ifdef REALM_DEBUG // LCOV_EXCL_START ignore debug functions
+void SortedIndex::print() const
+{
+    for (size_t i = 0; i < size(); ++i)
+        std::cout << m_values.get(i) << ": " << get_key(i) << "\n";
+}
+#endif // LCOV_EXCL_STOP ignore debug functions
@@ -0,0 +1,139 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_INDEX_SORTED_HPP
+#define REALM_INDEX_SORTED_HPP
+
+#include <realm/array.hpp>
+#include <realm/array_mixed.hpp>
+#include <realm/bplustree.hpp>
+#include <realm/column_integer.hpp>
+#include <realm/query_conditions.hpp>
+#include <realm/search_index.hpp>
+#include <realm/util/function_ref.hpp>
+
+/*
+The SortedIndex keeps the values of a column in order, so that it can answer
+range conditions and give the objects in the order of their values.
+
+It consists of two B+ trees of the same size, one with the values and one with
+the keys of the objects holding them, ordered by value and then by key. Null
+comes before any other value, as when sorting. Both trees hang off a top array:
+
+    m_top -> [ values (BPlusTree<Mixed>), keys (BPlusTree<Int>) ]
+
+The keys tree is an IntegerColumn, so a run of entries can be handed out as a
+FindRes_column result like the ones of the StringIndex.
+*/
+
+namespace realm {
+
+class SortedIndex : public SearchIndex {
+public:
+    SortedIndex(const ClusterColumn& target_column, Allocator&);
+    SortedIndex(ref_type, ArrayParent*, size_t ndx_in_parent, const ClusterColumn& target_column, Allocator&);
+
+    static bool type_supported(DataType type)
+    {
+        return type == type_Int || type == type_Bool || type == type_String || type == type_Timestamp ||
+               type == type_ObjectId || type == type_UUID || type == type_Mixed;
+    }
+
+    // SearchIndex API
+    void insert(ObjKey key, const Mixed& value) final;
+    void set(ObjKey key, const Mixed& new_value) final;
+    ObjKey find_first(const Mixed& value) const final;
+    void find_all(std::vector<ObjKey>& result, Mixed value, bool case_insensitive = false) const final;
+    FindRes find_all_no_copy(Mixed value, InternalFindResult& result) const final;
+    size_t count(const Mixed& value) const final;
+    void erase(ObjKey key) final;
+    void clear() final;
+    bool has_duplicate_values() const noexcept final;
+    bool is_empty() const final;
+    void insert_bulk(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values, ArrayPayload& values) final;
+    void insert_bulk_list(const ArrayUnsigned* keys, uint64_t key_offset, size_t num_values,
+                          ArrayInteger& ref_array) final;
+    void verify() const final;
+    void refresh_accessor_tree(const ClusterColumn& target_column) final;
+    void update_from_parent() noexcept final;
+
+#ifdef REALM_DEBUG
+    void print() const final;
+#endif // REALM_DEBUG
+
+    // Ordered access
+    size_t size() const noexcept
+    {
+        return m_keys.size();
+    }
+    ObjKey get_key(size_t ndx) const
+    {
+        return ObjKey(m_keys.get(ndx));
+    }
+    Mixed get_value(size_t ndx) const
+    {
+        return m_values.get(ndx);
+    }
+    // Position of the first entry with a value not less than / greater than `value`
+    size_t lower_bound(const Mixed& value) const;
+    size_t upper_bound(const Mixed& value) const;
+
+    // Positions [begin, end) of the entries matching the condition, which is
+    // one of Greater, GreaterEqual, Less and LessEqual. Null never matches.
+    template <class Cond>
+    std::pair<size_t, size_t> find_range(const Mixed& value) const;
+
+    // Appends the keys of the entries in [begin, end)
+    void get_keys(size_t begin, size_t end, std::vector<ObjKey>& keys) const;
+
+    // Calls `func` with the keys of the objects in the order of their values,
+    // descending if `ascending` is false, until it returns false. Objects
+    // with the same value come in key order either way.
+    void for_each_in_order(bool ascending, util::FunctionRef<bool(ObjKey)> func) const;
+
+private:
+    Array m_top;
+    BPlusTree<Mixed> m_values;
+    IntegerColumn m_keys;
+
+    void init_trees();
+    // Position of the entry of `key`, given that it holds `value`
+    size_t find_entry(ObjKey key, const Mixed& value) const;
+    // Position where an entry for `key` holding `value` belongs
+    size_t insert_position(ObjKey key, const Mixed& value) const;
+};
+
+template <class Cond>
+std::pair<size_t, size_t> SortedIndex::find_range(const Mixed& value) const
+{
+    static_assert(realm::is_any_v<Cond, Greater, GreaterEqual, Less, LessEqual>);
+    if (value.is_null())
+        return {0, 0};
+    if constexpr (std::is_same_v<Cond, Greater>)
+        return {upper_bound(value), size()};
+    else if constexpr (std::is_same_v<Cond, GreaterEqual>)
+        return {lower_bound(value), size()};
+    else if constexpr (std::is_same_v<Cond, Less>)
+        return {upper_bound(Mixed()), lower_bound(value)};
+    else
+        return {upper_bound(Mixed()), upper_bound(value)};
+}
+
+} // namespace realm
+
+#endif // REALM_INDEX_SORTED_HPP
@@ -52,6 +52,7 @@ public:
         wtype_Bits = 0,     // width indicates how many bits every element occupies
         wtype_Multiply = 1, // width indicates how many bytes every element occupies
         wtype_Ignore = 2,   // each element is 1 byte
+        wtype_Offset = 3,   // width indicates how many bits every offset from the base value occupies
     };
 
     static const int header_size = 8; // Number of bytes used by header
@@ -132,6 +133,29 @@ public:
         return type_Normal;
     }
 
+    /// Position of the base value (relative to the start of the payload) in a
+    /// node using wtype_Offset. The base value, which is also the smallest
+    /// value in the node, is stored as a 64-bit integer immediately after the
+    /// 8-byte aligned bit-packed offsets. It is followed by the largest value.
+    static size_t get_base_pos(size_t size, uint_least8_t width) noexcept
+    {
+        return ((size * width + 63) >> 6) << 3;
+    }
+
+    static int64_t get_base_from_header(const char* header) noexcept
+    {
+        const char* data = get_data_from_header(header);
+        size_t pos = get_base_pos(get_size_from_header(header), get_width_from_header(header));
+        return *reinterpret_cast<const int64_t*>(data + pos);
+    }
+
+    static int64_t get_max_from_header(const char* header) noexcept
+    {
+        const char* data = get_data_from_header(header);
+        size_t pos = get_base_pos(get_size_from_header(header), get_width_from_header(header)) + 8;
+        return *reinterpret_cast<const int64_t*>(data + pos);
+    }
+
     static void set_is_inner_bptree_node_in_header(bool value, char* header) noexcept
     {
         typedef unsigned char uchar;
@@ -159,6 +183,7 @@ public:
         // 0: bits      (width/8) * size
         // 1: multiply  width * size
         // 2: ignore    1 * size
+        // 3: offset    (width/8) * size, rounded up to 8 bytes, plus 16 for the smallest and largest value
         typedef unsigned char uchar;
         uchar* h = reinterpret_cast<uchar*>(header);
         h[4] = uchar((int(h[4]) & ~0x18) | int(value) << 3);
@@ -228,6 +253,11 @@ public:
             case wtype_Ignore:
                 num_bytes = size;
                 break;
+            case wtype_Offset: {
+                REALM_ASSERT_3(size, <, 0x1000000);
+                num_bytes = get_base_pos(size, width) + 16;
+                break;
+            }
         }
 
         // Ensure 8-byte alignment
@@ -552,6 +552,8 @@ int64_t Obj::_get<int64_t>(ColKey::Idx col_ndx) const
 
     ref_type ref = to_ref(Array::get(m_mem.get_addr(), col_ndx.val + 1));
     char* header = alloc.translate(ref);
+    if (REALM_UNLIKELY(Array::get_wtype_from_header(header) == Array::wtype_Offset))
+        return Array::get(header, m_row_ndx);
     int width = Array::get_width_from_header(header);
     char* data = Array::get_data_from_header(header);
     REALM_TEMPEX(return get_direct, width, (data, m_row_ndx));
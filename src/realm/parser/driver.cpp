@@ -31,7 +31,9 @@
 #include "realm/parser/generated/query_flex.hpp"
 
 #include <external/mpark/variant.hpp>
+#include <list>
 #include <stdexcept>
+#include <unordered_map>
 
 using namespace realm;
 using namespace std::string_literals;
@@ -280,6 +282,88 @@ Timestamp get_timestamp_if_valid(int64_t seconds, int32_t nanoseconds)
     throw SyntaxError("Invalid timestamp format");
 }
 
+// The column of the base table which `expr` reads directly, if any
+ColKey plain_column(const Subexpr* expr)
+{
+    auto prop = dynamic_cast<const ObjPropertyBase*>(expr);
+    if (prop && !prop->links_exist() && !prop->has_path() && !prop->column_key().is_collection())
+        return prop->column_key();
+    return {};
+}
+
+// Whether two columns of the base table can be compared object by object by
+// a TwoColumnsNode, which gives the same result as comparing them through
+// Compare
+bool is_column_pair(ColKey col_key1, ColKey col_key2)
+{
+    if (!col_key1 || !col_key2 || col_key1.get_type() != col_key2.get_type())
+        return false;
+    return col_key1.get_type() != col_type_Mixed && col_key1.get_type() != col_type_Link;
+}
+
+// The comparison which gives the same result with the operands swapped
+CompareType mirror(CompareType op)
+{
+    switch (op) {
+        case CompareType::GREATER:
+            return CompareType::LESS;
+        case CompareType::LESS:
+            return CompareType::GREATER;
+        case CompareType::GREATER_EQUAL:
+            return CompareType::LESS_EQUAL;
+        case CompareType::LESS_EQUAL:
+            return CompareType::GREATER_EQUAL;
+        default:
+            return op;
+    }
+}
+
+// The parse trees of the query strings run most recently. A tree is only
+// cached if it does not hold the values of any arguments, and does not depend
+// on the table either, so the strings are the only keys.
+class ParsedQueryCache {
+public:
+    static ParsedQueryCache& get()
+    {
+        static ParsedQueryCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<query_parser::ParsedQuery> find(const std::string& query_string)
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_index.find(query_string);
+        if (it == m_index.end())
+            return nullptr;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+
+    void add(const std::string& query_string, std::shared_ptr<query_parser::ParsedQuery> parsed)
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_index.find(query_string); it != m_index.end()) {
+            it->second->second = std::move(parsed);
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+        m_entries.emplace_front(query_string, std::move(parsed));
+        m_index.emplace(m_entries.front().first, m_entries.begin());
+        if (m_entries.size() > s_max_entries) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+private:
+    static constexpr size_t s_max_entries = 64;
+
+    using Entry = std::pair<std::string, std::shared_ptr<query_parser::ParsedQuery>>;
+    std::mutex m_mutex;
+    std::list<Entry> m_entries; // Most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+};
+
 } // namespace
 
 namespace realm {
@@ -529,6 +613,15 @@ Query EqualityNode::visit(ParserDriver* drv)
         }
     }
 
+    if (op != CompareType::IN && left->has_single_value() && left_type == right_type && plain_column(right.get())) {
+        // Compare the column with the constant instead, which has a node of its own
+        std::swap(left, right);
+    }
+    if (case_sensitive && op != CompareType::IN &&
+        is_column_pair(plain_column(left.get()), plain_column(right.get()))) {
+        return drv->column_pair_query(op, plain_column(left.get()), plain_column(right.get()));
+    }
+
     if (left_type == type_Link && left_type == right_type && right->has_constant_evaluation()) {
         if (auto link_column = dynamic_cast<const Columns<Link>*>(left.get())) {
             if (link_column->link_map().get_nb_hops() == 1 &&
@@ -691,44 +784,54 @@ Query RelationalNode::visit(ParserDriver* drv)
                                              get_data_type_name(left_type), get_data_type_name(right_type)));
     }
 
+    CompareType cmp_op = op;
+    if (left->has_single_value() && !left_type_is_null && left_type == right_type && plain_column(right.get())) {
+        // Compare the column with the constant instead, which has a node of its own
+        std::swap(left, right);
+        cmp_op = mirror(op);
+    }
+    if (is_column_pair(plain_column(left.get()), plain_column(right.get()))) {
+        return drv->column_pair_query(cmp_op, plain_column(left.get()), plain_column(right.get()));
+    }
+
     const ObjPropertyBase* prop = dynamic_cast<const ObjPropertyBase*>(left.get());
     if (prop && !prop->links_exist() && !prop->has_path() && right->has_single_value() &&
         (left_type == right_type || left_type == type_Mixed)) {
         auto col_key = prop->column_key();
         switch (left->get_type()) {
             case type_Int:
-                return drv->simple_query(op, col_key, right->get_mixed().get_int());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get_int());
             case type_Bool:
                 break;
             case type_String:
-                return drv->simple_query(op, col_key, right->get_mixed().get_string());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get_string());
             case type_Binary:
                 break;
             case type_Timestamp:
-                return drv->simple_query(op, col_key, right->get_mixed().get<Timestamp>());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get<Timestamp>());
             case type_Float:
-                return drv->simple_query(op, col_key, right->get_mixed().get_float());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get_float());
                 break;
             case type_Double:
-                return drv->simple_query(op, col_key, right->get_mixed().get_double());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get_double());
                 break;
             case type_Decimal:
-                return drv->simple_query(op, col_key, right->get_mixed().get<Decimal128>());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get<Decimal128>());
                 break;
             case type_ObjectId:
-                return drv->simple_query(op, col_key, right->get_mixed().get<ObjectId>());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get<ObjectId>());
                 break;
             case type_UUID:
-                return drv->simple_query(op, col_key, right->get_mixed().get<UUID>());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed().get<UUID>());
                 break;
             case type_Mixed:
-                return drv->simple_query(op, col_key, right->get_mixed());
+                return drv->simple_query(cmp_op, col_key, right->get_mixed());
                 break;
             default:
                 break;
         }
     }
-    switch (op) {
+    switch (cmp_op) {
         case CompareType::GREATER:
             return Query(std::unique_ptr<Expression>(new Compare<Greater>(std::move(left), std::move(right))));
         case CompareType::LESS:
@@ -950,27 +1053,30 @@ Query TrueOrFalseNode::visit(ParserDriver* drv)
 
 std::unique_ptr<Subexpr> PropertyNode::visit(ParserDriver* drv, DataType)
 {
-    path->resolve_arg(drv);
-    if (path->path_elems.back().is_key() && path->path_elems.back().get_key() == "@links") {
+    // The elements of the path are consumed below, so a parse tree which is
+    // run again must keep its own
+    PathNode path_node(*path);
+    path_node.resolve_arg(drv);
+    if (path_node.path_elems.back().is_key() && path_node.path_elems.back().get_key() == "@links") {
         identifier = "@links";
         // This is a backlink aggregate query
-        path->path_elems.pop_back();
-        auto link_chain = path->visit(drv, comp_type);
+        path_node.path_elems.pop_back();
+        auto link_chain = path_node.visit(drv, comp_type);
         auto sub = link_chain.get_backlink_count<Int>();
         return sub.clone();
     }
-    m_link_chain = path->visit(drv, comp_type);
-    if (!path->at_end()) {
-        if (!path->current_path_elem->is_key()) {
-            throw InvalidQueryError(util::format("[%1] not expected", *path->current_path_elem));
+    m_link_chain = path_node.visit(drv, comp_type);
+    if (!path_node.at_end()) {
+        if (!path_node.current_path_elem->is_key()) {
+            throw InvalidQueryError(util::format("[%1] not expected", *path_node.current_path_elem));
         }
-        identifier = path->current_path_elem->get_key();
+        identifier = path_node.current_path_elem->get_key();
     }
-    std::unique_ptr<Subexpr> subexpr{drv->column(m_link_chain, path)};
+    std::unique_ptr<Subexpr> subexpr{drv->column(m_link_chain, &path_node)};
 
     Path indexes;
-    while (!path->at_end()) {
-        indexes.emplace_back(std::move(*(path->current_path_elem++)));
+    while (!path_node.at_end()) {
+        indexes.emplace_back(std::move(*(path_node.current_path_elem++)));
     }
 
     if (!indexes.empty()) {
@@ -1016,9 +1122,9 @@ std::unique_ptr<Subexpr> PropertyNode::visit(ParserDriver* drv, DataType)
                 if (!post_op && is_length_suffix(trailing)) {
                     // If 'length' is the operator, the last id in the path must be the name
                     // of a list property
-                    path->path_elems.pop_back();
-                    const std::string& prop = path->path_elems.back().get_key();
-                    std::unique_ptr<Subexpr> subexpr{path->visit(drv, comp_type).column(prop, false)};
+                    path_node.path_elems.pop_back();
+                    const std::string& prop = path_node.path_elems.back().get_key();
+                    std::unique_ptr<Subexpr> subexpr{path_node.visit(drv, comp_type).column(prop, false)};
                     if (auto list = dynamic_cast<ColumnListBase*>(subexpr.get())) {
                         if (auto length_expr = list->get_element_length())
                             return length_expr;
@@ -1138,8 +1244,7 @@ std::unique_ptr<Subexpr> LinkAggrNode::visit(ParserDriver* drv, DataType)
                                              agg_op_type_to_str(type), property->get_identifier()));
     }
     const LinkChain& link_chain = property->link_chain();
-    prop_name = drv->translate(link_chain, prop_name);
-    auto col_key = link_chain.get_current_table()->get_column_key(prop_name);
+    auto col_key = link_chain.get_current_table()->get_column_key(drv->translate(link_chain, prop_name));
 
     switch (col_key.get_type()) {
         case col_type_Int:
@@ -1840,6 +1945,7 @@ PathElement ParserDriver::get_arg_for_index(const std::string& i)
 {
     REALM_ASSERT(i[0] == '$');
     size_t arg_no = size_t(strtol(i.substr(1).c_str(), nullptr, 10));
+    m_args_in_parse_tree = true;
     if (m_args.is_argument_null(arg_no) || m_args.is_argument_list(arg_no)) {
         throw InvalidQueryError("Invalid index parameter");
     }
@@ -1874,6 +1980,7 @@ double ParserDriver::get_arg_for_coordinate(const std::string& str)
 {
     REALM_ASSERT(str[0] == '$');
     size_t arg_no = size_t(strtol(str.substr(1).c_str(), nullptr, 10));
+    m_args_in_parse_tree = true;
     if (m_args.is_argument_null(arg_no)) {
         throw InvalidQueryError(util::format("NULL cannot be used in coordinate at argument '%1'", str));
     }
@@ -1895,6 +2002,27 @@ double ParserDriver::get_arg_for_coordinate(const std::string& str)
     }
 }
 
+Query ParserDriver::column_pair_query(CompareType op, ColKey col_key1, ColKey col_key2)
+{
+    switch (op) {
+        case CompareType::EQUAL:
+            return m_base_table->where().equal(col_key1, col_key2);
+        case CompareType::NOT_EQUAL:
+            return m_base_table->where().not_equal(col_key1, col_key2);
+        case CompareType::GREATER:
+            return m_base_table->where().greater(col_key1, col_key2);
+        case CompareType::LESS:
+            return m_base_table->where().less(col_key1, col_key2);
+        case CompareType::GREATER_EQUAL:
+            return m_base_table->where().greater_equal(col_key1, col_key2);
+        case CompareType::LESS_EQUAL:
+            return m_base_table->where().less_equal(col_key1, col_key2);
+        default:
+            break;
+    }
+    REALM_UNREACHABLE();
+}
+
 auto ParserDriver::cmp(const std::vector<ExpressionNode*>& values) -> std::pair<SubexprPtr, SubexprPtr>
 {
     SubexprPtr left;
@@ -1986,12 +2114,34 @@ int ParserDriver::parse(const std::string& str)
     return res;
 }
 
+std::shared_ptr<ParsedQuery> ParserDriver::parse_query(const std::string& str)
+{
+    parse(str);
+    result->canonicalize();
+    auto parsed = std::make_shared<ParsedQuery>();
+    parsed->nodes = std::move(m_parse_nodes);
+    parsed->result = result;
+    parsed->ordering = ordering;
+    return parsed;
+}
+
+Query ParserDriver::visit(ParsedQuery& parsed)
+{
+    return parsed.result->visit(this).set_ordering(parsed.ordering->visit(this));
+}
+
 void parse(const std::string& str)
 {
     ParserDriver driver;
     driver.parse(str);
 }
 
+PreparedQuery::PreparedQuery(const std::string& query_string)
+{
+    ParserDriver driver;
+    m_parsed = driver.parse_query(query_string);
+}
+
 std::string check_escapes(const char* str)
 {
     std::string ret;
@@ -2047,11 +2197,33 @@ Query Table::query(const std::string& query_string, const std::vector<MixedArgum
 
 Query Table::query(const std::string& query_string, query_parser::Arguments& args,
                    const query_parser::KeyPathMapping& mapping) const
+{
+    auto& cache = ParsedQueryCache::get();
+    ParserDriver driver(m_own_ref, args, mapping);
+    if (auto parsed = cache.find(query_string)) {
+        // If another thread is running the same string, it is parsed again
+        if (std::unique_lock lock{parsed->mutex, std::try_to_lock})
+            return driver.visit(*parsed);
+    }
+    auto parsed = driver.parse_query(query_string);
+    Query q = driver.visit(*parsed);
+    if (!driver.m_args_in_parse_tree)
+        cache.add(query_string, std::move(parsed));
+    return q;
+}
+
+Query Table::query(const query_parser::PreparedQuery& prepared, const std::vector<Mixed>& arguments) const
+{
+    MixedArguments args(arguments);
+    return query(prepared, args, {});
+}
+
+Query Table::query(const query_parser::PreparedQuery& prepared, query_parser::Arguments& args,
+                   const query_parser::KeyPathMapping& mapping) const
 {
     ParserDriver driver(m_own_ref, args, mapping);
-    driver.parse(query_string);
-    driver.result->canonicalize();
-    return driver.result->visit(&driver).set_ordering(driver.ordering->visit(&driver));
+    std::lock_guard lock(prepared.m_parsed->mutex);
+    return driver.visit(*prepared.m_parsed);
 }
 
 std::unique_ptr<Subexpr> LinkChain::column(const std::string& col, bool has_path)
@@ -2,6 +2,7 @@
 #define DRIVER_HH
 #include <string>
 #include <map>
+#include <mutex>
 
 #include "realm/query_expression.hpp"
 #include "realm/parser/keypath_mapping.hpp"
@@ -658,8 +659,14 @@ public:
     ParserNodeStore m_parse_nodes;
     void* m_yyscanner;
 
+    // Set if the values of arguments have been built into the parse tree
+    bool m_args_in_parse_tree = false;
+
     // Run the parser on file F.  Return 0 on success.
     int parse(const std::string& str);
+    // Parse and canonicalize `str`, handing over the resulting tree
+    std::shared_ptr<ParsedQuery> parse_query(const std::string& str);
+    Query visit(ParsedQuery&);
 
     // Handling the scanner.
     void scan_begin(void*, bool trace_scanning);
@@ -678,6 +685,7 @@ public:
     Query simple_query(CompareType op, ColKey col_key, T val, bool case_sensitive);
     template <class T>
     Query simple_query(CompareType op, ColKey col_key, T val);
+    Query column_pair_query(CompareType op, ColKey col_key1, ColKey col_key2);
     std::pair<SubexprPtr, SubexprPtr> cmp(const std::vector<ExpressionNode*>& values);
     SubexprPtr column(LinkChain&, PathNode*);
     void backlink(LinkChain&, std::string_view table_name, std::string_view column_name);
@@ -694,6 +702,16 @@ private:
     static query_parser::KeyPathMapping s_default_mapping;
 };
 
+// The parse tree of a query string. It does not depend on the table or the
+// arguments it is run with, but the nodes keep state while being visited, so it
+// can only be used by one driver at a time.
+struct ParsedQuery {
+    ParserDriver::ParserNodeStore nodes;
+    QueryNode* result = nullptr;
+    DescriptorOrderingNode* ordering = nullptr;
+    std::mutex mutex;
+};
+
 template <class T>
 Query ParserDriver::simple_query(CompareType op, ColKey col_key, T val, bool case_sensitive)
 {
@@ -29,6 +29,12 @@
 #include <realm/util/any.hpp>
 #include <realm/mixed.hpp>
 
+#include <memory>
+
+namespace realm {
+class Table;
+}
+
 namespace realm::query_parser {
 
 struct AnyContext {
@@ -341,6 +347,22 @@ public:
 
 void parse(const std::string&);
 
+struct ParsedQuery;
+
+// A query string which is parsed once and can then be run any number of times
+// through Table::query(), on any table and with different arguments. The names
+// in it are resolved each time it is run. Arguments used as list indexes or as
+// geospatial coordinates are not supported, as the string cannot be parsed
+// without their values.
+class PreparedQuery {
+public:
+    explicit PreparedQuery(const std::string& query_string);
+
+private:
+    friend class realm::Table;
+    std::shared_ptr<ParsedQuery> m_parsed;
+};
+
 } // namespace realm::query_parser
 
 
@@ -22,13 +22,17 @@
 #include <realm/array_integer_tpl.hpp>
 #include <realm/transaction.hpp>
 #include <realm/dictionary.hpp>
+#include <realm/query_cache.hpp>
 #include <realm/query_conditions_tpl.hpp>
 #include <realm/query_engine.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/table_view.hpp>
 #include <realm/set.hpp>
+#include <realm/util/worker_pool.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 
 using namespace realm;
 
@@ -87,6 +91,8 @@ Query::Query(const Query& source)
     , m_groups(source.m_groups)
     , m_table(source.m_table)
     , m_ordering(source.m_ordering)
+    , m_prefetch_clusters(source.m_prefetch_clusters)
+    , m_threads(source.m_threads)
 {
     if (source.m_owned_source_table_view) {
         m_owned_source_table_view = source.m_owned_source_table_view->clone();
@@ -133,6 +139,8 @@ Query& Query::operator=(const Query& source)
             m_view = m_source_collection.get();
         }
         m_ordering = source.m_ordering;
+        m_prefetch_clusters = source.m_prefetch_clusters;
+        m_threads = source.m_threads;
     }
     return *this;
 }
@@ -158,6 +166,8 @@ Query::Query(const Query* source, Transaction* tr, PayloadPolicy policy)
         REALM_ASSERT_DEBUG(m_view);
     }
     m_groups = source->m_groups;
+    m_prefetch_clusters = source->m_prefetch_clusters;
+    m_threads = source->m_threads;
     if (source->m_table)
         set_table(tr->import_copy_of(source->m_table));
     // otherwise: empty query.
@@ -191,6 +201,79 @@ void Query::set_table(TableRef tr)
 }
 
 
+bool Query::prefetch_clusters_enabled() const
+{
+    return m_prefetch_clusters.value_or(m_table.unchecked_ptr()->get_alloc().get_prefetch_clusters());
+}
+
+namespace {
+
+// The table is split into a few parts per thread, so that threads which are done
+// with their parts early can take over parts that would otherwise be left to
+// the slower ones.
+constexpr size_t s_parts_per_thread = 4;
+
+} // anonymous namespace
+
+// Calls 'visit' for every cluster of the table, on several threads if possible.
+// Each thread gets its own copy of the conditions. 'prepare' is called with the
+// number of parts the table is split into before any cluster is visited, and
+// the clusters of a part are visited on one thread in key order. Returns false,
+// without calling anything, if the query must be run on the calling thread.
+bool Query::traverse_clusters_in_parallel(util::FunctionRef<void(size_t)> prepare, ParallelVisitor visit) const
+{
+    if (m_threads == 1 || m_view || !m_table->is_frozen())
+        return false;
+
+    auto& pool = util::WorkerPool::get_default();
+    unsigned threads = pool.get_num_threads() + 1;
+    if (m_threads != 0)
+        threads = std::min(threads, m_threads);
+    if (threads < 2)
+        return false;
+
+    const ClusterTree& clusters = m_table.unchecked_ptr()->m_clusters;
+    auto parts = clusters.split(threads * s_parts_per_thread);
+    if (parts.size() < 2)
+        return false;
+    threads = unsigned(std::min<size_t>(threads, parts.size()));
+
+    // The conditions are cloned up front, as the nodes are not safe to copy concurrently
+    std::vector<std::unique_ptr<ParentNode>> nodes(threads);
+    if (has_conditions()) {
+        for (auto& node : nodes)
+            node = root_node()->clone();
+    }
+
+    prepare(parts.size());
+    bool prefetch = prefetch_clusters_enabled();
+    std::atomic<size_t> next_part = 0;
+    pool.run(
+        threads,
+        [&](size_t thread) {
+            ParentNode* node = nodes[thread].get();
+            if (node) {
+                node->init(true);
+                std::vector<ParentNode*> vec;
+                node->gather_children(vec);
+                node->estimate_costs(m_table.unchecked_ptr()->size());
+            }
+            for (size_t part = next_part++; part < parts.size(); part = next_part++) {
+                clusters.traverse(
+                    parts[part],
+                    [&](const Cluster* cluster) {
+                        if (node)
+                            node->set_cluster(cluster);
+                        visit(node, cluster, part);
+                        return IteratorControl::AdvanceToNext;
+                    },
+                    prefetch);
+            }
+        },
+        threads);
+    return true;
+}
+
 void Query::add_expression_node(std::unique_ptr<Expression> expression)
 {
     add_node(std::unique_ptr<ParentNode>(new ExpressionNode(std::move(expression))));
@@ -1108,7 +1191,8 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key) const
 
     if (!has_conditions() && !m_view) {
         // use table aggregate
-        m_table.unchecked_ptr()->aggregate<T>(st, column_key);
+        if (!aggregate_in_parallel<T>(st, column_key))
+            m_table.unchecked_ptr()->aggregate<T>(st, column_key);
     }
     else {
 
@@ -1133,7 +1217,7 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key) const
                     }
                 }
             }
-            else {
+            else if (!aggregate_in_parallel<T>(st, column_key)) {
                 // no index, traverse cluster tree
                 node = pn;
                 LeafType leaf(m_table.unchecked_ptr()->get_alloc());
@@ -1148,7 +1232,7 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key) const
                     return IteratorControl::AdvanceToNext;
                 };
 
-                m_table.unchecked_ptr()->traverse_clusters(f);
+                m_table.unchecked_ptr()->traverse_clusters(f, prefetch_clusters_enabled());
             }
         }
         else {
@@ -1163,6 +1247,48 @@ void Query::aggregate(QueryStateBase& st, ColKey column_key) const
     }
 }
 
+template <typename T>
+bool Query::aggregate_in_parallel(QueryStateBase& st, ColKey column_key) const
+{
+    using LeafType = typename ColumnTypeTraits<T>::cluster_leaf_type;
+
+    auto first = st.make_partial();
+    if (!first)
+        return false;
+
+    std::vector<std::unique_ptr<QueryStateBase>> states;
+    auto prepare = [&](size_t num_parts) {
+        states.resize(num_parts);
+        states[0] = std::move(first);
+        for (size_t i = 1; i < num_parts; ++i)
+            states[i] = st.make_partial();
+    };
+    auto visit = [&](ParentNode* node, const Cluster* cluster, size_t part) {
+        QueryStateBase& partial = *states[part];
+        LeafType leaf(m_table.unchecked_ptr()->get_alloc());
+        size_t e = cluster->node_size();
+        cluster->init_leaf(column_key, &leaf);
+        partial.m_key_offset = cluster->get_offset();
+        partial.m_key_values = cluster->get_key_array();
+        if (node) {
+            aggregate_internal(node, &partial, 0, e, &leaf);
+        }
+        else {
+            partial.set_payload_column(&leaf);
+            if (!partial.match_range(0, e)) {
+                for (size_t i = 0; i < e; ++i)
+                    partial.match(i);
+            }
+        }
+    };
+    if (!traverse_clusters_in_parallel(prepare, visit))
+        return false;
+
+    for (auto& partial : states)
+        st.merge(*partial);
+    return true;
+}
+
 size_t Query::find_best_node(ParentNode* pn) const
 {
     auto score_compare = [](const ParentNode* a, const ParentNode* b) {
@@ -1197,14 +1323,23 @@ void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start,
     // statistics.
     constexpr size_t probe_matches = 4;
 
+    if (!pn->cluster_may_match())
+        return;
+
     while (start < end) {
         // Executes start...end range of a query and will stay inside the condition loop of the node it was called
         // on. Can be called on any node; yields same result, but different performance. Returns prematurely if
         // condition of called node has evaluated to true local_matches number of times.
         // Return value is the next row for resuming aggregating (next row that caller must call aggregate_local on)
         size_t best = find_best_node(pn);
-        start = pn->m_children[best]->aggregate_local(st, start, end, findlocals, source_column);
-        double current_cost = pn->m_children[best]->cost();
+        ParentNode* best_node = pn->m_children[best];
+        if (pn->m_children.size() == 1) {
+            start = best_node->aggregate_local(st, start, end, findlocals, source_column);
+            continue;
+        }
+        best_node->order_children();
+        start = best_node->aggregate_local_timed(st, start, end, findlocals, source_column);
+        double current_cost = best_node->cost();
 
         // Make remaining conditions compute their m_dD (statistics)
         for (size_t c = 0; c < pn->m_children.size() && start < end; c++) {
@@ -1212,12 +1347,12 @@ void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start,
                 continue;
 
             // Skip test if there is no way its cost can ever be better than best node's
-            if (pn->m_children[c]->m_dT < current_cost) {
+            if (pn->m_children[c]->time_per_object() < current_cost) {
 
                 // Limit to bestdist in order not to skip too large parts of index nodes
                 size_t maxD = pn->m_children[c]->m_dT == 0.0 ? end - start : bestdist;
                 size_t td = pn->m_children[c]->m_dT == 0.0 ? end : (start + maxD > end ? end : start + maxD);
-                start = pn->m_children[c]->aggregate_local(st, start, td, probe_matches, source_column);
+                start = pn->m_children[c]->aggregate_local_timed(st, start, td, probe_matches, source_column);
             }
         }
     }
@@ -1227,22 +1362,59 @@ void Query::aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start,
 
 std::optional<Mixed> Query::sum(ColKey col_key) const
 {
-    return AggregateHelper<Query>::sum(*m_table, *this, col_key);
+    return cached_aggregate("sum", col_key, nullptr, nullptr, [&](ObjKey*, size_t*) {
+        return AggregateHelper<Query>::sum(*m_table, *this, col_key);
+    });
 }
 
 std::optional<Mixed> Query::avg(ColKey col_key, size_t* value_count) const
 {
-    return AggregateHelper<Query>::avg(*m_table, *this, col_key, value_count);
+    return cached_aggregate("avg", col_key, nullptr, value_count, [&](ObjKey*, size_t* count) {
+        return AggregateHelper<Query>::avg(*m_table, *this, col_key, count);
+    });
 }
 
 std::optional<Mixed> Query::min(ColKey col_key, ObjKey* return_ndx) const
 {
-    return AggregateHelper<Query>::min(*m_table, *this, col_key, return_ndx);
+    return cached_aggregate("min", col_key, return_ndx, nullptr, [&](ObjKey* key, size_t*) {
+        return AggregateHelper<Query>::min(*m_table, *this, col_key, key);
+    });
 }
 
 std::optional<Mixed> Query::max(ColKey col_key, ObjKey* return_ndx) const
 {
-    return AggregateHelper<Query>::max(*m_table, *this, col_key, return_ndx);
+    return cached_aggregate("max", col_key, return_ndx, nullptr, [&](ObjKey* key, size_t*) {
+        return AggregateHelper<Query>::max(*m_table, *this, col_key, key);
+    });
+}
+
+std::optional<Mixed> Query::cached_aggregate(std::string_view what, ColKey col_key, ObjKey* return_key,
+                                             size_t* value_count,
+                                             util::FunctionRef<std::optional<Mixed>(ObjKey*, size_t*)> aggregate) const
+{
+    std::string key;
+    uint_fast64_t version;
+    QueryCache* cache = get_result_cache(util::format("%1 %2", what, col_key.value), key, version);
+    if (!cache)
+        return aggregate(return_key, value_count);
+
+    if (auto result = cache->get(key, version)) {
+        if (return_key)
+            *return_key = result->key;
+        if (value_count)
+            *value_count = result->count;
+        return result->value;
+    }
+    auto result = std::make_shared<QueryCache::Result>();
+    result->value = aggregate(&result->key, &result->count);
+    if (return_key)
+        *return_key = result->key;
+    if (value_count)
+        *value_count = result->count;
+    // A string refers to the file, which may not outlive the result
+    if (!result->value || !result->value->is_type(type_String, type_Binary))
+        cache->put(key, version, result);
+    return result->value;
 }
 
 // Grouping
@@ -1366,6 +1538,8 @@ ObjKey Query::find() const
             auto f = [&node, &key](const Cluster* cluster) {
                 size_t end = cluster->node_size();
                 node->set_cluster(cluster);
+                if (!node->cluster_may_match())
+                    return IteratorControl::AdvanceToNext;
                 size_t res = node->find_first(0, end);
                 if (res != not_found) {
                     key = cluster->get_real_key(res);
@@ -1375,7 +1549,7 @@ ObjKey Query::find() const
                 return IteratorControl::AdvanceToNext;
             };
 
-            m_table->traverse_clusters(f);
+            m_table->traverse_clusters(f, prefetch_clusters_enabled());
             ret = key;
         }
     }
@@ -1389,6 +1563,34 @@ ObjKey Query::find() const
     return ret;
 }
 
+bool Query::find_all_in_parallel(QueryStateBase& st) const
+{
+    if (st.limit() != size_t(-1))
+        return false;
+
+    std::vector<std::vector<ObjKey>> keys;
+    auto prepare = [&](size_t num_parts) {
+        keys.resize(num_parts);
+    };
+    auto visit = [&](ParentNode* node, const Cluster* cluster, size_t part) {
+        QueryStateFindAll<std::vector<ObjKey>> partial(keys[part]);
+        partial.m_key_offset = cluster->get_offset();
+        partial.m_key_values = cluster->get_key_array();
+        aggregate_internal(node, &partial, 0, cluster->node_size(), nullptr);
+    };
+    if (!traverse_clusters_in_parallel(prepare, visit))
+        return false;
+
+    st.m_key_values = nullptr;
+    for (auto& part : keys) {
+        for (auto key : part) {
+            st.m_key_offset = key.value;
+            st.match(0, Mixed());
+        }
+    }
+    return true;
+}
+
 void Query::do_find_all(QueryStateBase& st) const
 {
     auto logger = m_table->get_logger();
@@ -1438,7 +1640,7 @@ void Query::do_find_all(QueryStateBase& st) const
                 return IteratorControl::AdvanceToNext;
             };
 
-            m_table->traverse_clusters(f);
+            m_table->traverse_clusters(f, prefetch_clusters_enabled());
         }
         else {
             auto pn = root_node();
@@ -1468,7 +1670,7 @@ void Query::do_find_all(QueryStateBase& st) const
                     }
                 }
             }
-            else {
+            else if (!find_all_in_parallel(st)) {
                 // no index on best node (and likely no index at all), descend B+-tree
                 node = pn;
 
@@ -1482,7 +1684,7 @@ void Query::do_find_all(QueryStateBase& st) const
                     return st.match_count() == st.limit() ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
                 };
 
-                m_table->traverse_clusters(f);
+                m_table->traverse_clusters(f, prefetch_clusters_enabled());
             }
         }
     }
@@ -1509,6 +1711,28 @@ TableView Query::find_all(size_t limit) const
 }
 
 
+bool Query::count_in_parallel(size_t& count) const
+{
+    std::vector<size_t> counts;
+    auto prepare = [&](size_t num_parts) {
+        counts.resize(num_parts);
+    };
+    auto visit = [&](ParentNode* node, const Cluster* cluster, size_t part) {
+        QueryStateCount partial;
+        partial.m_key_offset = cluster->get_offset();
+        partial.m_key_values = cluster->get_key_array();
+        aggregate_internal(node, &partial, 0, cluster->node_size(), nullptr);
+        counts[part] += partial.get_count();
+    };
+    if (!traverse_clusters_in_parallel(prepare, visit))
+        return false;
+
+    count = 0;
+    for (auto c : counts)
+        count += c;
+    return true;
+}
+
 size_t Query::do_count(size_t limit) const
 {
     auto logger = m_table->get_logger();
@@ -1582,7 +1806,7 @@ size_t Query::do_count(size_t limit) const
                 cnt = std::min(limit, sz);
             }
         }
-        else {
+        else if (limit != size_t(-1) || !count_in_parallel(cnt)) {
             // no index, descend down the B+-tree instead
             node = pn;
             QueryStateCount st(limit);
@@ -1597,7 +1821,7 @@ size_t Query::do_count(size_t limit) const
                 return st.match_count() == st.limit() ? IteratorControl::Stop : IteratorControl::AdvanceToNext;
             };
 
-            m_table->traverse_clusters(f);
+            m_table->traverse_clusters(f, prefetch_clusters_enabled());
 
             cnt = st.get_count();
         }
@@ -1616,7 +1840,18 @@ size_t Query::count() const
 {
     if (!m_table)
         return 0;
-    return do_count();
+
+    std::string key;
+    uint_fast64_t version;
+    QueryCache* cache = get_result_cache("count", key, version);
+    if (!cache)
+        return do_count();
+    if (auto result = cache->get(key, version))
+        return result->count;
+    auto result = std::make_shared<QueryCache::Result>();
+    result->count = do_count();
+    cache->put(key, version, result);
+    return result->count;
 }
 
 TableView Query::find_all(const DescriptorOrdering& descriptor) const
@@ -1681,136 +1916,6 @@ size_t Query::remove() const
     return rows;
 }
 
-#if REALM_MULTITHREAD_QUERY
-TableView Query::find_all_multi(size_t start, size_t end)
-{
-    static_cast<void>(start);
-    static_cast<void>(end);
-
-    // Initialization
-    init();
-    ts.next_job = start;
-    ts.end_job = end;
-    ts.done_job = 0;
-    ts.count = 0;
-    ts.table = &table;
-    ts.node = first[0];
-
-    // Signal all threads to start
-    pthread_mutex_unlock(&ts.jobs_mutex);
-    pthread_cond_broadcast(&ts.jobs_cond);
-
-    // Wait until all threads have completed
-    pthread_mutex_lock(&ts.completed_mutex);
-    while (ts.done_job < ts.end_job)
-        pthread_cond_wait(&ts.completed_cond, &ts.completed_mutex);
-    pthread_mutex_lock(&ts.jobs_mutex);
-    pthread_mutex_unlock(&ts.completed_mutex);
-
-    TableView tv(*m_table);
-
-    // Sort search results because user expects ascending order
-    sort(ts.chunks.begin(), ts.chunks.end(), &Query::comp);
-    for (size_t i = 0; i < ts.chunks.size(); ++i) {
-        const size_t from = ts.chunks[i].m_root_node;
-        const size_t upto = (i == ts.chunks.size() - 1) ? size_t(-1) : ts.chunks[i + 1].m_root_node;
-        size_t first = ts.chunks[i].second;
-
-        while (first < ts.results.size() && ts.results[first] < upto && ts.results[first] >= from) {
-            tv.get_ref_column().add(ts.results[first]);
-            ++first;
-        }
-    }
-
-    return move(tv);
-}
-
-int Query::set_threads(unsigned int threadcount)
-{
-#if defined(_WIN32) || defined(__WIN32__) || defined(_WIN64)
-    pthread_win32_process_attach_np();
-#endif
-    pthread_mutex_init(&ts.result_mutex, nullptr);
-    pthread_cond_init(&ts.completed_cond, nullptr);
-    pthread_mutex_init(&ts.jobs_mutex, nullptr);
-    pthread_mutex_init(&ts.completed_mutex, nullptr);
-    pthread_cond_init(&ts.jobs_cond, nullptr);
-
-    pthread_mutex_lock(&ts.jobs_mutex);
-
-    for (size_t i = 0; i < m_threadcount; ++i)
-        pthread_detach(threads[i]);
-
-    for (size_t i = 0; i < threadcount; ++i) {
-        int r = pthread_create(&threads[i], nullptr, query_thread, (void*)&ts);
-        if (r != 0)
-            REALM_ASSERT(false); // todo
-    }
-    m_threadcount = threadcount;
-    return 0;
-}
-
-
-void* Query::query_thread(void* arg)
-{
-    static_cast<void>(arg);
-    thread_state* ts = static_cast<thread_state*>(arg);
-
-    std::vector<size_t> res;
-    std::vector<pair<size_t, size_t>> chunks;
-
-    for (;;) {
-        // Main waiting loop that waits for a query to start
-        pthread_mutex_lock(&ts->jobs_mutex);
-        while (ts->next_job == ts->end_job)
-            pthread_cond_wait(&ts->jobs_cond, &ts->jobs_mutex);
-        pthread_mutex_unlock(&ts->jobs_mutex);
-
-        for (;;) {
-            // Pick a job
-            pthread_mutex_lock(&ts->jobs_mutex);
-            if (ts->next_job == ts->end_job)
-                break;
-            const size_t chunk = min(ts->end_job - ts->next_job, thread_chunk_size);
-            const size_t mine = ts->next_job;
-            ts->next_job += chunk;
-            size_t r = mine - 1;
-            const size_t end = mine + chunk;
-
-            pthread_mutex_unlock(&ts->jobs_mutex);
-
-            // Execute job
-            for (;;) {
-                r = ts->node->find_first(r + 1, end);
-                if (r == end)
-                    break;
-                res.push_back(r);
-            }
-
-            // Append result in common queue shared by all threads.
-            pthread_mutex_lock(&ts->result_mutex);
-            ts->done_job += chunk;
-            if (res.size() > 0) {
-                ts->chunks.push_back(std::pair<size_t, size_t>(mine, ts->results.size()));
-                ts->count += res.size();
-                for (size_t i = 0; i < res.size(); i++) {
-                    ts->results.push_back(res[i]);
-                }
-                res.clear();
-            }
-            pthread_mutex_unlock(&ts->result_mutex);
-
-            // Signal main thread that we might have compleeted
-            pthread_mutex_lock(&ts->completed_mutex);
-            pthread_cond_signal(&ts->completed_cond);
-            pthread_mutex_unlock(&ts->completed_mutex);
-        }
-    }
-    return 0;
-}
-
-#endif // REALM_MULTITHREADQUERY
-
 std::string Query::validate() const
 {
     if (!m_groups.size())
@@ -1856,6 +1961,42 @@ util::bind_ptr<DescriptorOrdering> Query::get_ordering()
     return std::move(m_ordering);
 }
 
+std::string Query::explain() const
+{
+    util::serializer::SerialisationState state(m_table->get_parent_group());
+    auto rounded = [](double d) {
+        return std::round(d * 100) / 100;
+    };
+    auto describe = [&](const char* step, ParentNode* node) {
+        return util::format("%1 %2 (cost %3, 1 match per %4 objects)\n", step, node->describe(state),
+                            rounded(node->cost()), rounded(node->m_dD));
+    };
+
+    init();
+    std::string plan;
+    ParentNode* pn = root_node();
+    if (m_view) {
+        plan = util::format("VIEW %1 element(s)\n", m_view->size());
+        if (pn) {
+            for (auto node : pn->m_children)
+                plan += describe("FILTER", node);
+        }
+    }
+    else if (pn) {
+        ParentNode* best_node = pn->m_children[find_best_node(pn)];
+        best_node->order_children();
+        plan = describe(best_node->index_based_keys() ? "INDEX" : "SCAN", best_node);
+        for (size_t c = 1; c < best_node->m_children.size(); ++c)
+            plan += describe("FILTER", best_node->m_children[c]);
+    }
+    else {
+        plan = "SCAN TRUEPREDICATE\n";
+    }
+    if (m_ordering)
+        plan += m_ordering->get_description(m_table) + "\n";
+    return plan;
+}
+
 std::string Query::get_description() const
 {
     util::serializer::SerialisationState state(m_table->get_parent_group());
@@ -1883,6 +2024,8 @@ void Query::init() const
         root->init(m_view == nullptr);
         std::vector<ParentNode*> vec;
         root->gather_children(vec);
+        if (!m_view)
+            root->estimate_costs(m_table.unchecked_ptr()->size());
     }
 }
 
@@ -2033,6 +2176,32 @@ void Query::get_outside_versions(TableVersions& versions) const
     }
 }
 
+QueryCache* Query::get_result_cache(std::string_view what, std::string& key, uint_fast64_t& version) const
+{
+    if (!m_table || m_view)
+        return nullptr;
+    auto tr = dynamic_cast<Transaction*>(m_table->get_parent_group());
+    if (!tr)
+        return nullptr;
+    // The contents of a write transaction are not those of any version
+    auto stage = tr->get_transact_stage();
+    if (stage != DB::transact_Reading && stage != DB::transact_Frozen)
+        return nullptr;
+    QueryCache* cache = tr->get_query_cache();
+    if (!cache)
+        return nullptr;
+
+    try {
+        key = util::format("%1 %2 %3", what, m_table->get_key().value, get_description());
+    }
+    catch (const std::exception&) {
+        // Not all queries can be described
+        return nullptr;
+    }
+    version = tr->get_version_of_current_transaction().version;
+    return cache;
+}
+
 TableVersions Query::sync_view_if_needed() const
 {
     if (m_view) {
@@ -26,14 +26,6 @@
 #include <string>
 #include <vector>
 
-#define REALM_MULTITHREAD_QUERY 0
-
-#if REALM_MULTITHREAD_QUERY
-// FIXME: Use our C++ thread abstraction API since it provides a much
-// higher level of encapsulation and safety.
-#include <pthread.h>
-#endif
-
 #include <realm/aggregate_ops.hpp>
 #include <realm/binary_data.hpp>
 #include <realm/column_type_traits.hpp>
@@ -41,6 +33,7 @@
 #include <realm/obj_list.hpp>
 #include <realm/table_ref.hpp>
 #include <realm/util/bind_ptr.hpp>
+#include <realm/util/function_ref.hpp>
 #include <realm/util/serializer.hpp>
 
 namespace realm {
@@ -48,10 +41,12 @@ namespace realm {
 
 // Pre-declarations
 class Array;
+class Cluster;
 class Expression;
 class Group;
 class LinkMap;
 class ParentNode;
+class QueryCache;
 class Table;
 class TableView;
 class Timestamp;
@@ -277,13 +272,6 @@ public:
     // Deletion
     size_t remove() const;
 
-#if REALM_MULTITHREAD_QUERY
-    // Multi-threading
-    TableView find_all_multi(size_t start = 0, size_t end = size_t(-1));
-    TableView find_all_multi(size_t start = 0, size_t end = size_t(-1)) const;
-    int set_threads(unsigned int threadcount);
-#endif
-
     const ConstTableRef& get_table() const noexcept
     {
         return m_table;
@@ -321,12 +309,37 @@ public:
     std::string validate() const;
 
     std::string get_description() const;
+    /// Describes how the query is evaluated: the condition driving the search
+    /// and whether it uses a search index, followed by the other conditions in
+    /// the order they are checked, each with its estimated cost and
+    /// selectivity. One step per line. Unlike get_description(), the result
+    /// cannot be parsed back into a query.
+    std::string explain() const;
     std::string get_description_safe() const noexcept;
 
     Query& set_ordering(util::bind_ptr<DescriptorOrdering> ordering);
     // This will remove the ordering from the Query object
     util::bind_ptr<DescriptorOrdering> get_ordering();
 
+    // Ask the operating system to page in the clusters ahead of the one being
+    // searched. Overrides DBOptions::prefetch_clusters for this query.
+    Query& prefetch_clusters(bool enable = true)
+    {
+        m_prefetch_clusters = enable;
+        return *this;
+    }
+
+    // Search the table on up to 'threads' threads from the process' worker
+    // pool, or on as many as are available if 0. This applies to find_all(),
+    // count() and the aggregates when the table belongs to a frozen
+    // transaction and the query is not restricted by a view or a limit.
+    // Anything else is searched on the calling thread.
+    Query& set_threads(unsigned threads)
+    {
+        m_threads = threads;
+        return *this;
+    }
+
     bool eval_object(const Obj& obj) const;
 
 private:
@@ -334,8 +347,19 @@ private:
 
     void init() const;
     size_t find_internal(size_t start = 0, size_t end = size_t(-1)) const;
+    bool prefetch_clusters_enabled() const;
+    using ParallelVisitor = util::FunctionRef<void(ParentNode* node, const Cluster* cluster, size_t part)>;
+    bool traverse_clusters_in_parallel(util::FunctionRef<void(size_t num_parts)> prepare,
+                                       ParallelVisitor visit) const;
     void handle_pending_not();
     void set_table(TableRef tr);
+    // The query cache of the DB, if it has one and the results of this query
+    // can be cached. Sets `key` to the key of the result of `what` and
+    // `version` to the version of the snapshot.
+    QueryCache* get_result_cache(std::string_view what, std::string& key, uint_fast64_t& version) const;
+    std::optional<Mixed> cached_aggregate(std::string_view what, ColKey col_key, ObjKey* return_key,
+                                          size_t* value_count,
+                                          util::FunctionRef<std::optional<Mixed>(ObjKey*, size_t*)> aggregate) const;
     std::string get_description(util::serializer::SerialisationState& state) const;
 
 public:
@@ -361,6 +385,8 @@ private:
 
     template <typename T>
     void aggregate(QueryStateBase& st, ColKey column_key) const;
+    template <typename T>
+    bool aggregate_in_parallel(QueryStateBase& st, ColKey column_key) const;
 
     size_t find_best_node(ParentNode* pn) const;
     void aggregate_internal(ParentNode* pn, QueryStateBase* st, size_t start, size_t end,
@@ -368,6 +394,8 @@ private:
 
     void do_find_all(QueryStateBase& st) const;
     size_t do_count(size_t limit = size_t(-1)) const;
+    bool find_all_in_parallel(QueryStateBase& st) const;
+    bool count_in_parallel(size_t& count) const;
     void delete_nodes() noexcept;
 
     ParentNode* root_node() const
@@ -406,6 +434,8 @@ private:
     TableView* m_source_table_view = nullptr; // table views are not refcounted, and not owned by the query.
     std::unique_ptr<TableView> m_owned_source_table_view; // <--- except when indicated here
     util::bind_ptr<DescriptorOrdering> m_ordering;
+    std::optional<bool> m_prefetch_clusters;
+    unsigned m_threads = 1;
 };
 
 // Implementation:
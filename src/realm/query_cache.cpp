@@ -0,0 +1,75 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/query_cache.hpp>
+
+using namespace realm;
+
+QueryCache::QueryCache(size_t max_entries)
+    : m_max_entries(max_entries)
+{
+}
+
+QueryCache::ResultPtr QueryCache::get(const std::string& key, uint_fast64_t version)
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end() || it->second->version != version)
+        return {};
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    ++m_hit_count;
+    return it->second->result;
+}
+
+void QueryCache::put(const std::string& key, uint_fast64_t version, ResultPtr result)
+{
+    std::lock_guard lock(m_mutex);
+    auto [it, inserted] = m_index.try_emplace(key);
+    if (!inserted) {
+        // Replace the result of another version
+        it->second->version = version;
+        it->second->result = std::move(result);
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+    m_entries.push_front(Entry{&it->first, version, std::move(result)});
+    it->second = m_entries.begin();
+    if (m_entries.size() > m_max_entries) {
+        m_index.erase(*m_entries.back().key);
+        m_entries.pop_back();
+    }
+}
+
+void QueryCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+}
+
+size_t QueryCache::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t QueryCache::hit_count() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_hit_count;
+}
@@ -0,0 +1,83 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_QUERY_CACHE_HPP
+#define REALM_QUERY_CACHE_HPP
+
+#include <realm/keys.hpp>
+#include <realm/mixed.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace realm {
+
+/// A cache of query results shared by the transactions of a DB, enabled by
+/// DBOptions::query_cache_size. A result is stored under a key made of the
+/// description of the query and what was computed, and is valid for the
+/// version of the snapshot it was computed on. The version stands in for the
+/// versions of the tables involved, since a Table only keeps a version of its
+/// contents within one transaction.
+///
+/// Only the results of queries run in read and frozen transactions are cached,
+/// and not those of queries restricted by a view or a list.
+class QueryCache {
+public:
+    struct Result {
+        std::vector<ObjKey> keys;   // Query::find_all()
+        std::optional<Mixed> value; // Aggregates
+        ObjKey key;                 // Object with the minimum or maximum
+        size_t count = 0;           // Query::count(), or the number of values averaged
+    };
+    using ResultPtr = std::shared_ptr<const Result>;
+
+    explicit QueryCache(size_t max_entries);
+
+    /// The result stored under `key`, if it was computed on `version`
+    ResultPtr get(const std::string& key, uint_fast64_t version);
+    /// Stores the result, evicting the least recently used one if the cache
+    /// is full
+    void put(const std::string& key, uint_fast64_t version, ResultPtr result);
+    void clear();
+
+    size_t size() const;
+    size_t hit_count() const;
+
+private:
+    struct Entry {
+        const std::string* key;
+        uint_fast64_t version;
+        ResultPtr result;
+    };
+
+    const size_t m_max_entries;
+    mutable std::mutex m_mutex;
+    // Most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    size_t m_hit_count = 0;
+};
+
+} // namespace realm
+
+#endif // REALM_QUERY_CACHE_HPP
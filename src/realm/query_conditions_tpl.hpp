@@ -20,6 +20,8 @@
 #define REALM_QUERY_CONDITIONS_TPL_HPP
 
 #include <realm/aggregate_ops.hpp>
+#include <realm/array_basic.hpp>
+#include <realm/array_integer.hpp>
 #include <realm/query_conditions.hpp>
 #include <realm/column_type_traits.hpp>
 
@@ -27,20 +29,27 @@
 
 namespace realm {
 
+// Leaves which can aggregate a range of elements in one go, see match_range()
+template <class LeafType>
+constexpr bool has_range_aggregates = realm::is_any_v<LeafType, ArrayInteger, ArrayIntNull, BasicArray<float>,
+                                                      BasicArray<double>, BasicArrayNull<float>, BasicArrayNull<double>>;
+
 template <class T>
 class QueryStateSum : public QueryStateBase {
 public:
-    using Type = T;
-    using ResultType = typename aggregate_operations::Sum<T>::ResultType;
+    using Type = typename util::RemoveOptional<T>::type;
+    using ResultType = typename aggregate_operations::Sum<Type>::ResultType;
+    using LeafType = typename ColumnTypeTraits<T>::cluster_leaf_type;
     using QueryStateBase::QueryStateBase;
     bool match(size_t index, Mixed value) noexcept final
     {
         if (m_source_column) {
-            REALM_ASSERT_DEBUG(value.is_null());
+            // Some finders pass on the value of the condition column, which
+            // need not be the one aggregated
             value = m_source_column->get_any(index);
         }
         if (!value.is_null()) {
-            auto v = value.get<T>();
+            auto v = value.get<Type>();
             if (!m_state.accumulate(v))
                 return true; // no match, continue searching
             ++m_match_count;
@@ -52,13 +61,52 @@ public:
         REALM_ASSERT(m_source_column);
         Mixed value{m_source_column->get_any(index)};
         if (!value.is_null()) {
-            auto v = value.get<T>();
+            auto v = value.get<Type>();
             if (!m_state.accumulate(v))
                 return true; // no match, continue searching
             ++m_match_count;
         }
         return (m_limit > m_match_count);
     }
+    bool match_pattern(size_t index, uint64_t pattern) final
+    {
+        if constexpr (has_range_aggregates<LeafType>) {
+            if (!m_source_column || m_limit != size_t(-1))
+                return false;
+            if (pattern == ~uint64_t(0))
+                return match_range(index, index + 64);
+            auto leaf = static_cast<const LeafType*>(m_source_column);
+            for (; pattern; pattern &= pattern - 1) {
+                if (m_state.accumulate(leaf->get(index + ctz(size_t(pattern)))))
+                    ++m_match_count;
+            }
+            return true;
+        }
+        return false;
+    }
+    bool match_range(size_t begin, size_t end) final
+    {
+        if constexpr (has_range_aggregates<LeafType>) {
+            if (!m_source_column || m_limit != size_t(-1))
+                return false;
+            size_t count;
+            auto sum = static_cast<const LeafType*>(m_source_column)->sum(begin, end, count);
+            m_state.add(sum, count);
+            m_match_count += count;
+            return true;
+        }
+        return false;
+    }
+    std::unique_ptr<QueryStateBase> make_partial() const final
+    {
+        return std::make_unique<QueryStateSum>();
+    }
+    void merge(const QueryStateBase& other) final
+    {
+        auto& partial = static_cast<const QueryStateSum&>(other);
+        m_state.combine(partial.m_state);
+        m_match_count += partial.m_match_count;
+    }
     ResultType result_sum() const
     {
         return m_state.result();
@@ -69,26 +117,29 @@ public:
     }
 
 private:
-    aggregate_operations::Sum<typename util::RemoveOptional<T>::type> m_state;
+    aggregate_operations::Sum<Type> m_state;
 };
 
 template <class R, template <class> class State>
 class QueryStateMinMax : public QueryStateBase {
 public:
+    using Type = typename util::RemoveOptional<R>::type;
+    using LeafType = typename ColumnTypeTraits<R>::cluster_leaf_type;
     using QueryStateBase::QueryStateBase;
     bool match(size_t index, Mixed value) noexcept final
     {
         if (m_source_column) {
-            REALM_ASSERT_DEBUG(value.is_null());
+            // Some finders pass on the value of the condition column, which
+            // need not be the one aggregated
             value = m_source_column->get_any(index);
         }
         if (!value.is_null()) {
-            auto v = value.get<R>();
+            auto v = value.get<Type>();
             if (!m_state.accumulate(v)) {
                 return true; // no match, continue searching
             }
             ++m_match_count;
-            m_minmax_key = (m_key_values ? m_key_values->get(index) : index) + m_key_offset;
+            m_minmax_key = get_key(index);
         }
         return m_limit > m_match_count;
     }
@@ -97,22 +148,77 @@ public:
         REALM_ASSERT(m_source_column);
         Mixed value{m_source_column->get_any(index)};
         if (!value.is_null()) {
-            auto v = value.get<R>();
+            auto v = value.get<Type>();
             if (!m_state.accumulate(v)) {
                 return true; // no match, continue searching
             }
             ++m_match_count;
-            m_minmax_key = (m_key_values ? m_key_values->get(index) : index) + m_key_offset;
+            m_minmax_key = get_key(index);
         }
         return m_limit > m_match_count;
     }
+    bool match_pattern(size_t index, uint64_t pattern) final
+    {
+        if constexpr (has_range_aggregates<LeafType>) {
+            if (!m_source_column || m_limit != size_t(-1))
+                return false;
+            if (pattern == ~uint64_t(0))
+                return match_range(index, index + 64);
+            auto leaf = static_cast<const LeafType*>(m_source_column);
+            for (; pattern; pattern &= pattern - 1) {
+                size_t i = index + ctz(size_t(pattern));
+                if (m_state.accumulate(leaf->get(i))) {
+                    ++m_match_count;
+                    m_minmax_key = get_key(i);
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+    bool match_range(size_t begin, size_t end) final
+    {
+        if constexpr (has_range_aggregates<LeafType>) {
+            if (!m_source_column || m_limit != size_t(-1))
+                return false;
+            auto leaf = static_cast<const LeafType*>(m_source_column);
+            Type value;
+            size_t ndx;
+            bool found = std::is_same_v<State<Type>, aggregate_operations::Maximum<Type>>
+                             ? leaf->maximum(value, begin, end, &ndx)
+                             : leaf->minimum(value, begin, end, &ndx);
+            if (found && m_state.accumulate(value)) {
+                ++m_match_count;
+                m_minmax_key = get_key(ndx);
+            }
+            return true;
+        }
+        return false;
+    }
+    std::unique_ptr<QueryStateBase> make_partial() const final
+    {
+        return std::make_unique<QueryStateMinMax>();
+    }
+    void merge(const QueryStateBase& other) final
+    {
+        // Ties are resolved in favour of the earlier part, as in a serial search
+        auto& partial = static_cast<const QueryStateMinMax&>(other);
+        if (!partial.m_state.is_null() && m_state.accumulate(partial.m_state.result()))
+            m_minmax_key = partial.m_minmax_key;
+        m_match_count += partial.m_match_count;
+    }
     Mixed get_result() const
     {
         return m_state.is_null() ? Mixed() : m_state.result();
     }
 
 private:
-    State<typename util::RemoveOptional<R>::type> m_state;
+    State<Type> m_state;
+
+    int64_t get_key(size_t index) const
+    {
+        return (m_key_values ? m_key_values->get(index) : index) + m_key_offset;
+    }
 };
 
 template <class R>
@@ -196,7 +302,7 @@ private:
     template <typename T>
     static Mixed average(const Target& target, ColKey col_key, size_t* value_count)
     {
-        QueryStateSum<typename util::RemoveOptional<T>::type> st;
+        QueryStateSum<T> st;
         target.template aggregate<T>(st, col_key);
         if (value_count)
             *value_count = st.result_count();
@@ -212,7 +318,7 @@ private:
     {
         if (col_key.is_collection())
             return std::nullopt;
-        QueryStateSum<typename util::RemoveOptional<T>::type> st;
+        QueryStateSum<T> st;
         target.template aggregate<T>(st, col_key);
         return st.result_sum();
     }
@@ -249,7 +355,7 @@ private:
     template <template <typename> typename QueryState, typename T>
     static Mixed minmax(const Target& target, ColKey col_key, ObjKey* return_ndx)
     {
-        QueryState<typename util::RemoveOptional<T>::type> st;
+        QueryState<T> st;
         target.template aggregate<T>(st, col_key);
         if (return_ndx)
             *return_ndx = ObjKey(st.m_minmax_key);
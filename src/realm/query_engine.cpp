@@ -23,6 +23,8 @@
 #include <realm/db.hpp>
 #include <realm/utilities.hpp>
 
+#include <chrono>
+
 namespace realm {
 
 ParentNode::ParentNode(const ParentNode& from)
@@ -142,6 +144,56 @@ size_t ParentNode::aggregate_local(QueryStateBase* st, size_t start, size_t end,
     }
 }
 
+size_t ParentNode::aggregate_local_timed(QueryStateBase* st, size_t start, size_t end, size_t local_limit,
+                                         ArrayPayload* source_column)
+{
+    // Index lookups cost per match rather than per object, so only scans are timed
+    if (m_dT == 0.0)
+        return aggregate_local(st, start, end, local_limit, source_column);
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t next = aggregate_local(st, start, end, local_limit, source_column);
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+    if (next != size_t(-1) && next > start) {
+        m_timed_ns += double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        m_timed_objects += double(next - start);
+        if (m_timed_objects > c_max_timed_objects) {
+            // Let older measurements fade, as the data may change along the table
+            m_timed_ns /= 2;
+            m_timed_objects /= 2;
+        }
+    }
+    return next;
+}
+
+void ParentNode::estimate_costs(size_t num_objects)
+{
+    // With a single condition there is nothing to order
+    if (m_children.size() < 2)
+        return;
+    if (num_objects > 0) {
+        for (auto node : m_children) {
+            std::optional<double> selectivity;
+            if (auto keys = node->index_based_keys())
+                selectivity = double(keys->size()) / num_objects;
+            else
+                selectivity = node->estimate_selectivity();
+            if (selectivity)
+                node->m_dD = 1.0 / std::max(*selectivity, 1.0 / (num_objects + 1));
+        }
+    }
+    order_children();
+}
+
+void ParentNode::order_children()
+{
+    if (m_children.size() > 2) {
+        std::stable_sort(m_children.begin() + 1, m_children.end(), [](const ParentNode* a, const ParentNode* b) {
+            return a->rejection_cost() < b->rejection_cost();
+        });
+    }
+}
+
 size_t ParentNode::find_all_local(size_t start, size_t end)
 {
     while (start < end) {
@@ -416,6 +468,16 @@ void StringNode<Equal>::_search_index_init()
     m_index_evaluator->init(index, StringNodeBase::m_string_value);
 }
 
+std::optional<double> StringNode<Equal>::estimate_selectivity()
+{
+    auto stats = m_table->get_column_statistics(m_condition_column_key);
+    if (stats.sample_size == 0)
+        return {};
+    if (m_needles.empty())
+        return stats.value_fraction(!m_value);
+    return std::min(1.0, m_needles.size() * stats.value_fraction(false));
+}
+
 bool StringNode<Equal>::do_consume_condition(ParentNode& node)
 {
     // Don't use the search index if present since we're in a scenario where
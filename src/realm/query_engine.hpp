@@ -86,6 +86,7 @@ TConditionValue:    Type of values in condition column. That is, int64_t, float,
 #include <realm/array_timestamp.hpp>
 #include <realm/column_integer.hpp>
 #include <realm/column_type_traits.hpp>
+#include <realm/index_sorted.hpp>
 #include <realm/index_string.hpp>
 #include <realm/query_conditions.hpp>
 #include <realm/query_expression.hpp>
@@ -95,7 +96,9 @@ TConditionValue:    Type of values in condition column. That is, int64_t, float,
 #include <realm/util/serializer.hpp>
 #include <realm/utilities.hpp>
 
+#include <limits>
 #include <map>
+#include <optional>
 #include <unordered_set>
 
 #if REALM_X86_OR_X64_TRUE && defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219
@@ -140,9 +143,36 @@ public:
     {
         constexpr size_t bitwidth_time_unit = 64;
         // dt = 1/64 to 1. Match dist is 8 times more important than bitwidth
-        return 8 * bitwidth_time_unit / m_dD + m_dT;
+        return 8 * bitwidth_time_unit / m_dD + time_per_object();
     }
 
+    // m_dT, or the measured time per object in nanoseconds when this node has
+    // been driving the search for long enough
+    double time_per_object() const
+    {
+        if (m_dT == 0.0 || m_timed_objects < c_min_timed_objects)
+            return m_dT;
+        return std::max(m_timed_ns / m_timed_objects, 0.01);
+    }
+
+    // Expected time spent per object this condition rules out, when checked
+    // after another condition has matched
+    double rejection_cost() const
+    {
+        double rejected = 1.0 - 1.0 / std::max(m_dD, 1.0);
+        return time_per_object() / std::max(rejected, 0.001);
+    }
+
+    // Replaces the initial guess of m_dD for each of the conditions with the
+    // number of matches found by a search index or an estimate from the
+    // column statistics, and orders the conditions to check. Called on the
+    // root node after gather_children().
+    void estimate_costs(size_t num_objects);
+
+    // Orders the conditions checked when this one matches by how cheaply they
+    // are expected to rule out an object
+    void order_children();
+
     size_t find_first(size_t start, size_t end);
 
     bool match(const Obj& obj);
@@ -183,12 +213,39 @@ public:
 
     virtual void collect_dependencies(std::vector<TableKey>&) const {}
 
+    // Returns false if the bounds of the values in the current cluster rule out
+    // a match for this condition, so that the whole cluster can be skipped.
+    virtual bool may_match_in_cluster() const
+    {
+        return true;
+    }
+
+    bool cluster_may_match() const
+    {
+        for (auto child : m_children) {
+            if (!child->may_match_in_cluster())
+                return false;
+        }
+        return true;
+    }
+
     virtual size_t find_first_local(size_t start, size_t end) = 0;
     virtual size_t find_all_local(size_t start, size_t end);
 
     virtual size_t aggregate_local(QueryStateBase* st, size_t start, size_t end, size_t local_limit,
                                    ArrayPayload* source_column);
 
+    // aggregate_local() which measures the time spent, for time_per_object()
+    size_t aggregate_local_timed(QueryStateBase* st, size_t start, size_t end, size_t local_limit,
+                                 ArrayPayload* source_column);
+
+    // Fraction of the objects expected to match, if the condition can be
+    // estimated from the column statistics of the table
+    virtual std::optional<double> estimate_selectivity()
+    {
+        return {};
+    }
+
     virtual std::string validate()
     {
         return m_child ? m_child->validate() : "";
@@ -268,12 +325,19 @@ public:
     mutable ColKey m_condition_column_key = ColKey(); // Column of search criteria
 
     double m_dD;       // Average row distance between each local match at current position
-    double m_dT = 1.0; // Time overhead of testing index i + 1 if we have just tested index i. > 1 for linear scans, 0
-    // for index/tableview
+    double m_dT = 1.0; // Relative time overhead of testing index i + 1 if we have just tested index i. > 1 for
+    // linear scans, 0 for index/tableview. Unitless, see time_per_object().
 
     size_t m_probes = 0;
     size_t m_matches = 0;
 
+    // Time measured by aggregate_local_timed(). Kept when the node is
+    // initialized again, so that a query run repeatedly uses what it learned.
+    double m_timed_ns = 0.0;
+    double m_timed_objects = 0.0;
+    static constexpr double c_min_timed_objects = 1000;
+    static constexpr double c_max_timed_objects = 1 << 16;
+
 protected:
     ConstTableRef m_table = ConstTableRef();
     const Cluster* m_cluster = nullptr;
@@ -355,6 +419,29 @@ private:
     std::vector<ObjKey>* m_matching_keys = nullptr;
 };
 
+// Collects the keys of the objects matching a range condition from the sorted
+// index of the column, in key order, when there is one and the condition
+// leaves out most of the objects. Returns false if the leaves should be
+// searched instead.
+template <class TConditionFunction>
+bool find_all_in_sorted_index(const Table& table, ColKey col_key, Mixed value, std::vector<ObjKey>& keys)
+{
+    if constexpr (realm::is_any_v<TConditionFunction, Greater, GreaterEqual, Less, LessEqual>) {
+        constexpr size_t c_max_fraction_inverse = 8;
+        if (table.search_index_type(col_key) != IndexType::Sorted)
+            return false;
+        const SortedIndex* index = table.get_sorted_index(col_key);
+        auto [begin, end] = index->find_range<TConditionFunction>(value);
+        if ((end - begin) * c_max_fraction_inverse > table.size())
+            return false;
+        keys.clear();
+        index->get_keys(begin, end, keys);
+        std::sort(keys.begin(), keys.end());
+        return true;
+    }
+    return false;
+}
+
 template <class LeafType>
 class IntegerNodeBase : public ColumnNodeBase {
 public:
@@ -393,6 +480,17 @@ protected:
         return end;
     }
 
+    // Leaves of nullable columns reserve a value for null, so only the bounds
+    // of non-nullable leaves tell anything about the values
+    template <class TConditionFunction>
+    bool may_match_in_cluster() const
+    {
+        if constexpr (std::is_same_v<LeafType, ArrayInteger>) {
+            return TConditionFunction().can_match(m_value, m_leaf->get_lower_bound(), m_leaf->get_upper_bound());
+        }
+        return true;
+    }
+
     std::string describe(util::serializer::SerialisationState& state) const override
     {
         return state.describe_column(ParentNode::m_table, ColumnNodeBase::m_condition_column_key) + " " +
@@ -441,6 +539,14 @@ public:
         m_dT = .25;
     }
 
+    bool may_match_in_cluster() const override
+    {
+        if constexpr (std::is_same_v<LeafType, ArrayInteger>) {
+            return m_leaf->get_upper_bound() >= m_from && m_leaf->get_lower_bound() <= m_to;
+        }
+        return true;
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
         return m_leaf->find_first_in_range(m_from, m_to, start, end);
@@ -484,13 +590,39 @@ public:
     {
     }
 
+    void init(bool will_query_ranges) override
+    {
+        BaseType::init(will_query_ranges);
+        m_index_evaluator.reset();
+        if (find_all_in_sorted_index<TConditionFunction>(*this->m_table, this->m_condition_column_key,
+                                                         Mixed(this->m_value), m_index_matches)) {
+            m_index_evaluator = IndexEvaluator();
+            m_index_evaluator->init(&m_index_matches);
+            this->m_dT = 0;
+        }
+    }
+
+    const IndexEvaluator* index_based_keys() override
+    {
+        return m_index_evaluator ? &*m_index_evaluator : nullptr;
+    }
+
+    bool may_match_in_cluster() const override
+    {
+        return BaseType::template may_match_in_cluster<TConditionFunction>();
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_index_evaluator)
+            return m_index_evaluator->do_search_index(this->m_cluster, start, end);
         return this->m_leaf->template find_first<TConditionFunction>(this->m_value, start, end);
     }
 
     size_t find_all_local(size_t start, size_t end) override
     {
+        if (m_index_evaluator)
+            return ParentNode::find_all_local(start, end);
         return BaseType::template find_all_local<TConditionFunction>(start, end);
     }
 
@@ -503,6 +635,10 @@ public:
     {
         return std::unique_ptr<ParentNode>(new ThisType(*this));
     }
+
+private:
+    std::optional<IndexEvaluator> m_index_evaluator;
+    std::vector<ObjKey> m_index_matches;
 };
 
 template <size_t linear_search_threshold, class LeafType, class NeedleContainer>
@@ -587,12 +723,41 @@ public:
     {
         BaseType::init(will_query_ranges);
         m_nb_needles = m_needles.size();
+        m_index_evaluator.reset();
+
+        m_needle_min = std::numeric_limits<int64_t>::max();
+        m_needle_max = std::numeric_limits<int64_t>::min();
+        for (const auto& needle : m_needles) {
+            if constexpr (std::is_same_v<TConditionValue, std::optional<int64_t>>) {
+                if (!needle)
+                    continue;
+                m_needle_min = std::min(m_needle_min, *needle);
+                m_needle_max = std::max(m_needle_max, *needle);
+            }
+            else {
+                m_needle_min = std::min(m_needle_min, needle);
+                m_needle_max = std::max(m_needle_max, needle);
+            }
+        }
 
-        if (has_search_index() && m_nb_needles == 0) {
+        if (has_search_index()) {
             SearchIndex* index = ParentNode::m_table->get_search_index(ParentNode::m_condition_column_key);
-            m_index_evaluator = IndexEvaluator();
-            m_index_evaluator->init(index, BaseType::m_value);
-            IntegerNodeBase<LeafType>::m_dT = 0;
+            if (m_nb_needles == 0) {
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(index, BaseType::m_value);
+                IntegerNodeBase<LeafType>::m_dT = 0;
+            }
+            else if (m_nb_needles * c_objects_per_index_lookup < ParentNode::m_table->size()) {
+                // Looking up each of a few values is cheaper than checking all
+                // the objects against the set of values
+                m_index_matches.clear();
+                for (const auto& needle : m_needles)
+                    index->find_all(m_index_matches, Mixed(needle));
+                std::sort(m_index_matches.begin(), m_index_matches.end());
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(&m_index_matches);
+                IntegerNodeBase<LeafType>::m_dT = 0;
+            }
         }
     }
 
@@ -625,18 +790,42 @@ public:
         return m_index_evaluator ? &(*m_index_evaluator) : nullptr;
     }
 
+    bool may_match_in_cluster() const override
+    {
+        if (!m_nb_needles)
+            return BaseType::template may_match_in_cluster<Equal>();
+        if constexpr (std::is_same_v<LeafType, ArrayInteger>) {
+            return m_needle_min <= this->m_leaf->get_upper_bound() &&
+                   m_needle_max >= this->m_leaf->get_lower_bound();
+        }
+        return true;
+    }
+
+    std::optional<double> estimate_selectivity() override
+    {
+        auto stats = ParentNode::m_table->get_column_statistics(ParentNode::m_condition_column_key);
+        if (stats.sample_size == 0)
+            return {};
+        if (m_nb_needles)
+            return std::min(1.0, m_nb_needles * stats.value_fraction(false));
+        bool is_null = false;
+        if constexpr (std::is_same_v<TConditionValue, std::optional<int64_t>>)
+            is_null = !BaseType::m_value;
+        return stats.value_fraction(is_null);
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
         REALM_ASSERT(this->m_table);
         size_t s = realm::npos;
 
         if (start < end) {
-            if (m_nb_needles) {
-                s = find_first_haystack<22>(*this->m_leaf, m_needles, start, end);
-            }
-            else if (m_index_evaluator) {
+            if (m_index_evaluator) {
                 return m_index_evaluator->do_search_index(BaseType::m_cluster, start, end);
             }
+            else if (m_nb_needles) {
+                s = find_first_haystack<22>(*this->m_leaf, m_needles, start, end);
+            }
             else {
                 s = this->m_leaf->template find_first<Equal>(this->m_value, start, end);
             }
@@ -648,6 +837,8 @@ public:
     size_t find_all_local(size_t start, size_t end) override
     {
         if (m_nb_needles) {
+            if (m_index_evaluator)
+                return ParentNode::find_all_local(start, end);
             return find_all_haystack<22>(*this->m_leaf, m_needles, start, end, ParentNode::m_state);
         }
         return BaseType::template find_all_local<Equal>(start, end);
@@ -682,7 +873,11 @@ public:
 private:
     std::unordered_set<TConditionValue> m_needles;
     size_t m_nb_needles = 0;
+    int64_t m_needle_min = 0;
+    int64_t m_needle_max = 0;
     std::optional<IndexEvaluator> m_index_evaluator;
+    std::vector<ObjKey> m_index_matches;
+    static constexpr size_t c_objects_per_index_lookup = 64;
 
     IntegerNode(const IntegerNode<LeafType, Equal>& from)
         : BaseType(from)
@@ -1077,6 +1272,15 @@ public:
                 this->m_dT = 0;
             }
         }
+        else {
+            m_index_evaluator.reset();
+            if (find_all_in_sorted_index<TConditionFunction>(*m_table, m_condition_column_key, Mixed(m_value),
+                                                             m_index_matches)) {
+                m_index_evaluator = IndexEvaluator();
+                m_index_evaluator->init(&m_index_matches);
+                this->m_dT = 0;
+            }
+        }
     }
 
     void table_changed() override
@@ -1100,10 +1304,8 @@ public:
 
     size_t find_first_local(size_t start, size_t end) override
     {
-        if constexpr (std::is_same_v<TConditionFunction, Equal>) {
-            if (m_index_evaluator) {
-                return m_index_evaluator->do_search_index(this->m_cluster, start, end);
-            }
+        if (m_index_evaluator) {
+            return m_index_evaluator->do_search_index(this->m_cluster, start, end);
         }
         return m_leaf->find_first<TConditionFunction>(m_value, start, end);
     }
@@ -1122,6 +1324,7 @@ public:
 
 protected:
     std::optional<IndexEvaluator> m_index_evaluator;
+    std::vector<ObjKey> m_index_matches; // Matches of a range condition in the sorted index
 };
 
 class DecimalNodeBase : public ParentNode {
@@ -1993,6 +2196,8 @@ public:
 
     bool do_consume_condition(ParentNode& other) override;
 
+    std::optional<double> estimate_selectivity() override;
+
     std::unique_ptr<ParentNode> clone() const override
     {
         return std::unique_ptr<ParentNode>(new StringNode<Equal>(*this));
@@ -2103,6 +2308,84 @@ private:
     }
 };
 
+// Collects the matches of a condition over a range of a cluster as a bitmap.
+// The finders of the integer leaves hand it 64 matches at a time.
+class QueryStateBitmap : public QueryStateBase {
+public:
+    void reset(size_t begin, size_t end)
+    {
+        m_begin = begin;
+        m_end = end;
+        m_bits.assign((end - begin + 63) / 64, 0);
+    }
+
+    void clear() noexcept
+    {
+        m_begin = m_end = 0;
+    }
+
+    bool contains(size_t start, size_t end) const noexcept
+    {
+        return m_begin <= start && end <= m_end && start < end;
+    }
+
+    bool match(size_t index, Mixed) noexcept final
+    {
+        return match(index);
+    }
+
+    bool match(size_t index) noexcept final
+    {
+        size_t i = index - m_begin;
+        m_bits[i / 64] |= uint64_t(1) << (i % 64);
+        return true;
+    }
+
+    bool match_pattern(size_t index, uint64_t pattern) final
+    {
+        size_t i = index - m_begin;
+        size_t word = i / 64;
+        size_t shift = i % 64;
+        m_bits[word] |= pattern << shift;
+        if (shift && word + 1 < m_bits.size())
+            m_bits[word + 1] |= pattern >> (64 - shift);
+        return true;
+    }
+
+    bool match_range(size_t begin, size_t end) final
+    {
+        for (size_t i = begin; i < end;) {
+            size_t bit = (i - m_begin) % 64;
+            size_t n = std::min<size_t>(64 - bit, end - i);
+            uint64_t mask = n == 64 ? ~uint64_t(0) : ((uint64_t(1) << n) - 1) << bit;
+            m_bits[(i - m_begin) / 64] |= mask;
+            i += n;
+        }
+        return true;
+    }
+
+    // Index of the first match in [start, m_end), or not_found
+    size_t find_next(size_t start) const noexcept
+    {
+        size_t i = start - m_begin;
+        size_t word = i / 64;
+        if (word >= m_bits.size())
+            return not_found;
+        uint64_t bits = m_bits[word] & (~uint64_t(0) << (i % 64));
+        while (!bits) {
+            if (++word == m_bits.size())
+                return not_found;
+            bits = m_bits[word];
+        }
+        return m_begin + word * 64 + ctz(size_t(bits));
+    }
+
+private:
+    size_t m_begin = 0;
+    size_t m_end = 0;
+    std::vector<uint64_t> m_bits;
+};
+
 // OR node contains at least two node pointers: Two or more conditions to OR
 // together in m_conditions, and the next AND condition (if any) in m_child.
 //
@@ -2148,6 +2431,8 @@ public:
 
         m_was_match.clear();
         m_was_match.resize(m_conditions.size(), false);
+
+        m_bitmap.clear();
     }
 
     std::string describe(util::serializer::SerialisationState& state) const override
@@ -2188,6 +2473,8 @@ public:
         m_was_match.clear();
         m_was_match.resize(m_conditions.size(), false);
 
+        m_bitmap.clear();
+
         std::vector<ParentNode*> v;
         for (auto& condition : m_conditions) {
             condition->init(will_query_ranges);
@@ -2201,6 +2488,23 @@ public:
         if (start >= end)
             return not_found;
 
+        // With many conditions, finding the next match of each of them again
+        // and again is slow. Instead each condition collects all its matches in
+        // the range at once, and the matches of all of them are read off the
+        // bitmap. The bitmap may hold matches past the end of the range asked
+        // for, and those must not be reported.
+        if (m_bitmap.contains(start, end)) {
+            size_t r = m_bitmap.find_next(start);
+            return r < end ? r : not_found;
+        }
+        if (m_conditions.size() >= c_min_conditions_for_bitmap && end - start >= c_min_range_for_bitmap) {
+            m_bitmap.reset(start, end);
+            for (auto& condition : m_conditions)
+                condition->aggregate_local(&m_bitmap, start, end, size_t(-1), nullptr);
+            size_t r = m_bitmap.find_next(start);
+            return r < end ? r : not_found;
+        }
+
         size_t index = not_found;
 
         for (size_t c = 0; c < m_conditions.size(); ++c) {
@@ -2331,6 +2635,11 @@ private:
     // is a matching index if m_was_match is true
     std::vector<size_t> m_last;
     std::vector<bool> m_was_match;
+
+    // Matches of any of the conditions in the range searched last
+    QueryStateBitmap m_bitmap;
+    static constexpr size_t c_min_conditions_for_bitmap = 4;
+    static constexpr size_t c_min_range_for_bitmap = 64;
 };
 
 
@@ -2485,8 +2794,19 @@ template <class TConditionFunction>
 class TwoColumnsNode : public TwoColumnsNodeBase {
 public:
     using TwoColumnsNodeBase::TwoColumnsNodeBase;
+
+    void init(bool will_query_ranges) override
+    {
+        TwoColumnsNodeBase::init(will_query_ranges);
+        m_find_first_typed = select_find_first_typed();
+        m_dT = m_find_first_typed ? 1.0 : 100.0;
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
+        if (m_find_first_typed)
+            return m_find_first_typed(*m_leaf1, *m_leaf2, start, end);
+
         size_t s = start;
         while (s < end) {
             QueryValue v1(m_leaf1->get_any(s));
@@ -2508,6 +2828,62 @@ public:
     {
         return std::unique_ptr<ParentNode>(new TwoColumnsNode<TConditionFunction>(*this));
     }
+
+private:
+    using FindFirstFunc = size_t (*)(const ArrayPayload&, const ArrayPayload&, size_t, size_t);
+
+    // Set if the leaves of both columns can be compared by value, without
+    // going through Mixed for each object
+    FindFirstFunc m_find_first_typed = nullptr;
+
+    template <class T>
+    static T unwrap(const T& value)
+    {
+        return value;
+    }
+    template <class T>
+    static T unwrap(const std::optional<T>& value)
+    {
+        return value.value_or(T{});
+    }
+
+    template <class LeafType1, class LeafType2>
+    static size_t find_first_typed(const ArrayPayload& payload1, const ArrayPayload& payload2, size_t start,
+                                   size_t end)
+    {
+        auto& leaf1 = static_cast<const LeafType1&>(payload1);
+        auto& leaf2 = static_cast<const LeafType2&>(payload2);
+        TConditionFunction cond;
+        for (; start < end; ++start) {
+            auto v1 = leaf1.get(start);
+            auto v2 = leaf2.get(start);
+            if (cond(unwrap(v1), unwrap(v2), value_is_null(v1), value_is_null(v2)))
+                return start;
+        }
+        return not_found;
+    }
+
+    FindFirstFunc select_find_first_typed() const
+    {
+        if (m_condition_column_key1.get_type() != m_condition_column_key2.get_type())
+            return nullptr;
+        bool nullable1 = m_condition_column_key1.is_nullable();
+        bool nullable2 = m_condition_column_key2.is_nullable();
+        switch (m_condition_column_key1.get_type()) {
+            case col_type_Int:
+                if (nullable1)
+                    return nullable2 ? &find_first_typed<ArrayIntNull, ArrayIntNull>
+                                     : &find_first_typed<ArrayIntNull, ArrayInteger>;
+                return nullable2 ? &find_first_typed<ArrayInteger, ArrayIntNull>
+                                 : &find_first_typed<ArrayInteger, ArrayInteger>;
+            case col_type_Bool:
+                return &find_first_typed<ArrayBoolNull, ArrayBoolNull>;
+            case col_type_Timestamp:
+                return &find_first_typed<ArrayTimestamp, ArrayTimestamp>;
+            default:
+                return nullptr;
+        }
+    }
 };
 
 
@@ -19,6 +19,7 @@
 #include <realm/query_expression.hpp>
 #include <realm/group.hpp>
 #include <realm/dictionary.hpp>
+#include <realm/table_view.hpp>
 
 namespace realm {
 
@@ -58,6 +59,12 @@ void LinkMap::collect_dependencies(std::vector<TableKey>& tables) const
     }
 }
 
+void LinkMap::check_columns() const
+{
+    for (size_t i = 0; i < m_link_column_keys.size(); ++i)
+        m_tables[i]->check_column(m_link_column_keys[i]);
+}
+
 std::string LinkMap::description(util::serializer::SerialisationState& state) const
 {
     std::string s;
@@ -263,6 +270,53 @@ std::vector<ObjKey> LinkMap::get_origin_objkeys(ObjKey key, size_t column) const
     return ret;
 }
 
+bool CompareBase::init_link_targets(const ObjPropertyBase& prop, std::unique_ptr<Expression> target_condition)
+{
+    const LinkMap& link_map = prop.get_link_map();
+    link_map.check_columns();
+    TableView matches = Query(std::move(target_condition)).find_all();
+    std::vector<ObjKey> targets;
+    targets.reserve(matches.size());
+    for (size_t i = 0; i < matches.size(); ++i)
+        targets.push_back(matches.get_key(i));
+    std::sort(targets.begin(), targets.end());
+
+    // With few matches it is cheaper to follow their backlinks to the objects
+    // linking to them than to look at the links of every object
+    size_t base_size = link_map.get_base_table()->size();
+    if (!link_map.has_indexes() && targets.size() * 8 < base_size) {
+        m_matches.clear();
+        for (ObjKey key : targets) {
+            auto origins = link_map.get_origin_objkeys(key);
+            m_matches.insert(m_matches.end(), origins.begin(), origins.end());
+        }
+        std::sort(m_matches.begin(), m_matches.end());
+        m_matches.erase(std::unique(m_matches.begin(), m_matches.end()), m_matches.end());
+        m_has_matches = true;
+        m_index_get = 0;
+        m_index_end = m_matches.size();
+        return true;
+    }
+
+    m_link_targets = std::move(targets);
+    m_link_column = &prop;
+    return true;
+}
+
+size_t CompareBase::find_first_with_link_targets(size_t start, size_t end) const
+{
+    for (; start < end; ++start) {
+        bool found = false;
+        m_link_column->get_link_map().map_links(start, [&](ObjKey key) {
+            found = std::binary_search(m_link_targets.begin(), m_link_targets.end(), key);
+            return !found;
+        });
+        if (found)
+            return start;
+    }
+    return not_found;
+}
+
 ColumnDictionaryKeys Columns<Dictionary>::keys()
 {
     return ColumnDictionaryKeys(*this);
@@ -1601,6 +1601,8 @@ public:
     }
 
     void collect_dependencies(std::vector<TableKey>& tables) const;
+    // Throws if one of the link columns has been removed
+    void check_columns() const;
 
     std::string description(util::serializer::SerialisationState& state) const;
 
@@ -1770,6 +1772,13 @@ public:
         return false;
     }
 
+    // The same property, but of the target table and without the links leading
+    // to it. Null if this is not supported for the type of the property.
+    virtual std::unique_ptr<Subexpr> clone_for_target_table() const
+    {
+        return {};
+    }
+
 protected:
     LinkMap m_link_map;
     // Column index of payload column of m_table
@@ -1846,6 +1855,18 @@ public:
         return ret;
     }
 
+    std::unique_ptr<Subexpr> clone_for_target_table() const final
+    {
+        if constexpr (realm::is_any_v<T, Int, Bool, Float, Double, Decimal128, Timestamp, StringData, BinaryData,
+                                      ObjectId, UUID>) {
+            return make_subexpr<Columns<T>>(m_column_key, m_link_map.get_target_table(),
+                                            std::vector<ExtendedColumnKey>{}, m_comparison_type);
+        }
+        else {
+            return {};
+        }
+    }
+
     void collect_dependencies(std::vector<TableKey>& tables) const final
     {
         m_link_map.collect_dependencies(tables);
@@ -4518,6 +4539,8 @@ public:
         return m_cluster->lower_bound_key(ClusterNode::RowKey(actual_key.value - m_cluster->get_offset()));
     }
 
+    size_t find_first_with_link_targets(size_t start, size_t end) const;
+
 protected:
     CompareBase(const CompareBase& other)
         : m_left(other.m_left->clone())
@@ -4540,6 +4563,12 @@ protected:
     std::vector<ObjKey> m_matches;
     mutable size_t m_index_get = 0;
     size_t m_index_end = 0;
+    // Set when the objects are matched by looking up their links among the
+    // target objects matching the condition, which are in m_link_targets
+    const ObjPropertyBase* m_link_column = nullptr;
+    std::vector<ObjKey> m_link_targets;
+
+    bool init_link_targets(const ObjPropertyBase& prop, std::unique_ptr<Expression> target_condition);
 };
 
 template <class TCond>
@@ -4550,6 +4579,9 @@ public:
     double init() override
     {
         double dT = 50.0;
+        m_has_matches = false;
+        m_link_column = nullptr;
+        m_link_targets.clear();
         if ((m_left->has_single_value()) || (m_right->has_single_value())) {
             dT = 10.0;
             if constexpr (std::is_same_v<TCond, Equal>) {
@@ -4603,6 +4635,10 @@ public:
                     dT = 0;
                 }
             }
+            if constexpr (realm::is_any_v<TCond, Equal, EqualIns, Greater, GreaterEqual, Less, LessEqual>) {
+                if (!m_has_matches && init_link_targets())
+                    dT = m_has_matches ? 0 : 5.0;
+            }
         }
 
         return dT;
@@ -4613,6 +4649,9 @@ public:
         if (m_has_matches) {
             return find_first_with_matches(start, end);
         }
+        if (m_link_column) {
+            return find_first_with_link_targets(start, end);
+        }
 
         size_t match;
         ValueBase left_buf;
@@ -4671,6 +4710,35 @@ public:
     {
         return std::unique_ptr<Expression>(new Compare(*this));
     }
+
+private:
+    // A condition comparing a property across links with a constant is first
+    // evaluated on the target table, and the objects are then matched by
+    // their links. Not done when a null link, which gives a null value, could
+    // match, or when there are more objects at the other end of the links.
+    bool init_link_targets()
+    {
+        bool constant_left = m_left->has_single_value();
+        Subexpr& constant = constant_left ? *m_left : *m_right;
+        Subexpr& column = constant_left ? *m_right : *m_left;
+        auto prop = dynamic_cast<const ObjPropertyBase*>(&column);
+        if (!prop || !prop->links_exist() || constant.get_mixed().is_null() ||
+            column.get_comparison_type().value_or(ExpressionComparisonType::Any) != ExpressionComparisonType::Any ||
+            constant.get_comparison_type().value_or(ExpressionComparisonType::Any) != ExpressionComparisonType::Any)
+            return false;
+        if (prop->get_link_map().get_target_table()->size() > prop->get_link_map().get_base_table()->size())
+            return false;
+        auto target_column = prop->clone_for_target_table();
+        if (!target_column)
+            return false;
+
+        std::unique_ptr<Expression> target_condition;
+        if (constant_left)
+            target_condition = std::make_unique<Compare>(constant.clone(), std::move(target_column));
+        else
+            target_condition = std::make_unique<Compare>(std::move(target_column), constant.clone());
+        return CompareBase::init_link_targets(*prop, std::move(target_condition));
+    }
 };
 } // namespace realm
 #endif // REALM_QUERY_EXPRESSION_HPP
@@ -21,6 +21,7 @@
 
 #include <cstdlib> // size_t
 #include <cstdint> // unint8_t etc
+#include <memory>
 
 #include <realm/node.hpp>
 
@@ -55,11 +56,32 @@ public:
     // such as when just counting the results in QueryStateCount.
     virtual bool match(size_t index) noexcept = 0;
 
+    // Called by the vectorized finders with a bitmask of the matches among the
+    // 64 elements starting at 'index'. Returns true if all the matches were
+    // consumed, or false if they must be reported through match() instead.
     virtual bool match_pattern(size_t, uint64_t)
     {
         return false;
     }
 
+    // Called when all the elements in [begin, end) match, so that the values of
+    // the payload column can be aggregated a whole leaf at a time. Returns
+    // false if the matches must be reported through match() instead.
+    virtual bool match_range(size_t, size_t)
+    {
+        return false;
+    }
+
+    // Support for searching parts of a table on separate threads. Returns an
+    // empty state of the same kind, or null if the state cannot be split.
+    virtual std::unique_ptr<QueryStateBase> make_partial() const
+    {
+        return nullptr;
+    }
+    // Fold a state returned by make_partial() into this one. Partial states
+    // must be merged in the order of the parts of the table they searched.
+    virtual void merge(const QueryStateBase&) {}
+
     inline size_t match_count() const noexcept
     {
         return m_match_count;
@@ -100,6 +122,7 @@ public:
     }
     bool match(size_t, Mixed) noexcept final;
     bool match(size_t index) noexcept final;
+    bool match_pattern(size_t index, uint64_t pattern) final;
     size_t get_count() const noexcept
     {
         return m_match_count;
@@ -116,8 +116,8 @@ public:
     bool is_attached() const noexcept;
     void set_parent(ArrayParent* parent, size_t ndx_in_parent) noexcept;
     size_t get_ndx_in_parent() const noexcept;
-    void update_from_parent() noexcept;
-    void refresh_accessor_tree(const ClusterColumn& target_column);
+    virtual void update_from_parent() noexcept;
+    virtual void refresh_accessor_tree(const ClusterColumn& target_column);
     ref_type get_ref() const noexcept;
 
     // SearchIndex common base methods
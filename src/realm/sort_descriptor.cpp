@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <realm/sort_descriptor.hpp>
+#include <realm/index_sorted.hpp>
 #include <realm/table.hpp>
 #include <realm/table_view.hpp>
 #include <realm/db.hpp>
@@ -210,7 +211,7 @@ BaseDescriptor::Sorter::Sorter(std::vector<std::vector<ExtendedColumnKey>> const
 {
     REALM_ASSERT(!column_lists.empty());
     REALM_ASSERT_EX(column_lists.size() == ascending.size(), column_lists.size(), ascending.size());
-    size_t translated_size = std::max_element(indexes.begin(), indexes.end())->index_in_view + 1;
+    size_t translated_size = indexes.empty() ? 0 : std::max_element(indexes.begin(), indexes.end())->index_in_view + 1;
 
     m_columns.reserve(column_lists.size());
     for (size_t i = 0; i < column_lists.size(); ++i) {
@@ -316,25 +317,14 @@ void SortDescriptor::execute(IndexPairs& v, const Sorter& predicate, const BaseD
     if (next && next->get_type() == DescriptorType::Limit) {
         limit = static_cast<const LimitDescriptor*>(next)->get_limit();
     }
-    // Measurements shows that if limit is smaller than size / 16, then
-    // it is quicker to make a sorted insert into a smaller vector
-    if (limit < (v.size() >> 4)) {
-        IndexPairs buffer;
-        buffer.reserve(limit + 1);
-        for (auto& elem : v) {
-            auto it = std::lower_bound(buffer.begin(), buffer.end(), elem, std::ref(predicate));
-            buffer.insert(it, elem);
-            if (buffer.size() > limit) {
-                buffer.pop_back();
-            }
-        }
+    // Only the elements kept by the limit need to be sorted. The predicate is
+    // a total ordering, so they are the same as after sorting everything.
+    if (limit < v.size()) {
+        std::nth_element(v.begin(), v.begin() + limit, v.end(), std::ref(predicate));
         v.m_removed_by_limit += v.size() - limit;
         v.erase(v.begin() + limit, v.end());
-        std::move(buffer.begin(), buffer.end(), v.begin());
-    }
-    else {
-        std::sort(v.begin(), v.end(), std::ref(predicate));
     }
+    std::sort(v.begin(), v.end(), std::ref(predicate));
 
     // not doing this on the last step is an optimisation
     if (next) {
@@ -348,6 +338,58 @@ void SortDescriptor::execute(IndexPairs& v, const Sorter& predicate, const BaseD
     }
 }
 
+bool SortDescriptor::execute_using_index(const Table& table, IndexPairs& v, const BaseDescriptor* next) const
+{
+    // The walk visits all the objects of the table, so the view must hold a
+    // good part of them
+    constexpr size_t c_min_fraction_inverse = 8;
+
+    if (m_column_keys.size() != 1 || has_links() || m_column_keys[0][0].has_index())
+        return false;
+    ColKey col_key = m_column_keys[0][0];
+    // Unresolved links in Mixed columns are null in the index, but not when sorting
+    if (col_key.get_type() == col_type_Mixed || table.search_index_type(col_key) != IndexType::Sorted)
+        return false;
+    if (v.size() * c_min_fraction_inverse < table.size())
+        return false;
+
+    // Objects with the same value come in key order from the index, and must
+    // keep their order in the view, so the view must be in key order
+    for (size_t i = 1; i < v.size(); ++i) {
+        if (v[i].key_for_object <= v[i - 1].key_for_object || v[i].index_in_view <= v[i - 1].index_in_view)
+            return false;
+    }
+
+    size_t limit = size_t(-1);
+    if (next && next->get_type() == DescriptorType::Limit) {
+        limit = static_cast<const LimitDescriptor*>(next)->get_limit();
+    }
+
+    std::vector<IndexPair> sorted;
+    sorted.reserve(std::min(limit, v.size()));
+    table.get_sorted_index(col_key)->for_each_in_order(m_ascending[0], [&](ObjKey key) {
+        if (sorted.size() < limit) {
+            auto it = std::lower_bound(v.begin(), v.end(), key, [](const IndexPair& pair, ObjKey k) {
+                return pair.key_for_object < k;
+            });
+            if (it != v.end() && it->key_for_object == key)
+                sorted.push_back(*it);
+        }
+        return sorted.size() < limit;
+    });
+    REALM_ASSERT(sorted.size() == std::min(limit, v.size()));
+    v.m_removed_by_limit += v.size() - sorted.size();
+    v.swap(sorted);
+
+    if (next) {
+        const size_t v_size = v.size();
+        for (size_t i = 0; i < v_size; ++i) {
+            v[i].index_in_view = i;
+        }
+    }
+    return true;
+}
+
 std::string LimitDescriptor::get_description(ConstTableRef) const
 {
     return "LIMIT(" + util::serializer::print_value(m_limit) + ")";
@@ -463,23 +505,25 @@ void BaseDescriptor::Sorter::cache_first_column(IndexPairs& v)
     if (m_columns.empty())
         return;
 
+    for (auto& index : v)
+        cache_first_column(index);
+}
+
+void BaseDescriptor::Sorter::cache_first_column(IndexPair& index) const
+{
     auto& col = m_columns[0];
-    const auto& ck = col.col_key;
-    for (size_t i = 0; i < v.size(); i++) {
-        IndexPair& index = v[i];
-        ObjKey key = index.key_for_object;
-
-        if (!col.translated_keys.empty()) {
-            key = col.translated_keys[v[i].index_in_view];
-            if (!key) {
-                index.cached_value = Mixed();
-                continue;
-            }
-        }
+    ObjKey key = index.key_for_object;
 
-        const auto obj = col.table->get_object(key);
-        index.cached_value = ck.get_value(obj);
+    if (!col.translated_keys.empty()) {
+        key = col.translated_keys[index.index_in_view];
+        if (!key) {
+            index.cached_value = Mixed();
+            return;
+        }
     }
+
+    const auto obj = col.table->get_object(key);
+    index.cached_value = col.col_key.get_value(obj);
 }
 
 DescriptorOrdering::DescriptorOrdering(const DescriptorOrdering& other)
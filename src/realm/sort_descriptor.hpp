@@ -96,6 +96,7 @@ public:
             });
         }
         void cache_first_column(IndexPairs& v);
+        void cache_first_column(IndexPair& index) const;
 
     private:
         struct SortColumn {
@@ -164,6 +165,14 @@ public:
     }
     void collect_dependencies(const Table* table, std::vector<TableKey>& table_keys) const override;
 
+    // returns whether any of the columns is reached through links
+    bool has_links() const noexcept
+    {
+        return std::any_of(m_column_keys.begin(), m_column_keys.end(), [](auto& columns) {
+            return columns.size() > 1;
+        });
+    }
+
 protected:
     std::vector<std::vector<ExtendedColumnKey>> m_column_keys;
 };
@@ -243,6 +252,11 @@ public:
 
     void execute(IndexPairs& v, const Sorter& predicate, const BaseDescriptor* next) const override;
 
+    // Sorts `v` by walking the sorted index of the column instead of comparing
+    // values. Returns false if that is not possible or does not pay off, in
+    // which case `v` is left untouched.
+    bool execute_using_index(const Table& table, IndexPairs& v, const BaseDescriptor* next) const;
+
     std::string get_description(ConstTableRef attached_table) const override;
 
 private:
@@ -12,14 +12,16 @@ using namespace realm::util;
 
 InternString Changeset::intern_string(StringData str)
 {
-    if (InternString interned = find_string(str))
-        return interned;
+    update_string_index();
+    auto it = m_string_index.find(std::string_view(str));
+    if (it != m_string_index.end())
+        return InternString{it->second};
 
+    own_strings();
     REALM_ASSERT(m_string_buffer.size() < std::numeric_limits<uint32_t>::max());
     REALM_ASSERT(m_strings.size() < std::numeric_limits<uint32_t>::max());
     REALM_ASSERT(str.size() < std::numeric_limits<uint32_t>::max());
 
-    // FIXME: Very slow.
     uint32_t size = uint32_t(str.size());
     uint32_t offset = uint32_t(m_string_buffer.size());
     m_string_buffer.append(str.data(), size);
@@ -29,19 +31,46 @@ InternString Changeset::intern_string(StringData str)
 }
 
 
-InternString Changeset::find_string(StringData string) const noexcept
+InternString Changeset::find_string(StringData string) const
 {
-    // FIXME: Linear search can be very expensive as changesets can be very big
+    if (m_num_indexed_strings == m_strings.size() && m_indexed_string_data == string_data().data()) {
+        auto it = m_string_index.find(std::string_view(string));
+        if (it != m_string_index.end())
+            return InternString{it->second};
+        return InternString{};
+    }
+
     std::size_t n = m_strings.size();
     for (std::size_t i = 0; i < n; ++i) {
-        const auto& range = m_strings[i];
-        StringData string_2{m_string_buffer.data() + range.offset, range.size};
-        if (string_2 == string)
+        if (get_string(m_strings[i]) == string)
             return InternString{std::uint_least32_t(i)};
     }
     return InternString{};
 }
 
+void Changeset::own_strings()
+{
+    if (m_borrowed_strings) {
+        m_string_buffer.assign(m_borrowed_strings.data(), m_borrowed_strings.size());
+        m_borrowed_strings = StringData{};
+    }
+}
+
+void Changeset::update_string_index()
+{
+    const char* data = string_data().data();
+    if (data != m_indexed_string_data) {
+        m_string_index.clear();
+        m_num_indexed_strings = 0;
+        m_indexed_string_data = data;
+    }
+    for (; m_num_indexed_strings < m_strings.size(); ++m_num_indexed_strings) {
+        // The first of equal strings is kept, as found by a linear search
+        StringData string = get_string(m_strings[m_num_indexed_strings]);
+        m_string_index.emplace(std::string_view(string), uint32_t(m_num_indexed_strings));
+    }
+}
+
 PrimaryKey Changeset::get_key(const Instruction::PrimaryKey& key) const noexcept
 {
     return mpark::visit(overload{
@@ -205,13 +234,13 @@ void Changeset::verify() const
 {
     for (size_t i = 0; i < m_strings.size(); ++i) {
         auto& range = m_strings.at(i);
-        REALM_ASSERT(range.offset <= m_string_buffer.size());
-        REALM_ASSERT(range.offset + range.size <= m_string_buffer.size());
+        REALM_ASSERT(range.offset <= string_data().size());
+        REALM_ASSERT(range.offset + range.size <= string_data().size());
     }
 
     auto verify_string_range = [&](StringBufferRange range) {
-        REALM_ASSERT(range.offset <= m_string_buffer.size());
-        REALM_ASSERT(range.offset + range.size <= m_string_buffer.size());
+        REALM_ASSERT(range.offset <= string_data().size());
+        REALM_ASSERT(range.offset + range.size <= string_data().size());
     };
 
     auto verify_intern_string = [&](InternString str) {
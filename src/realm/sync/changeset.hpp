@@ -6,6 +6,7 @@
 #include <realm/util/optional.hpp>
 
 #include <type_traits>
+#include <unordered_map>
 
 namespace realm {
 namespace sync {
@@ -25,12 +26,18 @@ struct Changeset {
     using file_ident_type = uint_fast64_t;
     using version_type = uint_fast64_t; // FIXME: Get from `History`.
 
-    InternString intern_string(StringData);              // Slow!
-    InternString find_string(StringData) const noexcept; // Slow!
+    InternString intern_string(StringData);
+    InternString find_string(StringData) const;
     StringData string_data() const noexcept;
 
-    std::string& string_buffer() noexcept;
-    const std::string& string_buffer() const noexcept;
+    /// Let the strings of the changeset be kept in \a buffer rather than in a
+    /// buffer owned by the changeset, such that its StringBufferRanges are
+    /// offsets into \a buffer. This allows a changeset to be parsed without
+    /// copying its strings (see parse_changeset_in_place()). \a buffer must
+    /// outlive the changeset, or be alive until a string is added to the
+    /// changeset, which copies the strings first.
+    void borrow_strings(StringData buffer) noexcept;
+
     const InternStrings& interned_strings() const noexcept;
     InternStrings& interned_strings() noexcept;
 
@@ -122,6 +129,10 @@ struct Changeset {
     /// \a position exist in the program, they will either point to the
     /// subsequent element if that element was previously inserted with
     /// `insert_stable()`, or otherwise it will be turned into a tombstone.
+    ///
+    /// The returned iterator points to the instruction after the erased one,
+    /// which may be a tombstone. No other instructions are accessed, so
+    /// instructions at different positions may be erased concurrently.
     iterator erase_stable(const_iterator position);
 
 #if REALM_DEBUG
@@ -193,10 +204,20 @@ struct Changeset {
 private:
     std::vector<Instruction> m_instructions;
     std::string m_string_buffer;
+    StringData m_borrowed_strings;
     InternStrings m_strings;
     bool m_is_dirty = false;
 
+    // Maps the first m_num_indexed_strings interned strings to their index.
+    // The keys refer to the strings at m_indexed_string_data, so the map is
+    // rebuilt if the strings move.
+    std::unordered_map<std::string_view, uint32_t> m_string_index;
+    size_t m_num_indexed_strings = 0;
+    const char* m_indexed_string_data = nullptr;
+
     iterator const_iterator_to_iterator(const_iterator);
+    void own_strings();
+    void update_string_index();
 };
 
 std::ostream& operator<<(std::ostream&, const Changeset& changeset);
@@ -481,6 +502,9 @@ inline StringBufferRange Changeset::get_intern_string(InternString string) const
 
 inline InternStrings& Changeset::interned_strings() noexcept
 {
+    // The strings may be changed by the caller
+    m_string_index.clear();
+    m_num_indexed_strings = 0;
     return m_strings;
 }
 
@@ -489,23 +513,14 @@ inline const InternStrings& Changeset::interned_strings() const noexcept
     return m_strings;
 }
 
-inline auto Changeset::string_buffer() noexcept -> std::string&
-{
-    return m_string_buffer;
-}
-
-inline auto Changeset::string_buffer() const noexcept -> const std::string&
-{
-    return m_string_buffer;
-}
-
 inline util::Optional<StringData> Changeset::try_get_string(StringBufferRange range) const noexcept
 {
-    if (range.offset > m_string_buffer.size())
+    StringData strings = string_data();
+    if (range.offset > strings.size())
         return util::none;
-    if (range.offset + range.size > m_string_buffer.size())
+    if (range.offset + range.size > strings.size())
         return util::none;
-    return StringData{m_string_buffer.data() + range.offset, range.size};
+    return StringData{strings.data() + range.offset, range.size};
 }
 
 inline util::Optional<StringData> Changeset::try_get_string(InternString str) const noexcept
@@ -530,11 +545,20 @@ inline StringData Changeset::get_string(InternString string) const noexcept
 
 inline StringData Changeset::string_data() const noexcept
 {
+    if (m_borrowed_strings)
+        return m_borrowed_strings;
     return StringData{m_string_buffer.data(), m_string_buffer.size()};
 }
 
+inline void Changeset::borrow_strings(StringData buffer) noexcept
+{
+    REALM_ASSERT(m_string_buffer.empty());
+    m_borrowed_strings = buffer;
+}
+
 inline StringBufferRange Changeset::append_string(StringData string)
 {
+    own_strings();
     // We expect more strings. Only do this at the beginning because until C++20, reserve
     // will shrink_to_fit if the request is less than the current capacity.
     constexpr size_t small_string_buffer_size = 1024;
@@ -603,9 +627,7 @@ inline Changeset::iterator Changeset::erase_stable(const_iterator cpos)
     REALM_ASSERT(pos.m_inner < end);
     pos.m_inner->erase(pos.m_pos);
     if (pos.m_pos >= pos.m_inner->size()) {
-        do {
-            ++pos.m_inner;
-        } while (pos.m_inner != end && pos.m_inner->is_empty());
+        ++pos.m_inner;
         pos.m_pos = 0;
     }
     return pos;
@@ -108,12 +108,16 @@ struct UnreachableInstructionHandler : public InstructionHandler {
 };
 
 struct InstructionBuilder : InstructionHandler {
-    explicit InstructionBuilder(Changeset& log)
+    explicit InstructionBuilder(Changeset& log, StringData borrowed_strings = {})
         : m_log(log)
+        , m_borrowed_strings(borrowed_strings)
     {
         log.interned_strings().clear();
+        if (borrowed_strings)
+            log.borrow_strings(borrowed_strings);
     }
     Changeset& m_log;
+    StringData m_borrowed_strings;
 
     void operator()(const Instruction& instr) final
     {
@@ -122,7 +126,14 @@ struct InstructionBuilder : InstructionHandler {
 
     StringBufferRange add_string_range(StringData string) final
     {
-        return m_log.append_string(string);
+        if (!m_borrowed_strings)
+            return m_log.append_string(string);
+
+        // The input is a single buffer, so the string was read from it
+        size_t offset = string.data() - m_borrowed_strings.data();
+        REALM_ASSERT(string.data() >= m_borrowed_strings.data());
+        REALM_ASSERT(offset + string.size() <= m_borrowed_strings.size());
+        return StringBufferRange{uint32_t(offset), uint32_t(string.size())};
     }
 
     void set_intern_string(uint32_t index, StringBufferRange range) final
@@ -689,6 +700,16 @@ void parse_changeset(util::InputStream& input, Changeset& out_log)
         state.parse_one();
 }
 
+void parse_changeset_in_place(util::Span<const char> data, Changeset& out_log)
+{
+    util::SimpleInputStream input{data};
+    InstructionBuilder builder{out_log, StringData{data.data(), data.size()}};
+    State state{input, builder};
+
+    while (state.has_next())
+        state.parse_one();
+}
+
 OwnedMixed parse_base64_encoded_primary_key(std::string_view str)
 {
     auto bin_encoded = util::base64_decode_to_vector(str);
@@ -9,6 +9,11 @@
 namespace realm::sync {
 void parse_changeset(util::InputStream&, Changeset& out_log);
 
+// Parses a changeset held in a single buffer. The strings of the changeset are
+// not copied, but refer to `data`, which must outlive `out_log` (see
+// Changeset::borrow_strings()).
+void parse_changeset_in_place(util::Span<const char> data, Changeset& out_log);
+
 // The server may send us primary keys of objects in json-encoded error messages as base64-encoded changeset payloads.
 // This function takes such a base64-encoded payload and returns it parsed as an owned Mixed value. If it cannot
 // be decoded, this throws a BadChangeset exception.
@@ -129,6 +129,7 @@ private:
     const std::optional<std::string> m_ssl_trust_certificate_path;
     const std::function<SyncConfig::SSLVerifyCallback> m_ssl_verify_callback;
     const size_t m_flx_bootstrap_batch_size_bytes;
+    const size_t m_integration_batch_size_bytes;
     const std::string m_http_request_path_prefix;
     const std::string m_virt_path;
     const std::optional<ProxyConfig> m_proxy_config;
@@ -738,7 +739,8 @@ void SessionImpl::initiate_integrate_changesets(std::uint_fast64_t downloadable_
         version_type client_version;
         if (REALM_LIKELY(!get_client().is_dry_run())) {
             VersionInfo version_info;
-            integrate_changesets(progress, downloadable_bytes, changesets, version_info, batch_state); // Throws
+            integrate_changesets(progress, downloadable_bytes, changesets, version_info, batch_state,
+                                 m_wrapper.m_integration_batch_size_bytes); // Throws
             client_version = version_info.realm_version;
         }
         else {
@@ -892,7 +894,8 @@ void SessionImpl::process_pending_flx_bootstrap()
             [&](const Transaction& tr, util::Span<Changeset> changesets_applied) {
                 REALM_ASSERT_3(changesets_applied.size(), <=, pending_batch.changesets.size());
                 bootstrap_store->pop_front_pending(tr, changesets_applied.size());
-            });
+            },
+            m_wrapper.m_integration_batch_size_bytes);
         progress = *pending_batch.progress;
         changesets_processed += pending_batch.changesets.size();
         auto duration = std::chrono::steady_clock::now() - start_time;
@@ -1083,6 +1086,7 @@ SessionWrapper::SessionWrapper(ClientImpl& client, DBRef db, std::shared_ptr<Sub
     , m_ssl_trust_certificate_path{std::move(config.ssl_trust_certificate_path)}
     , m_ssl_verify_callback{std::move(config.ssl_verify_callback)}
     , m_flx_bootstrap_batch_size_bytes(config.flx_bootstrap_batch_size_bytes)
+    , m_integration_batch_size_bytes(config.integration_batch_size_bytes)
     , m_http_request_path_prefix{std::move(config.service_identifier)}
     , m_virt_path{std::move(config.realm_identifier)}
     , m_proxy_config{std::move(config.proxy_config)}
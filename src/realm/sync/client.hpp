@@ -324,6 +324,12 @@ public:
         /// changeset data in a single integration attempt.
         size_t flx_bootstrap_batch_size_bytes = 1024 * 1024;
 
+        /// When integrating received changesets, parse, transform and apply
+        /// them in batches of this many bytes of changeset data, and commit
+        /// each batch of a DOWNLOAD message outside of a bootstrap on its own.
+        /// The next batch is parsed while the previous one is applied.
+        size_t integration_batch_size_bytes = 1024 * 1024;
+
         /// Set to true to cause the integration of the first received changeset
         /// (in a DOWNLOAD message) to fail.
         ///
@@ -200,6 +200,10 @@ struct SyncConfig {
     // attempt. This many bytes of changesets will be uncompressed and held in memory while being applied.
     size_t flx_bootstrap_batch_size_bytes = 1024 * 1024;
 
+    // When integrating changesets received from the server, parse, transform and apply this many bytes of changeset
+    // data at a time. Outside of bootstraps, each batch is committed on its own, so that progress becomes visible.
+    size_t integration_batch_size_bytes = 1024 * 1024;
+
     // {@
     /// DEPRECATED - Will be removed in a future release
     // The following parameters are only used by the default SyncSocket implementation. Custom SyncSocket
@@ -29,11 +29,13 @@
 #include <realm/util/features.h>
 #include <realm/util/functional.hpp>
 #include <realm/util/scope_exit.hpp>
+#include <realm/util/worker_pool.hpp>
 #include <realm/version.hpp>
 
 #include <algorithm>
 #include <ctime>
 #include <cstring>
+#include <optional>
 #include <utility>
 
 namespace realm::sync {
@@ -423,7 +425,8 @@ void ClientHistory::integrate_server_changesets(
     const SyncProgress& progress, DownloadableProgress downloadable_bytes,
     util::Span<const RemoteChangeset> incoming_changesets, VersionInfo& version_info, DownloadBatchState batch_state,
     util::Logger& logger, const TransactionRef& transact,
-    util::UniqueFunction<void(const Transaction&, util::Span<Changeset>)> run_in_write_tr)
+    util::UniqueFunction<void(const Transaction&, util::Span<Changeset>)> run_in_write_tr,
+    std::size_t batch_size_bytes)
 {
     REALM_ASSERT(incoming_changesets.size() != 0);
     REALM_ASSERT(
@@ -432,30 +435,42 @@ void ClientHistory::integrate_server_changesets(
     std::vector<Changeset> changesets;
     changesets.resize(incoming_changesets.size()); // Throws
 
-    // Parse incoming changesets without holding the write lock unless 'transact' is specified.
-    try {
-        for (std::size_t i = 0; i < incoming_changesets.size(); ++i) {
-            const RemoteChangeset& changeset = incoming_changesets[i];
-            parse_remote_changeset(changeset, changesets[i]); // Throws
-            changesets[i].transform_sequence = i;
+    // The changesets are parsed in batches of about `batch_size_bytes`, and the
+    // next batch is parsed while the previous one is transformed and applied.
+    // Parsing does not need the write lock. Returns the end of the batch.
+    auto parse_batch = [&](std::size_t begin) -> std::size_t {
+        std::size_t end = begin;
+        std::size_t size = 0;
+        try {
+            while (end < incoming_changesets.size() && (end == begin || size < batch_size_bytes)) {
+                const RemoteChangeset& changeset = incoming_changesets[end];
+                parse_remote_changeset(changeset, changesets[end]); // Throws
+                changesets[end].transform_sequence = end;
+                size += changeset.data.size();
+                ++end;
+            }
         }
-    }
-    catch (const BadChangesetError& e) {
-        throw IntegrationException(ErrorCodes::BadChangeset,
-                                   util::format("Failed to parse received changeset: %1", e.what()),
-                                   ProtocolError::bad_changeset);
-    }
+        catch (const BadChangesetError& e) {
+            throw IntegrationException(ErrorCodes::BadChangeset,
+                                       util::format("Failed to parse received changeset: %1", e.what()),
+                                       ProtocolError::bad_changeset);
+        }
+        return end;
+    };
 
     VersionID new_version{0, 0};
     auto num_changesets = incoming_changesets.size();
-    util::Span<Changeset> changesets_to_integrate(changesets);
+    std::size_t num_integrated = 0;
+    std::size_t batch_end = parse_batch(0); // Throws
+    std::size_t num_parsed = batch_end;
     const bool allow_lock_release = batch_state == DownloadBatchState::SteadyState;
 
     // Ideally, this loop runs only once, but it can run up to `incoming_changesets.size()` times, depending on the
     // number of times the sync client yields the write lock to allow the user to commit their changes.
-    // In each iteration, at least one changeset is transformed and committed.
+    // In each iteration, at least one changeset is transformed and committed. In steady state, each batch is
+    // committed on its own, so that readers see the progress.
     // In FLX, all changesets are committed at once in the bootstrap phase (i.e, in one iteration).
-    while (!changesets_to_integrate.empty()) {
+    while (num_integrated < num_changesets) {
         if (transact->get_transact_stage() == DB::transact_Reading) {
             transact->promote_to_write(); // Throws
         }
@@ -468,8 +483,30 @@ void ClientHistory::integrate_server_changesets(
         prepare_for_write();           // Throws
 
         std::uint64_t downloaded_bytes_in_transaction = 0;
-        auto changesets_transformed_count = transform_and_apply_server_changesets(
-            changesets_to_integrate, transact, logger, downloaded_bytes_in_transaction, allow_lock_release);
+        std::size_t begin = num_integrated;
+        do {
+            // The changesets are transformed and applied by this thread, which
+            // owns the write transaction. Only the parsing of the next batch
+            // is handed to the worker pool meanwhile.
+            std::size_t next_batch_end = 0;
+            auto parse_next_batch = [&] {
+                next_batch_end = parse_batch(num_parsed); // Throws
+            };
+            std::optional<util::WorkerPool::Task> parsing;
+            if (num_parsed == batch_end && num_parsed < num_changesets)
+                parsing.emplace(util::WorkerPool::get_default().start(parse_next_batch)); // Throws
+            util::Span<Changeset> batch(changesets.data() + num_integrated, batch_end - num_integrated);
+            std::size_t changesets_transformed_count = transform_and_apply_server_changesets(
+                batch, transact, logger, downloaded_bytes_in_transaction, allow_lock_release); // Throws
+            if (parsing) {
+                parsing->join(); // Throws
+                num_parsed = next_batch_end;
+            }
+            num_integrated += changesets_transformed_count;
+            if (num_integrated == batch_end)
+                batch_end = num_parsed;
+        } while (num_integrated < num_changesets && !allow_lock_release);
+        std::size_t changesets_transformed_count = num_integrated - begin;
 
         // downloaded_bytes always contains the total number of downloaded bytes
         // from the Realm. downloaded_bytes must be persisted in the Realm, since
@@ -481,24 +518,23 @@ void ClientHistory::integrate_server_changesets(
         downloaded_bytes += downloaded_bytes_in_transaction;
         root.set(s_progress_downloaded_bytes_iip, RefOrTagged::make_tagged(downloaded_bytes)); // Throws
 
-        const RemoteChangeset& last_changeset = incoming_changesets[changesets_transformed_count - 1];
-        auto changesets_for_cb = changesets_to_integrate.first(changesets_transformed_count);
-        changesets_to_integrate = changesets_to_integrate.sub_span(changesets_transformed_count);
-        incoming_changesets = incoming_changesets.sub_span(changesets_transformed_count);
+        const RemoteChangeset& last_changeset = incoming_changesets[num_integrated - 1];
+        util::Span<Changeset> changesets_for_cb(changesets.data() + begin, changesets_transformed_count);
+        bool all_integrated = num_integrated == num_changesets;
 
         // During the bootstrap phase in flexible sync, the server sends multiple download messages with the same
         // synthetic server version that represents synthetic changesets generated from state on the server.
-        if (batch_state == DownloadBatchState::LastInBatch && changesets_to_integrate.empty()) {
+        if (batch_state == DownloadBatchState::LastInBatch && all_integrated) {
             update_sync_progress(progress, downloadable_bytes); // Throws
         }
         // Always update progress for download messages from steady state.
-        else if (batch_state == DownloadBatchState::SteadyState && !changesets_to_integrate.empty()) {
+        else if (batch_state == DownloadBatchState::SteadyState && !all_integrated) {
             auto partial_progress = progress;
             partial_progress.download.server_version = last_changeset.remote_version;
             partial_progress.download.last_integrated_client_version = last_changeset.last_integrated_local_version;
             update_sync_progress(partial_progress, downloadable_bytes); // Throws
         }
-        else if (batch_state == DownloadBatchState::SteadyState && changesets_to_integrate.empty()) {
+        else if (batch_state == DownloadBatchState::SteadyState && all_integrated) {
             update_sync_progress(progress, downloadable_bytes); // Throws
         }
         if (run_in_write_tr) {
@@ -523,13 +559,17 @@ void ClientHistory::integrate_server_changesets(
         m_applying_server_changeset = true;
         // Commit and continue to write if in bootstrap phase and there are still changes to integrate.
         if (batch_state == DownloadBatchState::MoreToCome ||
-            (batch_state == DownloadBatchState::LastInBatch && !changesets_to_integrate.empty())) {
+            (batch_state == DownloadBatchState::LastInBatch && !all_integrated)) {
             new_version = transact->commit_and_continue_writing(); // Throws
         }
         else {
             new_version = transact->commit_and_continue_as_read(); // Throws
         }
 
+        // Only the changesets which are still to be integrated are kept in memory
+        for (Changeset& changeset : changesets_for_cb)
+            changeset = Changeset{};
+
         logger.debug(util::LogCategory::changeset, "Integrated %1 changesets out of %2", changesets_transformed_count,
                      num_changesets);
     }
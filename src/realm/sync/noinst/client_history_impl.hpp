@@ -248,11 +248,17 @@ public:
     /// the server changesets after they were transformed.
     /// Note: In FLX, the transaction is left in reading state when bootstrap ends.
     /// In all other cases, the transaction is left in reading state when the function returns.
+    ///
+    /// \param batch_size_bytes The changesets are parsed, transformed and
+    /// applied in batches of about this many bytes of changeset data, and a
+    /// batch is parsed while the previous one is applied. In steady state,
+    /// each batch is committed on its own.
     void integrate_server_changesets(
         const SyncProgress& progress, DownloadableProgress downloadable_bytes,
         util::Span<const RemoteChangeset> changesets, VersionInfo& new_version, DownloadBatchState download_type,
         util::Logger&, const TransactionRef& transact,
-        util::UniqueFunction<void(const Transaction&, util::Span<Changeset>)> run_in_write_tr = nullptr);
+        util::UniqueFunction<void(const Transaction&, util::Span<Changeset>)> run_in_write_tr = nullptr,
+        std::size_t batch_size_bytes = std::numeric_limits<std::size_t>::max());
 
     static void get_upload_download_state(Transaction&, Allocator& alloc, std::uint_fast64_t&, DownloadableProgress&,
                                           std::uint_fast64_t&, std::uint_fast64_t&, std::uint_fast64_t&,
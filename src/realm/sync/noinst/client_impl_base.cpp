@@ -776,7 +776,13 @@ void Connection::initiate_reconnect()
         for (int version = max; version >= min; --version) {
             sec_websocket_protocol.push_back(util::format("%1%2", protocol_prefix, version)); // Throws
         }
+        // Offer the body codecs that the server may use for DOWNLOAD messages.
+        for (BodyCodec codec : supported_body_codecs) {
+            sec_websocket_protocol.push_back(
+                util::format("%1%2", get_body_codec_websocket_protocol_prefix(), to_string(codec))); // Throws
+        }
     }
+    m_upload_body_codec = BodyCodec::zlib;
 
     logger.info("Connecting to '%1%2:%3%4'", to_string(m_server_endpoint.envelope), m_server_endpoint.address,
                 m_server_endpoint.port, m_http_request_path_prefix);
@@ -1386,6 +1392,11 @@ void Connection::receive_download_message(session_ident_type session_ident, cons
         return;
     }
 
+    // Compress uploads the way the server compresses downloads, as that is a
+    // codec both sides support.
+    if (message.body_codec != BodyCodec::none)
+        m_upload_body_codec = message.body_codec;
+
     if (auto status = sess->receive_download_message(message); !status.is_ok()) {
         close_due_to_protocol_error(std::move(status));
     }
@@ -1562,7 +1573,7 @@ void Session::gather_pending_compensating_writes(util::Span<Changeset> changeset
 
 void Session::integrate_changesets(const SyncProgress& progress, std::uint_fast64_t downloadable_bytes,
                                    const ReceivedChangesets& received_changesets, VersionInfo& version_info,
-                                   DownloadBatchState download_batch_state)
+                                   DownloadBatchState download_batch_state, std::size_t batch_size_bytes)
 {
     auto& history = get_history();
     if (received_changesets.empty()) {
@@ -1581,7 +1592,8 @@ void Session::integrate_changesets(const SyncProgress& progress, std::uint_fast6
         progress, downloadable_bytes, received_changesets, version_info, download_batch_state, logger, transact,
         [&](const Transaction&, util::Span<Changeset> changesets) {
             gather_pending_compensating_writes(changesets, &pending_compensating_write_errors);
-        }); // Throws
+        },
+        batch_size_bytes); // Throws
     if (received_changesets.size() == 1) {
         logger.debug("1 remote changeset integrated, producing client version %1",
                      version_info.sync_version.version); // Throws
@@ -2069,7 +2081,8 @@ void Session::send_upload_message()
                  uploadable_changesets.size()); // Throws
 
     ClientProtocol& protocol = m_conn.get_client_protocol();
-    ClientProtocol::UploadMessageBuilder upload_message_builder = protocol.make_upload_message_builder(); // Throws
+    ClientProtocol::UploadMessageBuilder upload_message_builder =
+        protocol.make_upload_message_builder(m_conn.get_upload_body_codec()); // Throws
 
     for (const UploadChangeset& uc : uploadable_changesets) {
         logger.debug(util::LogCategory::changeset,
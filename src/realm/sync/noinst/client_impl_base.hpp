@@ -473,6 +473,11 @@ public:
     /// than or equal to get_current_protocol_version().
     int get_negotiated_protocol_version() noexcept;
 
+    /// The codec used for the bodies of UPLOAD messages. This is zlib, which
+    /// every server accepts, until a compressed DOWNLOAD message is received,
+    /// and the codec of the last one after that.
+    BodyCodec get_upload_body_codec() const noexcept;
+
     // Methods from WebSocketObserver interface for websockets from the Socket Provider
     void websocket_connected_handler(const std::string& protocol);
     bool websocket_binary_message_received(util::Span<const char> data);
@@ -608,6 +613,7 @@ private:
 
     ReconnectInfo m_reconnect_info;
     int m_negotiated_protocol_version = 0;
+    BodyCodec m_upload_body_codec = BodyCodec::zlib;
 
     ConnectionState m_state = ConnectionState::disconnected;
 
@@ -793,7 +799,7 @@ public:
     /// To be used in connection with implementations of
     /// initiate_integrate_changesets().
     void integrate_changesets(const SyncProgress&, std::uint_fast64_t downloadable_bytes, const ReceivedChangesets&,
-                              VersionInfo&, DownloadBatchState batch_state);
+                              VersionInfo&, DownloadBatchState batch_state, std::size_t batch_size_bytes);
 
     /// It is an error to call this function before activation of the session
     /// (Connection::activate_session()), or after initiation of deactivation
@@ -1195,6 +1201,11 @@ inline int ClientImpl::Connection::get_negotiated_protocol_version() noexcept
     return m_negotiated_protocol_version;
 }
 
+inline BodyCodec ClientImpl::Connection::get_upload_body_codec() const noexcept
+{
+    return m_upload_body_codec;
+}
+
 template <class H>
 void ClientImpl::Connection::for_each_active_session(H handler)
 {
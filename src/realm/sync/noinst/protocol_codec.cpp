@@ -7,6 +7,37 @@ namespace realm::_impl {
 
 using OutputBuffer = util::ResettableExpandableBufferOutputStream;
 
+sync::BodyCodec compress_message_body(sync::BodyCodec codec, util::compression::CompressMemoryArena& arena,
+                                      BinaryData body, std::vector<char>& out, int compression_level)
+{
+    std::error_code ec;
+    switch (codec) {
+        case sync::BodyCodec::none:
+            return codec;
+        case sync::BodyCodec::zlib:
+            ec = util::compression::allocate_and_compress(arena, body, out, compression_level); // Throws
+            break;
+    }
+    // The body is sent as is if it could not be made smaller.
+    if (ec || out.size() >= body.size())
+        return sync::BodyCodec::none;
+    return codec;
+}
+
+std::error_code decompress_message_body(sync::BodyCodec codec, BinaryData body, util::Span<char> out)
+{
+    switch (codec) {
+        case sync::BodyCodec::none:
+            if (body.size() != out.size())
+                return util::compression::error::incorrect_decompressed_size;
+            std::copy(body.data(), body.data() + body.size(), out.data());
+            return std::error_code{};
+        case sync::BodyCodec::zlib:
+            return util::compression::decompress(body, out);
+    }
+    return util::compression::error::decompress_unsupported;
+}
+
 // Client protocol
 
 void ClientProtocol::make_pbs_bind_message(int protocol_version, OutputBuffer& out, session_ident_type session_ident,
@@ -85,10 +116,11 @@ void ClientProtocol::make_test_command_message(OutputBuffer& out, session_ident_
 
 ClientProtocol::UploadMessageBuilder::UploadMessageBuilder(
     OutputBuffer& body_buffer, std::vector<char>& compression_buffer,
-    util::compression::CompressMemoryArena& compress_memory_arena)
+    util::compression::CompressMemoryArena& compress_memory_arena, sync::BodyCodec body_codec)
     : m_body_buffer{body_buffer}
     , m_compression_buffer{compression_buffer}
     , m_compress_memory_arena{compress_memory_arena}
+    , m_body_codec{body_codec}
 {
     m_body_buffer.reset();
 }
@@ -117,18 +149,18 @@ void ClientProtocol::UploadMessageBuilder::make_upload_message(int protocol_vers
 
     constexpr std::size_t g_max_uncompressed = 1024;
 
-    bool is_body_compressed = false;
+    sync::BodyCodec body_codec = sync::BodyCodec::none;
     if (body.size() > g_max_uncompressed) {
-        util::compression::allocate_and_compress(m_compress_memory_arena, body,
-                                                 m_compression_buffer); // Throws
-        is_body_compressed = m_compression_buffer.size() < body.size();
+        body_codec = compress_message_body(m_body_codec, m_compress_memory_arena, body,
+                                           m_compression_buffer); // Throws
     }
 
     // The compressed body is only sent if it is smaller than the uncompressed body.
+    bool is_body_compressed = (body_codec != sync::BodyCodec::none);
     std::size_t compressed_body_size = is_body_compressed ? m_compression_buffer.size() : 0;
 
     // The header of the upload message.
-    out << "upload " << session_ident << " " << int(is_body_compressed) << " " << body.size() << " "
+    out << "upload " << session_ident << " " << int(body_codec) << " " << body.size() << " "
         << compressed_body_size;
     out << " " << progress_client_version << " " << progress_server_version << " " << locked_server_version; // Throws
     out << "\n";                                                                                             // Throws
@@ -141,9 +173,9 @@ void ClientProtocol::UploadMessageBuilder::make_upload_message(int protocol_vers
     REALM_ASSERT(!out.fail());
 }
 
-ClientProtocol::UploadMessageBuilder ClientProtocol::make_upload_message_builder()
+ClientProtocol::UploadMessageBuilder ClientProtocol::make_upload_message_builder(sync::BodyCodec body_codec)
 {
-    return UploadMessageBuilder{m_output_buffer, m_buffer, m_compress_memory_arena};
+    return UploadMessageBuilder{m_output_buffer, m_buffer, m_compress_memory_arena, body_codec};
 }
 
 void ClientProtocol::make_unbind_message(OutputBuffer& out, session_ident_type session_ident)
@@ -235,27 +267,27 @@ void ServerProtocol::make_download_message(int protocol_version, OutputBuffer& o
                                            version_type upload_client_version, version_type upload_server_version,
                                            std::uint_fast64_t downloadable_bytes, std::size_t num_changesets,
                                            const char* body, std::size_t uncompressed_body_size,
-                                           std::size_t compressed_body_size, bool body_is_compressed,
+                                           std::size_t compressed_body_size, sync::BodyCodec body_codec,
                                            util::Logger& logger)
 {
     static_cast<void>(protocol_version);
     // The header of the download message.
     out << "download " << session_ident << " " << download_server_version << " " << download_client_version << " "
         << latest_server_version << " " << latest_server_version_salt << " " << upload_client_version << " "
-        << upload_server_version << " " << downloadable_bytes << " " << int(body_is_compressed) << " "
+        << upload_server_version << " " << downloadable_bytes << " " << int(body_codec) << " "
         << uncompressed_body_size << " " << compressed_body_size << "\n"; // Throws
 
-    std::size_t body_size = (body_is_compressed ? compressed_body_size : uncompressed_body_size);
+    std::size_t body_size = (body_codec != sync::BodyCodec::none ? compressed_body_size : uncompressed_body_size);
     out.write(body, body_size);
 
     logger.detail(util::LogCategory::changeset,
                   "Sending: DOWNLOAD(download_server_version=%1, download_client_version=%2, "
                   "latest_server_version=%3, latest_server_version_salt=%4, "
                   "upload_client_version=%5, upload_server_version=%6, "
-                  "num_changesets=%7, is_body_compressed=%8, body_size=%9, "
+                  "num_changesets=%7, body_codec=%8, body_size=%9, "
                   "compressed_body_size=%10)",
                   download_server_version, download_client_version, latest_server_version, latest_server_version_salt,
-                  upload_client_version, upload_server_version, num_changesets, body_is_compressed,
+                  upload_client_version, upload_server_version, num_changesets, sync::to_string(body_codec),
                   uncompressed_body_size, compressed_body_size); // Throws
 }
 
@@ -151,6 +151,18 @@ private:
     std::string_view m_sv;
 };
 
+/// Encodes the body of an UPLOAD or DOWNLOAD message with \a codec, storing
+/// the result in \a out. Returns the codec to announce in the message header,
+/// which is \a codec if the encoded body is smaller than \a body, and
+/// sync::BodyCodec::none otherwise, in which case \a body is to be sent as is.
+/// \a compression_level is passed on to the codecs that have one.
+sync::BodyCodec compress_message_body(sync::BodyCodec codec, util::compression::CompressMemoryArena&,
+                                      BinaryData body, std::vector<char>& out, int compression_level = 1);
+
+/// Decodes a message body that was encoded with \a codec. The size of \a out
+/// must be the uncompressed body size announced in the message header.
+std::error_code decompress_message_body(sync::BodyCodec codec, BinaryData body, util::Span<char> out);
+
 class ClientProtocol {
 public:
     // clang-format off
@@ -198,7 +210,8 @@ public:
     class UploadMessageBuilder {
     public:
         UploadMessageBuilder(OutputBuffer& body_buffer, std::vector<char>& compression_buffer,
-                             util::compression::CompressMemoryArena& compress_memory_arena);
+                             util::compression::CompressMemoryArena& compress_memory_arena,
+                             sync::BodyCodec body_codec);
 
         void add_changeset(version_type client_version, version_type server_version, timestamp_type origin_timestamp,
                            file_ident_type origin_file_ident, ChunkedBinaryData changeset);
@@ -212,9 +225,12 @@ public:
         OutputBuffer& m_body_buffer;
         std::vector<char>& m_compression_buffer;
         util::compression::CompressMemoryArena& m_compress_memory_arena;
+        const sync::BodyCodec m_body_codec;
     };
 
-    UploadMessageBuilder make_upload_message_builder();
+    /// \a body_codec is the codec used for the message body when compressing
+    /// it pays off.
+    UploadMessageBuilder make_upload_message_builder(sync::BodyCodec body_codec);
 
     void make_unbind_message(OutputBuffer&, session_ident_type session_ident);
 
@@ -407,6 +423,7 @@ public:
         sync::DownloadBatchState batch_state = sync::DownloadBatchState::SteadyState;
         sync::DownloadableProgress downloadable;
         ReceivedChangesets changesets;
+        sync::BodyCodec body_codec = sync::BodyCodec::none;
     };
 
 private:
@@ -455,34 +472,40 @@ private:
         else
             message.downloadable = uint64_t(msg.read_next<int64_t>());
 
-        auto is_body_compressed = msg.read_next<bool>();
+        auto body_codec = msg.read_next<int>();
         auto uncompressed_body_size = msg.read_next<size_t>();
         auto compressed_body_size = msg.read_next<size_t>('\n');
 
+        if (!sync::is_valid_body_codec(body_codec))
+            return report_error(ErrorCodes::SyncProtocolInvariantFailed, "Bad body codec: %1", body_codec);
+        message.body_codec = sync::BodyCodec(body_codec);
+
         if (uncompressed_body_size > s_max_body_size) {
             auto header = msg_with_header.substr(0, msg_with_header.size() - msg.remaining().size());
             return report_error(ErrorCodes::LimitExceeded, "Limits exceeded in input message '%1'", header);
         }
 
         std::unique_ptr<char[]> uncompressed_body_buffer;
-        // if is_body_compressed == true, we must decompress the received body.
-        if (is_body_compressed) {
+        // Unless the body was sent as is, we must decompress it.
+        if (message.body_codec != sync::BodyCodec::none) {
             uncompressed_body_buffer = std::make_unique<char[]>(uncompressed_body_size);
             std::error_code ec =
-                util::compression::decompress({msg.remaining().data(), compressed_body_size},
-                                              {uncompressed_body_buffer.get(), uncompressed_body_size});
+                decompress_message_body(message.body_codec, {msg.remaining().data(), compressed_body_size},
+                                        {uncompressed_body_buffer.get(), uncompressed_body_size});
 
             if (ec) {
-                return report_error(ErrorCodes::RuntimeError, "compression::inflate: %1", ec.message());
+                return report_error(ErrorCodes::RuntimeError, "Failed to decompress %1 body: %2",
+                                    sync::to_string(message.body_codec), ec.message());
             }
 
             msg = HeaderLineParser(std::string_view(uncompressed_body_buffer.get(), uncompressed_body_size));
         }
 
         logger.debug(util::LogCategory::changeset,
-                     "Download message compression: session_ident=%1, is_body_compressed=%2, "
+                     "Download message compression: session_ident=%1, body_codec=%2, "
                      "compressed_body_size=%3, uncompressed_body_size=%4",
-                     session_ident, is_body_compressed, compressed_body_size, uncompressed_body_size);
+                     session_ident, sync::to_string(message.body_codec), compressed_body_size,
+                     uncompressed_body_size);
 
         // Loop through the body and find the changesets.
         while (!msg.at_end()) {
@@ -673,7 +696,7 @@ public:
                                version_type upload_client_version, version_type upload_server_version,
                                std::uint_fast64_t downloadable_bytes, std::size_t num_changesets, const char* body,
                                std::size_t uncompressed_body_size, std::size_t compressed_body_size,
-                               bool body_is_compressed, util::Logger&);
+                               sync::BodyCodec body_codec, util::Logger&);
 
     void make_mark_message(OutputBuffer&, session_ident_type session_ident, request_ident_type request_ident);
 
@@ -742,14 +765,20 @@ public:
             if (message_type == "upload") {
                 auto msg_with_header = msg.remaining();
                 auto session_ident = msg.read_next<session_ident_type>();
-                auto is_body_compressed = msg.read_next<bool>();
+                auto body_codec_value = msg.read_next<int>();
                 auto uncompressed_body_size = msg.read_next<size_t>();
                 auto compressed_body_size = msg.read_next<size_t>();
                 auto progress_client_version = msg.read_next<version_type>();
                 auto progress_server_version = msg.read_next<version_type>();
                 auto locked_server_version = msg.read_next<version_type>('\n');
 
-                std::size_t body_size = (is_body_compressed ? compressed_body_size : uncompressed_body_size);
+                if (!sync::is_valid_body_codec(body_codec_value))
+                    return report_error(ErrorCodes::SyncProtocolInvariantFailed, "Bad body codec: %1",
+                                        body_codec_value);
+                auto body_codec = sync::BodyCodec(body_codec_value);
+
+                std::size_t body_size =
+                    (body_codec != sync::BodyCodec::none ? compressed_body_size : uncompressed_body_size);
                 if (body_size > s_max_body_size) {
                     auto header = msg_with_header.substr(0, msg_with_header.size() - msg.bytes_remaining());
 
@@ -759,27 +788,28 @@ public:
 
 
                 std::unique_ptr<char[]> uncompressed_body_buffer;
-                // if is_body_compressed == true, we must decompress the received body.
-                if (is_body_compressed) {
+                // Unless the body was sent as is, we must decompress it.
+                if (body_codec != sync::BodyCodec::none) {
                     uncompressed_body_buffer = std::make_unique<char[]>(uncompressed_body_size);
                     auto compressed_body = msg.read_sized_data<BinaryData>(compressed_body_size);
 
-                    std::error_code ec = util::compression::decompress(
-                        compressed_body, {uncompressed_body_buffer.get(), uncompressed_body_size});
+                    std::error_code ec = decompress_message_body(
+                        body_codec, compressed_body, {uncompressed_body_buffer.get(), uncompressed_body_size});
 
                     if (ec) {
-                        return report_error(ErrorCodes::RuntimeError, "compression::inflate: %1", ec.message());
+                        return report_error(ErrorCodes::RuntimeError, "Failed to decompress %1 body: %2",
+                                            sync::to_string(body_codec), ec.message());
                     }
 
                     msg = HeaderLineParser(std::string_view(uncompressed_body_buffer.get(), uncompressed_body_size));
                 }
 
                 logger.debug(util::LogCategory::changeset,
-                             "Upload message compression: is_body_compressed = %1, "
+                             "Upload message compression: body_codec=%1, "
                              "compressed_body_size=%2, uncompressed_body_size=%3, "
                              "progress_client_version=%4, progress_server_version=%5, "
                              "locked_server_version=%6",
-                             is_body_compressed, compressed_body_size, uncompressed_body_size,
+                             sync::to_string(body_codec), compressed_body_size, uncompressed_body_size,
                              progress_client_version, progress_server_version, locked_server_version); // Throws
 
 
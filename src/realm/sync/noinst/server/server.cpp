@@ -190,6 +190,7 @@ bool determine_try_again(ProtocolError error_code) noexcept
 
 class ServerFile;
 class ServerImpl;
+class Worker;
 class HTTPConnection;
 class SyncConnection;
 class Session;
@@ -222,7 +223,10 @@ struct DownloadCache {
     std::unique_ptr<char[]> body;
     std::size_t uncompressed_body_size;
     std::size_t compressed_body_size;
-    bool body_is_compressed;
+    // The codec the body was prepared for, and the one it is encoded with,
+    // which is BodyCodec::none when compression did not pay off.
+    BodyCodec requested_body_codec;
+    BodyCodec body_codec;
     version_type end_version;
     DownloadCursor download_progress;
     std::uint_fast64_t downloadable_bytes;
@@ -431,8 +435,8 @@ public:
     // Logger to be used by the worker thread
     util::PrefixLogger wlogger;
 
-    ServerFile(ServerImpl& server, ServerFileAccessCache& cache, const std::string& virt_path, std::string real_path,
-               bool disable_sync_to_disk);
+    ServerFile(ServerImpl& server, ServerFileAccessCache& cache, Worker& worker, const std::string& virt_path,
+               std::string real_path, bool disable_sync_to_disk);
     ~ServerFile() noexcept;
 
     void initialize();
@@ -537,6 +541,7 @@ public:
 
 private:
     ServerImpl& m_server;
+    Worker& m_worker;
     ServerFileAccessCache::Slot m_file;
 
     // In general, `m_version_info` refers to the last snapshot of the Realm
@@ -701,12 +706,17 @@ inline void ServerFile::group_finalize_work_stage_2()
 //
 // FIXME: Currently, the event loop thread does perform a number of write
 // transactions, but only on subtier nodes of a star topology server cluster.
+//
+// When there are several workers (Server::Config::num_workers), each Realm
+// file is served by the same one throughout the life of the server (see
+// ServerImpl::assign_worker()), so no two threads ever write to it
+// concurrently.
 class Worker : public ServerHistory::Context {
 public:
     std::shared_ptr<util::Logger> logger_ptr;
     util::Logger& logger;
 
-    explicit Worker(ServerImpl&);
+    Worker(ServerImpl&, unsigned index);
 
     ServerFileAccessCache& get_file_access_cache() noexcept;
 
@@ -826,9 +836,13 @@ public:
         return m_scratch_memory;
     }
 
-    Worker& get_worker() noexcept
+    // Workers are assigned round-robin as files are opened. Files are never
+    // closed, so this spreads them evenly however their paths are named.
+    Worker& assign_worker() noexcept
     {
-        return m_worker;
+        Worker& worker = *m_workers[m_next_worker];
+        m_next_worker = (m_next_worker + 1) % m_workers.size();
+        return worker;
     }
 
     void get_workunit_timers(milliseconds_type& parallel_section, milliseconds_type& sequential_section)
@@ -899,8 +913,8 @@ public:
         m_realm_names.insert(virt_path);         // Throws
         {
             bool disable_sync_to_disk = m_config.disable_sync_to_disk;
-            file.reset(new ServerFile(*this, m_file_access_cache, virt_path, virt_path_components.real_realm_path,
-                                      disable_sync_to_disk)); // Throws
+            file.reset(new ServerFile(*this, m_file_access_cache, assign_worker(), virt_path,
+                                      virt_path_components.real_realm_path, disable_sync_to_disk)); // Throws
         }
 
         file->initialize();
@@ -997,7 +1011,8 @@ private:
 
     std::unique_ptr<network::ssl::Context> m_ssl_context;
     ServerFileAccessCache m_file_access_cache;
-    Worker m_worker;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::size_t m_next_worker = 0;
     std::map<std::string, util::bind_ptr<ServerFile>> m_files; // Key is virtual path
     network::Acceptor m_acceptor;
     std::int_fast64_t m_next_conn_id = 0;
@@ -1079,7 +1094,8 @@ public:
     SyncConnection(ServerImpl& serv, std::int_fast64_t id, std::unique_ptr<network::Socket>&& socket,
                    std::unique_ptr<network::ssl::Stream>&& ssl_stream,
                    std::unique_ptr<network::ReadAheadBuffer>&& read_ahead_buffer, int client_protocol_version,
-                   std::string client_user_agent, std::string remote_endpoint, std::string appservices_request_id)
+                   BodyCodec download_body_codec, std::string client_user_agent, std::string remote_endpoint,
+                   std::string appservices_request_id)
         : logger_ptr{std::make_shared<util::PrefixLogger>(util::LogCategory::server, make_logger_prefix(id),
                                                           serv.logger_ptr)} // Throws
         , logger{*logger_ptr}
@@ -1090,6 +1106,7 @@ public:
         , m_read_ahead_buffer{std::move(read_ahead_buffer)}
         , m_websocket{*this}
         , m_client_protocol_version{client_protocol_version}
+        , m_download_body_codec{download_body_codec}
         , m_client_user_agent{std::move(client_user_agent)}
         , m_remote_endpoint{std::move(remote_endpoint)}
         , m_appservices_request_id{std::move(appservices_request_id)}
@@ -1125,6 +1142,11 @@ public:
         return m_client_protocol_version;
     }
 
+    BodyCodec get_download_body_codec() const noexcept
+    {
+        return m_download_body_codec;
+    }
+
     const std::string& get_client_user_agent() const noexcept
     {
         return m_client_user_agent;
@@ -1318,6 +1340,10 @@ private:
     // The protocol version in use by the connected client.
     const int m_client_protocol_version;
 
+    // The codec to compress DOWNLOAD message bodies with, chosen from
+    // Server::Config::download_body_codecs and the codecs the client accepts.
+    const BodyCodec m_download_body_codec;
+
     // The user agent description passed by the client.
     const std::string m_client_user_agent;
 
@@ -1699,6 +1725,8 @@ private:
         MiscBuffers& misc_buffers = m_server.get_misc_buffers();
         using ProtocolVersionRanges = MiscBuffers::ProtocolVersionRanges;
         ProtocolVersionRanges& protocol_version_ranges = misc_buffers.protocol_version_ranges;
+        std::vector<BodyCodec> client_body_codecs;
+        bool client_lists_body_codecs = false;
         {
             protocol_version_ranges.clear();
             util::MemoryInputStream in;
@@ -1712,6 +1740,15 @@ private:
             while (parser.next(elem)) {
                 // FIXME: Use std::string_view::begins_with() in C++20.
                 const StringData protocol{elem};
+                if (protocol.begins_with(get_body_codec_websocket_protocol_prefix())) {
+                    // Codecs unknown to this server are skipped, as clients
+                    // may support codecs added after it was built.
+                    client_lists_body_codecs = true;
+                    std::string_view name = elem.substr(get_body_codec_websocket_protocol_prefix().size());
+                    if (auto codec = parse_body_codec(name))
+                        client_body_codecs.push_back(*codec); // Throws
+                    continue;
+                }
                 std::string_view prefix;
                 if (protocol.begins_with(get_pbs_websocket_protocol_prefix()))
                     prefix = get_pbs_websocket_protocol_prefix();
@@ -1824,6 +1861,27 @@ private:
             formatter.reset();
         }
 
+        // Choose the first of the configured DOWNLOAD body codecs that the
+        // client accepts. Clients that do not list any codecs predate the
+        // negotiation, and accept zlib.
+        BodyCodec download_body_codec = BodyCodec::none;
+        {
+            if (!client_lists_body_codecs)
+                client_body_codecs.push_back(BodyCodec::zlib); // Throws
+            const Server::Config& config = m_server.get_config();
+            for (BodyCodec codec : config.download_body_codecs) {
+                if (codec == BodyCodec::zlib && config.download_compression_level == 0)
+                    continue;
+                if (codec == BodyCodec::none ||
+                    std::find(client_body_codecs.begin(), client_body_codecs.end(), codec) !=
+                        client_body_codecs.end()) {
+                    download_body_codec = codec;
+                    break;
+                }
+            }
+            logger.debug("Negotiated DOWNLOAD body codec: %1", to_string(download_body_codec)); // Throws
+        }
+
         std::string sec_websocket_protocol_2;
         {
             std::string_view prefix =
@@ -1870,8 +1928,8 @@ private:
                 user_agent = i->second; // Throws (copy)
         }
 
-        auto handler = [protocol_version = m_negotiated_protocol_version, user_agent = std::move(user_agent),
-                        this](std::error_code ec) {
+        auto handler = [protocol_version = m_negotiated_protocol_version, download_body_codec,
+                        user_agent = std::move(user_agent), this](std::error_code ec) {
             // If the operation is aborted, the socket object may have been destroyed.
             if (ec != util::error::operation_aborted) {
                 if (ec) {
@@ -1881,7 +1939,7 @@ private:
 
                 std::unique_ptr<SyncConnection> sync_conn = std::make_unique<SyncConnection>(
                     m_server, m_id, std::move(m_socket), std::move(m_ssl_stream), std::move(m_read_ahead_buffer),
-                    protocol_version, std::move(user_agent), std::move(m_remote_endpoint),
+                    protocol_version, download_body_codec, std::move(user_agent), std::move(m_remote_endpoint),
                     get_appservices_request_id()); // Throws
                 SyncConnection& sync_conn_ref = *sync_conn;
                 m_server.add_sync_connection(m_id, std::move(sync_conn));
@@ -2860,7 +2918,8 @@ private:
             const char* body;
             std::size_t uncompressed_body_size;
             std::size_t compressed_body_size = 0;
-            bool body_is_compressed = false;
+            BodyCodec requested_body_codec = m_connection.get_download_body_codec();
+            BodyCodec body_codec = BodyCodec::none;
             version_type end_version = last_server_version.version;
             DownloadCursor download_progress;
             UploadCursor upload_progress = {0, 0};
@@ -2872,12 +2931,13 @@ private:
             bool enable_cache = (config.enable_download_bootstrap_cache && m_download_progress.server_version == 0 &&
                                  m_upload_progress.client_version == 0 && m_upload_threshold.client_version == 0);
             DownloadCache& cache = m_server_file->get_download_cache();
-            bool fetch_from_cache = (enable_cache && cache.body && end_version == cache.end_version);
+            bool fetch_from_cache = (enable_cache && cache.body && end_version == cache.end_version &&
+                                     requested_body_codec == cache.requested_body_codec);
             if (fetch_from_cache) {
                 body = cache.body.get();
                 uncompressed_body_size = cache.uncompressed_body_size;
                 compressed_body_size = cache.compressed_body_size;
-                body_is_compressed = cache.body_is_compressed;
+                body_codec = cache.body_codec;
                 download_progress = cache.download_progress;
                 downloadable_bytes = cache.downloadable_bytes;
                 num_changesets = cache.num_changesets;
@@ -2922,11 +2982,11 @@ private:
                     if (uncompressed.size() > max_uncompressed) {
                         compression::CompressMemoryArena& arena = server.get_compress_memory_arena();
                         std::vector<char>& buffer = server.get_misc_buffers().compress;
-                        compression::allocate_and_compress(arena, uncompressed, buffer); // Throws
-                        if (buffer.size() < uncompressed.size()) {
+                        body_codec = _impl::compress_message_body(requested_body_codec, arena, uncompressed,
+                                                                  buffer, config.download_compression_level); // Throws
+                        if (body_codec != BodyCodec::none) {
                             body = buffer.data();
                             compressed_body_size = buffer.size();
-                            body_is_compressed = true;
                         }
                     }
                     num_changesets = handler.num_changesets;
@@ -2942,12 +3002,14 @@ private:
                         return;
                     }
                     REALM_ASSERT(upload_progress.client_version == 0);
-                    std::size_t body_size = (body_is_compressed ? compressed_body_size : uncompressed_body_size);
+                    std::size_t body_size =
+                        (body_codec != BodyCodec::none ? compressed_body_size : uncompressed_body_size);
                     cache.body = std::make_unique<char[]>(body_size); // Throws
                     std::copy(body, body + body_size, cache.body.get());
                     cache.uncompressed_body_size = uncompressed_body_size;
                     cache.compressed_body_size = compressed_body_size;
-                    cache.body_is_compressed = body_is_compressed;
+                    cache.requested_body_codec = requested_body_codec;
+                    cache.body_codec = body_codec;
                     cache.end_version = end_version;
                     cache.download_progress = download_progress;
                     cache.downloadable_bytes = downloadable_bytes;
@@ -2971,7 +3033,7 @@ private:
                 download_progress.last_integrated_client_version, last_server_version.version,
                 last_server_version.salt, upload_progress.client_version,
                 upload_progress.last_integrated_server_version, downloadable_bytes, num_changesets, body,
-                uncompressed_body_size, compressed_body_size, body_is_compressed, logger); // Throws
+                uncompressed_body_size, compressed_body_size, body_codec, logger); // Throws
 
             m_download_progress = download_progress;
             logger.debug("Setting of m_download_progress.server_version = %1",
@@ -3187,13 +3249,14 @@ void SessionQueue::clear() noexcept
 
 // ============================ ServerFile implementation ============================
 
-ServerFile::ServerFile(ServerImpl& server, ServerFileAccessCache& cache, const std::string& virt_path,
-                       std::string real_path, bool disable_sync_to_disk)
-    : logger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", server.logger_ptr}               // Throws
-    , wlogger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", server.get_worker().logger_ptr} // Throws
+ServerFile::ServerFile(ServerImpl& server, ServerFileAccessCache& cache, Worker& worker,
+                       const std::string& virt_path, std::string real_path, bool disable_sync_to_disk)
+    : logger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", server.logger_ptr}     // Throws
+    , wlogger{util::LogCategory::server, "ServerFile[" + virt_path + "]: ", worker.logger_ptr} // Throws
     , m_server{server}
+    , m_worker{worker}
     , m_file{cache, real_path, virt_path, false, disable_sync_to_disk} // Throws
-    , m_worker_file{server.get_worker().get_file_access_cache(), real_path, virt_path, true, disable_sync_to_disk}
+    , m_worker_file{m_worker.get_file_access_cache(), real_path, virt_path, true, disable_sync_to_disk}
 {
 }
 
@@ -3455,8 +3518,7 @@ void ServerFile::group_unblock_work()
         if (REALM_LIKELY(work.has_primary_work)) {
             logger.trace("Work unit unblocked"); // Throws
             m_has_work_in_progress = true;
-            Worker& worker = m_server.get_worker();
-            worker.enqueue(this); // Throws
+            m_worker.enqueue(this); // Throws
         }
     }
 }
@@ -3724,8 +3786,11 @@ void ServerFile::finalize_work_stage_2()
 
 // ============================ Worker implementation ============================
 
-Worker::Worker(ServerImpl& server)
-    : logger_ptr{std::make_shared<util::PrefixLogger>(util::LogCategory::server, "Worker: ", server.logger_ptr)}
+Worker::Worker(ServerImpl& server, unsigned index)
+    : logger_ptr{std::make_shared<util::PrefixLogger>(
+          util::LogCategory::server,
+          (server.get_config().num_workers > 1 ? util::format("Worker[%1]: ", index) : std::string("Worker: ")),
+          server.logger_ptr)}
     // Throws
     , logger(*logger_ptr)
     , m_server{server}
@@ -3790,11 +3855,19 @@ ServerImpl::ServerImpl(const std::string& root_dir, util::Optional<sync::PKey> p
     , m_access_control{std::move(pkey)}
     , m_protocol_version_range{determine_protocol_version_range(config)}                 // Throws
     , m_file_access_cache{m_config.max_open_files, logger, *this, config.encryption_key} // Throws
-    , m_worker{*this}                                                                    // Throws
     , m_acceptor{get_service()}
     , m_server_protocol{}       // Throws
     , m_compress_memory_arena{} // Throws
 {
+    if (m_config.download_compression_level < 0 || m_config.download_compression_level > 9)
+        throw std::runtime_error(util::format("Invalid download compression level: %1 (must be 0 to 9)",
+                                              m_config.download_compression_level));
+
+    m_config.num_workers = std::max(m_config.num_workers, 1U);
+    m_workers.reserve(m_config.num_workers); // Throws
+    for (unsigned i = 0; i < m_config.num_workers; ++i)
+        m_workers.push_back(std::make_unique<Worker>(*this, i)); // Throws
+
     if (m_config.ssl) {
         m_ssl_context = std::make_unique<network::ssl::Context>();                // Throws
         m_ssl_context->use_certificate_chain_file(m_config.ssl_certificate_path); // Throws
@@ -3837,6 +3910,7 @@ void ServerImpl::start()
     }
     logger.info("Directory holding persistent state: %1", m_root_dir);        // Throws
     logger.info("Maximum number of open files: %1", m_config.max_open_files); // Throws
+    logger.info("Number of workers: %1", m_config.num_workers);              // Throws
     {
         const char* lead_text = "Encryption";
         if (m_config.encryption_key) {
@@ -3884,19 +3958,27 @@ void ServerImpl::run()
     auto ta = util::make_temp_assign(m_running, true);
 
     {
-        auto worker_thread = util::make_thread_exec_guard(m_worker, *this); // Throws
+        std::vector<util::ThreadExecGuardWithParent<Worker, ServerImpl>> worker_threads;
+        worker_threads.reserve(m_workers.size()); // Throws
         std::string name;
-        if (util::Thread::get_name(name)) {
-            name += "-worker";
-            worker_thread.start_with_signals_blocked(name); // Throws
-        }
-        else {
-            worker_thread.start_with_signals_blocked(); // Throws
+        bool has_name = util::Thread::get_name(name);
+        for (std::size_t i = 0; i < m_workers.size(); ++i) {
+            auto& worker_thread = worker_threads.emplace_back(*m_workers[i], *this); // Throws
+            if (has_name) {
+                std::string worker_name = name + "-worker";
+                if (m_workers.size() > 1)
+                    worker_name += std::to_string(i);
+                worker_thread.start_with_signals_blocked(worker_name); // Throws
+            }
+            else {
+                worker_thread.start_with_signals_blocked(); // Throws
+            }
         }
 
         m_service.run(); // Throws
 
-        worker_thread.stop_and_rethrow(); // Throws
+        for (auto& worker_thread : worker_threads)
+            worker_thread.stop_and_rethrow(); // Throws
     }
 
     logger.info("Realm sync server stopped");
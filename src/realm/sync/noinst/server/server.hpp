@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 #include <exception>
+#include <vector>
 
 #include <realm/util/logger.hpp>
 #include <realm/util/optional.hpp>
@@ -71,11 +72,18 @@ public:
 
         /// The maximum number of Realm files that will be kept open
         /// concurrently by each major thread inside the server. The server
-        /// currently has two major threads (foreground and background). The
-        /// server keeps a cache of open Realm files for efficiency reasons (one
-        /// for each major thread).
+        /// has one foreground thread, and `num_workers` background
+        /// threads. The server keeps a cache of open Realm files for
+        /// efficiency reasons (one for each major thread).
         long max_open_files = 256;
 
+        /// The number of background threads integrating changesets uploaded
+        /// by clients. Each Realm file is assigned to one of them, in turn,
+        /// when the server first opens it, so uploads to different files can
+        /// be integrated in parallel, while those to the same file are still
+        /// integrated in order. Zero is taken to mean one.
+        unsigned num_workers = 1;
+
         /// An optional custom clock to be used for token expiration checks. If
         /// no clock is specified, the server will use the system clock.
         Clock* token_expiration_clock = nullptr;
@@ -174,6 +182,19 @@ public:
         /// for the need to resend the same changes after network disconnects.
         std::size_t max_download_size = 0x1000000; // 16 MiB
 
+        /// The codecs the bodies of DOWNLOAD messages, including the ones
+        /// kept in the bootstrap cache, may be compressed with, in order of
+        /// preference. Each connection uses the first one that the client
+        /// accepts. If there is none, or the list is empty, the bodies are
+        /// sent uncompressed, which saves CPU time at the expense of
+        /// bandwidth.
+        std::vector<BodyCodec> download_body_codecs = {BodyCodec::zlib};
+
+        /// The zlib compression level, from 1 (fastest) to 9 (smallest), of
+        /// the bodies of DOWNLOAD messages. If zero, zlib is not used. Any
+        /// other value makes the Server constructor throw std::runtime_error.
+        int download_compression_level = 1;
+
         /// The maximum number of connections that can be queued up waiting to
         /// be accepted by the server. This corresponds to the `backlog`
         /// argument of the `listen()` function as described by POSIX.
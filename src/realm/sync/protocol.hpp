@@ -2,6 +2,8 @@
 #define REALM_SYNC_PROTOCOL_HPP
 
 #include <cstdint>
+#include <optional>
+#include <string_view>
 #include <system_error>
 
 #include <realm/error_codes.h>
@@ -83,8 +85,60 @@ constexpr std::string_view get_flx_websocket_protocol_prefix() noexcept
     return "com.mongodb.realm-query-sync#";
 }
 
+constexpr std::string_view get_body_codec_websocket_protocol_prefix() noexcept
+{
+    return "com.mongodb.realm-sync.body-codec#";
+}
+
 enum class SyncServerMode { PBS, FLX };
 
+/// The encoding of the body of UPLOAD and DOWNLOAD messages. The value is sent
+/// in the message header, where it replaced a flag saying whether the body was
+/// zlib compressed, so `none` and `zlib` keep their old wire values.
+///
+/// A client adds `com.mongodb.realm-sync.body-codec#<name>` to
+/// `Sec-WebSocket-Protocol` for every codec other than `none` that it can
+/// decode. A client that adds none of these is assumed to decode `zlib`. The
+/// server picks the codec of DOWNLOAD bodies from that list, and the client
+/// encodes UPLOAD bodies with the codec of the DOWNLOAD bodies it receives.
+///
+/// New codecs are added as new enumerators, together with a case in
+/// `_impl::compress_message_body()` and `_impl::decompress_message_body()`.
+enum class BodyCodec { none = 0, zlib = 1 };
+
+/// The codecs other than `none` that this build can encode and decode.
+constexpr BodyCodec supported_body_codecs[] = {BodyCodec::zlib};
+
+inline bool is_valid_body_codec(int value) noexcept
+{
+    switch (BodyCodec(value)) {
+        case BodyCodec::none:
+        case BodyCodec::zlib:
+            return true;
+    }
+    return false;
+}
+
+inline std::string_view to_string(BodyCodec codec) noexcept
+{
+    switch (codec) {
+        case BodyCodec::none:
+            return "none";
+        case BodyCodec::zlib:
+            return "zlib";
+    }
+    return "";
+}
+
+inline std::optional<BodyCodec> parse_body_codec(std::string_view name) noexcept
+{
+    for (BodyCodec codec : {BodyCodec::none, BodyCodec::zlib}) {
+        if (name == to_string(codec))
+            return codec;
+    }
+    return std::nullopt;
+}
+
 /// Supported protocol envelopes:
 ///
 ///                                                             Alternative (*)
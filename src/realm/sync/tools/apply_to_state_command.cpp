@@ -105,7 +105,9 @@ DownloadMessage DownloadMessage::parse(HeaderLineParser& msg, Logger& logger, bo
         ret.batch_state = sync::DownloadBatchState::SteadyState;
     }
     ret.downloadable_bytes = msg.read_next<int64_t>();
-    auto is_body_compressed = msg.read_next<bool>();
+    auto body_codec = msg.read_next<int>();
+    if (!sync::is_valid_body_codec(body_codec))
+        throw ProtocolCodecException(util::format("unknown body codec in download message: %1", body_codec));
     auto uncompressed_body_size = msg.read_next<size_t>();
     auto compressed_body_size = msg.read_next<size_t>('\n');
 
@@ -117,10 +119,11 @@ DownloadMessage DownloadMessage::parse(HeaderLineParser& msg, Logger& logger, bo
                  ret.latest_server_version.version);
 
     std::string_view body_str;
-    if (is_body_compressed) {
+    if (sync::BodyCodec(body_codec) != sync::BodyCodec::none) {
         ret.uncompressed_body_buffer.set_size(uncompressed_body_size);
         auto compressed_body = msg.read_sized_data<BinaryData>(compressed_body_size);
-        std::error_code ec = util::compression::decompress(compressed_body, ret.uncompressed_body_buffer);
+        std::error_code ec = _impl::decompress_message_body(sync::BodyCodec(body_codec), compressed_body,
+                                                            ret.uncompressed_body_buffer);
 
         if (ec) {
             throw ProtocolCodecException("error decompressing download message");
@@ -162,19 +165,22 @@ UploadMessage UploadMessage::parse(HeaderLineParser& msg, Logger& logger)
     UploadMessage ret;
 
     ret.session_ident = msg.read_next<sync::session_ident_type>();
-    auto is_body_compressed = msg.read_next<bool>();
+    auto body_codec = msg.read_next<int>();
+    if (!sync::is_valid_body_codec(body_codec))
+        throw ProtocolCodecException(util::format("unknown body codec in upload message: %1", body_codec));
     auto uncompressed_body_size = msg.read_next<size_t>();
     auto compressed_body_size = msg.read_next<size_t>();
     ret.upload_progress.client_version = msg.read_next<sync::version_type>();
     ret.upload_progress.last_integrated_server_version = msg.read_next<sync::version_type>();
     ret.locked_server_version = msg.read_next<sync::version_type>('\n');
 
-    // if is_body_compressed == true, we must decompress the received body.
+    // Unless the body was sent as is, we must decompress it.
     std::string_view body_str;
-    if (is_body_compressed) {
+    if (sync::BodyCodec(body_codec) != sync::BodyCodec::none) {
         ret.uncompressed_body_buffer.set_size(uncompressed_body_size);
         auto compressed_body = msg.read_sized_data<BinaryData>(compressed_body_size);
-        std::error_code ec = util::compression::decompress(compressed_body, ret.uncompressed_body_buffer);
+        std::error_code ec = _impl::decompress_message_body(sync::BodyCodec(body_codec), compressed_body,
+                                                            ret.uncompressed_body_buffer);
 
         if (ec) {
             throw ProtocolCodecException("error decompressing upload message");
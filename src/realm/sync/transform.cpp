@@ -3,6 +3,9 @@
 #include <realm/sync/changeset_encoder.hpp>
 #include <realm/sync/noinst/changeset_index.hpp>
 #include <realm/sync/noinst/protocol_codec.hpp>
+#include <realm/util/worker_pool.hpp>
+
+#include <unordered_map>
 
 #if REALM_DEBUG
 #include <sstream>
@@ -145,10 +148,10 @@ struct MajorSide : Side {
     void init_with_instruction(Changeset::iterator position) noexcept
     {
         REALM_ASSERT(position >= m_changeset->begin());
-        REALM_ASSERT(position != m_changeset->end());
+        REALM_ASSERT(position != m_end);
         m_position = position;
         skip_tombstones();
-        REALM_ASSERT(position != m_changeset->end());
+        REALM_ASSERT(position != m_end);
 
         m_discriminant = Discriminant{m_changeset->origin_timestamp, m_changeset->origin_file_ident};
 
@@ -157,17 +160,17 @@ struct MajorSide : Side {
 
     void skip_tombstones() noexcept final
     {
-        while (m_position != m_changeset->end() && !*m_position) {
+        while (m_position != m_end && !*m_position) {
             ++m_position;
         }
     }
 
     void next_instruction() noexcept final
     {
-        REALM_ASSERT(m_position != m_changeset->end());
+        REALM_ASSERT(m_position != m_end);
         do {
             ++m_position;
-        } while (m_position != m_changeset->end() && !*m_position);
+        } while (m_position != m_end && !*m_position);
     }
 
     Instruction& get() noexcept final
@@ -181,6 +184,9 @@ struct MajorSide : Side {
     }
 
     Changeset::iterator m_position;
+    // The end of the instructions being transformed, which may be before the
+    // end of the changeset
+    Changeset::iterator m_end;
 };
 
 struct MinorSide : Side {
@@ -548,11 +554,45 @@ public:
 };
 #endif // LCOV_EXCL_STOP REALM_DEBUG
 
+/// The ranges of incoming instructions which an instruction of a local
+/// changeset must be merged with.
+_impl::ChangesetIndex::Ranges* get_conflict_ranges(_impl::ChangesetIndex& index, const Changeset& changeset,
+                                                   const Instruction& instr)
+{
+    if (_impl::is_schema_change(instr)) {
+        ///
+        /// CONFLICT GROUP: Everything touching that class
+        ///
+        return index.get_everything();
+    }
+
+    ///
+    /// CONFLICT GROUP: Everything touching the involved objects,
+    /// including schema changes.
+    ///
+    _impl::ChangesetIndex::GlobalID ids[2];
+    size_t num_ids = _impl::get_object_ids_in_instruction(changeset, instr, ids, 2);
+    REALM_ASSERT(num_ids <= 2);
+    REALM_ASSERT(num_ids >= 1);
+    auto ranges = index.get_modifications_for_object(ids[0]);
+    if (num_ids == 2) {
+        // Check that the index has correctly joined the ranges for the
+        // two object IDs.
+        REALM_ASSERT(ranges == index.get_modifications_for_object(ids[1]));
+    }
+    return ranges;
+}
+
 struct TransformerImpl {
     MajorSide m_major_side;
     MinorSide m_minor_side;
     MinorSide::Position m_minor_end;
     bool m_trace;
+    // Set when other transformers work on the same changesets at the same
+    // time, in which case the changesets made dirty are collected in
+    // m_dirty_changesets rather than marked right away
+    bool m_concurrent = false;
+    std::vector<Changeset*> m_dirty_changesets;
 
     TransformerImpl(bool trace)
         : m_major_side{*this}
@@ -563,10 +603,9 @@ struct TransformerImpl {
 
     void transform()
     {
-        m_major_side.m_position = m_major_side.m_changeset->begin();
         m_major_side.skip_tombstones();
 
-        while (m_major_side.m_position != m_major_side.m_changeset->end()) {
+        while (m_major_side.m_position != m_major_side.m_end) {
             m_major_side.init_with_instruction(m_major_side.m_position);
 
             set_conflict_ranges();
@@ -585,31 +624,16 @@ struct TransformerImpl {
     {
         _impl::ChangesetIndex& index = *m_minor_side.m_changeset_index;
 
-        if (_impl::is_schema_change(instr)) {
-            ///
-            /// CONFLICT GROUP: Everything touching that class
-            ///
-            auto ranges = index.get_everything();
-            if (!ranges->empty()) {
 #if REALM_DEBUG // LCOV_EXCL_START
-                if (m_trace) {
+        if (m_trace) {
+            if (_impl::is_schema_change(instr)) {
+                if (!index.get_everything()->empty()) {
                     std::cerr << TERM_RED << "Conflict group: Everything (due to schema change)\n" << TERM_RESET;
                 }
-#endif // REALM_DEBUG LCOV_EXCL_STOP
             }
-            return ranges;
-        }
-        else {
-            ///
-            /// CONFLICT GROUP: Everything touching the involved objects,
-            /// including schema changes.
-            ///
-            _impl::ChangesetIndex::GlobalID major_ids[2];
-            size_t num_major_ids = m_major_side.get_object_ids_in_current_instruction(major_ids, 2);
-            REALM_ASSERT(num_major_ids <= 2);
-            REALM_ASSERT(num_major_ids >= 1);
-#if REALM_DEBUG // LCOV_EXCL_START
-            if (m_trace) {
+            else {
+                _impl::ChangesetIndex::GlobalID major_ids[2];
+                size_t num_major_ids = m_major_side.get_object_ids_in_current_instruction(major_ids, 2);
                 std::cerr << TERM_RED << "Conflict group: ";
                 if (num_major_ids == 0) {
                     std::cerr << "(nothing - no object references)";
@@ -621,15 +645,10 @@ struct TransformerImpl {
                 }
                 std::cerr << "\n" << TERM_RESET;
             }
-#endif // REALM_DEBUG LCOV_EXCL_STOP
-            auto ranges = index.get_modifications_for_object(major_ids[0]);
-            if (num_major_ids == 2) {
-                // Check that the index has correctly joined the ranges for the
-                // two object IDs.
-                REALM_ASSERT(ranges == index.get_modifications_for_object(major_ids[1]));
-            }
-            return ranges;
         }
+#endif // REALM_DEBUG LCOV_EXCL_STOP
+
+        return get_conflict_ranges(index, *m_major_side.m_changeset, instr);
     }
 
     void set_conflict_ranges()
@@ -640,24 +659,39 @@ struct TransformerImpl {
     }
 
     void set_next_major_changeset(Changeset* changeset) noexcept
+    {
+        set_major_instructions(changeset, changeset->begin(), changeset->end());
+    }
+
+    // Transform only the instructions in [begin, end) of `changeset`
+    void set_major_instructions(Changeset* changeset, Changeset::iterator begin, Changeset::iterator end) noexcept
     {
         m_major_side.m_changeset = changeset;
-        m_major_side.m_position = changeset->begin();
+        m_major_side.m_position = begin;
+        m_major_side.m_end = end;
         m_major_side.skip_tombstones();
     }
 
+    void set_dirty(Changeset& changeset)
+    {
+        if (m_concurrent)
+            m_dirty_changesets.push_back(&changeset);
+        else
+            changeset.set_dirty(true);
+    }
+
     void discard_major()
     {
         m_major_side.m_position = m_major_side.m_changeset->erase_stable(m_major_side.m_position);
         m_major_side.was_discarded = true; // This terminates the loop in transform_major();
-        m_major_side.m_changeset->set_dirty(true);
+        set_dirty(*m_major_side.m_changeset);
     }
 
     void discard_minor()
     {
         m_minor_side.was_discarded = true;
         m_minor_side.m_position = m_minor_side.m_changeset_index->erase_instruction(m_minor_side.m_position);
-        m_minor_side.m_changeset->set_dirty(true);
+        set_dirty(*m_minor_side.m_changeset);
         m_minor_side.update_changeset_pointer();
     }
 
@@ -667,7 +701,7 @@ struct TransformerImpl {
         REALM_ASSERT(*m_major_side.m_position); // cannot prepend a tombstone
         auto insert_position = m_major_side.m_position;
         m_major_side.m_position = m_major_side.m_changeset->insert_stable(insert_position, instr_begin, instr_end);
-        m_major_side.m_changeset->set_dirty(true);
+        set_dirty(*m_major_side.m_changeset);
         size_t num_prepended = instr_end - instr_begin;
         transform_prepended_major(num_prepended);
     }
@@ -686,7 +720,7 @@ struct TransformerImpl {
         auto insert_position = m_minor_side.m_position.m_pos;
         m_minor_side.m_position.m_pos =
             m_minor_side.m_changeset->insert_stable(insert_position, instr_begin, instr_end);
-        m_minor_side.m_changeset->set_dirty(true);
+        set_dirty(*m_minor_side.m_changeset);
         size_t num_prepended = instr_end - instr_begin;
         // Go back to the instruction that initiated this prepend
         for (size_t i = 0; i < num_prepended; ++i) {
@@ -711,7 +745,7 @@ struct TransformerImpl {
         // instructions in the below, not the instruction that instigated the
         // prepend.
         m_major_side.was_discarded = false;
-        REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+        REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
 
 #if defined(REALM_DEBUG) // LCOV_EXCL_START
         if (m_trace) {
@@ -733,16 +767,16 @@ struct TransformerImpl {
                 m_minor_side.next_instruction();
             }
 
-            REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+            REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
             m_major_side.init_with_instruction(m_major_side.m_position);
             REALM_ASSERT(!m_major_side.was_discarded);
-            REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+            REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
             transform_major();
             if (!m_major_side.was_discarded) {
                 // Discarding an instruction moves to the next.
                 m_major_side.next_instruction();
             }
-            REALM_ASSERT(m_major_side.m_position != m_major_side.m_changeset->end());
+            REALM_ASSERT(m_major_side.m_position != m_major_side.m_end);
 
             m_minor_side.m_position = orig_minor_index;
             m_minor_side.was_discarded = orig_minor_was_discarded;
@@ -2364,16 +2398,96 @@ void TransformerImpl::merge_instructions(MajorSide& their_side, MinorSide& our_s
     if (!their_side.was_discarded && !their_side.was_replaced) {
         const auto& their_after = their_side.get();
         if (!(their_after == their_before)) {
-            their_side.m_changeset->set_dirty(true);
+            set_dirty(*their_side.m_changeset);
         }
     }
 
     if (!our_side.was_discarded && !our_side.was_replaced) {
         const auto& our_after = our_side.get();
         if (!(our_after == our_before)) {
-            our_side.m_changeset->set_dirty(true);
+            set_dirty(*our_side.m_changeset);
+        }
+    }
+}
+
+// Transform the local changesets through the incoming ones one conflict group
+// of the index at a time. The groups have no instructions in common, so the
+// instructions of each group are transformed by a TransformerImpl of its own,
+// and the groups are spread over the worker pool. A local instruction which
+// conflicts with all the incoming ones, such as a schema change, waits for
+// the instructions before it, and is transformed before any of the ones after
+// it.
+void transform_by_conflict_group(_impl::ChangesetIndex& index, util::Span<Changeset*> our_changesets)
+{
+    using Ranges = _impl::ChangesetIndex::Ranges;
+    // Local instructions which are all merged with the same incoming ones
+    struct Slice {
+        Changeset* changeset;
+        Changeset::iterator begin;
+        Changeset::iterator end;
+    };
+    std::vector<std::vector<Slice>> groups;
+    std::unordered_map<const Ranges*, size_t> group_ndxs;
+
+    auto transform = [&](TransformerImpl& transformer, const std::vector<Slice>& slices) {
+        transformer.m_minor_side.m_changeset_index = &index;
+        for (auto& slice : slices) {
+            transformer.set_major_instructions(slice.changeset, slice.begin, slice.end);
+            transformer.transform(); // Throws
+        }
+    };
+    auto transform_groups = [&] {
+        std::vector<std::vector<Changeset*>> dirty_changesets(groups.size());
+        util::WorkerPool::get_default().run(groups.size(), [&](size_t i) {
+            TransformerImpl transformer{false};
+            transformer.m_concurrent = true;
+            transform(transformer, groups[i]); // Throws
+            dirty_changesets[i] = std::move(transformer.m_dirty_changesets);
+        });
+        for (auto& changesets : dirty_changesets) {
+            for (Changeset* changeset : changesets)
+                changeset->set_dirty(true);
+        }
+        groups.clear();
+        group_ndxs.clear();
+    };
+
+    for (Changeset* changeset : our_changesets) {
+        // Each element of the changeset holds an instruction, or one along
+        // with the instructions prepended to it, which are in the same group
+        Changeset::iterator end = changeset->end();
+        for (Changeset::iterator begin = changeset->begin(); begin != end;) {
+            Changeset::iterator next{begin.m_inner + 1};
+            Ranges* ranges = nullptr;
+            bool same_ranges = true;
+            for (auto it = begin; it != next; ++it) {
+                if (!*it)
+                    continue;
+                Ranges* instr_ranges = get_conflict_ranges(index, *changeset, **it);
+                same_ranges = same_ranges && (!ranges || ranges == instr_ranges);
+                ranges = instr_ranges;
+            }
+            if (!same_ranges || ranges == index.get_everything()) {
+                transform_groups(); // Throws
+                TransformerImpl transformer{false};
+                transform(transformer, {{changeset, begin, next}}); // Throws
+            }
+            else if (ranges && !ranges->empty()) {
+                auto [it, inserted] = group_ndxs.emplace(ranges, groups.size());
+                if (inserted)
+                    groups.emplace_back();
+                auto& slices = groups[it->second];
+                if (!slices.empty() && slices.back().changeset == changeset && slices.back().end == begin) {
+                    slices.back().end = next;
+                }
+                else {
+                    slices.push_back({changeset, begin, next});
+                }
+            }
+            begin = next;
         }
     }
+    transform_groups(); // Throws
 }
 
 } // anonymous namespace
@@ -2477,17 +2591,23 @@ void Transformer::merge_changesets(file_ident_type local_file_ident, util::Span<
     static_cast<void>(local_file_ident);
 #endif // REALM_DEBUG LCOV_EXCL_STOP
 
-    for (size_t i = 0; i < our_changesets.size(); ++i) {
-        logger.trace(
-            util::LogCategory::changeset,
-            "Transforming local changeset [%1/%2] through %3 incoming changeset(s) with %4 conflict group(s)", i + 1,
-            our_changesets.size(), their_changesets.size(), their_index.get_num_conflict_groups());
-        Changeset* our_changeset = our_changesets[i];
+    if (trace) {
+        // Merge everything in order on this thread to keep the trace readable
+        for (size_t i = 0; i < our_changesets.size(); ++i) {
+            logger.trace(
+                util::LogCategory::changeset,
+                "Transforming local changeset [%1/%2] through %3 incoming changeset(s) with %4 conflict group(s)",
+                i + 1, our_changesets.size(), their_changesets.size(), their_index.get_num_conflict_groups());
+            Changeset* our_changeset = our_changesets[i];
 
-        transformer.m_major_side.set_next_changeset(our_changeset);
-        // MinorSide uses the index to find the Changeset.
-        transformer.m_minor_side.m_changeset_index = &their_index;
-        transformer.transform(); // Throws
+            transformer.m_major_side.set_next_changeset(our_changeset);
+            // MinorSide uses the index to find the Changeset.
+            transformer.m_minor_side.m_changeset_index = &their_index;
+            transformer.transform(); // Throws
+        }
+    }
+    else {
+        transform_by_conflict_group(their_index, our_changesets); // Throws
     }
 
     logger.debug(util::LogCategory::changeset,
@@ -2640,8 +2760,17 @@ void parse_remote_changeset(const RemoteChangeset& remote_changeset, Changeset&
     REALM_ASSERT(remote_changeset.origin_file_ident != 0);
     REALM_ASSERT(remote_changeset.remote_version != 0);
 
-    ChunkedBinaryInputStream remote_in{remote_changeset.data};
-    parse_changeset(remote_in, parsed_changeset); // Throws
+    // Received changesets are held in a single buffer, which is referred to
+    // by the parsed changeset instead of copying its strings.
+    BinaryIterator chunks = remote_changeset.data.iterator();
+    BinaryData first_chunk = chunks.get_next();
+    if (chunks.get_next().size() == 0) {
+        parse_changeset_in_place({first_chunk.data(), first_chunk.size()}, parsed_changeset); // Throws
+    }
+    else {
+        ChunkedBinaryInputStream remote_in{remote_changeset.data};
+        parse_changeset(remote_in, parsed_changeset); // Throws
+    }
 
     parsed_changeset.version = remote_changeset.remote_version;
     parsed_changeset.last_integrated_remote_version = remote_changeset.last_integrated_local_version;
@@ -236,6 +236,8 @@ public:
     RemoteChangeset(version_type rv, version_type lv, ChunkedBinaryData d, timestamp_type ot, file_ident_type fi);
 };
 
+/// The strings of the parsed changeset may refer to the data of the remote
+/// changeset, which must then outlive it.
 void parse_remote_changeset(const RemoteChangeset&, Changeset&);
 
 
@@ -29,6 +29,7 @@
 #include <realm/dictionary.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/impl/destroy_guard.hpp>
+#include <realm/index_sorted.hpp>
 #include <realm/index_string.hpp>
 #include <realm/query_conditions_tpl.hpp>
 #include <realm/replication.hpp>
@@ -36,7 +37,9 @@
 #include <realm/util/features.h>
 #include <realm/util/serializer.hpp>
 
+#include <cmath>
 #include <stdexcept>
+#include <unordered_map>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -879,9 +882,13 @@ void Table::do_add_search_index(ColKey col_key, IndexType type)
     if (m_index_accessors[column_ndx] != nullptr)
         return;
 
-    if (!StringIndex::type_supported(DataType(col_key.get_type())) ||
-        (col_key.is_collection() && !(col_key.is_list() && col_key.get_type() == col_type_String)) ||
-        (type == IndexType::Fulltext && col_key.get_type() != col_type_String)) {
+    bool supported = (type == IndexType::Sorted)
+                         ? SortedIndex::type_supported(DataType(col_key.get_type())) && !col_key.is_collection()
+                         : StringIndex::type_supported(DataType(col_key.get_type())) &&
+                               !(col_key.is_collection() &&
+                                 !(col_key.is_list() && col_key.get_type() == col_type_String)) &&
+                               !(type == IndexType::Fulltext && col_key.get_type() != col_type_String);
+    if (!supported) {
         // Not ideal, but this is what we used to throw, so keep throwing that for compatibility reasons, even though
         // it should probably be a type mismatch exception instead.
         throw IllegalOperation(util::format("Index not supported for this property: %1", get_column_name(col_key)));
@@ -893,8 +900,11 @@ void Table::do_add_search_index(ColKey col_key, IndexType type)
     REALM_ASSERT(m_index_accessors[column_ndx] == nullptr);
 
     // Create the index
-    m_index_accessors[column_ndx] =
-        std::make_unique<StringIndex>(ClusterColumn(&m_clusters, col_key, type), get_alloc()); // Throws
+    ClusterColumn virtual_col(&m_clusters, col_key, type);
+    if (type == IndexType::Sorted)
+        m_index_accessors[column_ndx] = std::make_unique<SortedIndex>(virtual_col, get_alloc()); // Throws
+    else
+        m_index_accessors[column_ndx] = std::make_unique<StringIndex>(virtual_col, get_alloc()); // Throws
     SearchIndex* index = m_index_accessors[column_ndx].get();
     // Insert ref to index
     index->set_parent(&m_index_refs, column_ndx);
@@ -914,6 +924,16 @@ void Table::add_search_index(ColKey col_key, IndexType type)
 
     if (col_key == m_primary_key_col && type == IndexType::Fulltext)
         throw InvalidColumnKey("primary key cannot have a full text index");
+    if (col_key == m_primary_key_col && type == IndexType::Sorted)
+        throw InvalidColumnKey("primary key cannot have a sorted index");
+    if (type == IndexType::Sorted) {
+        // Older cores do not know the column attribute marking a sorted index,
+        // so it may only be written to files of format 25 or later.
+        Group* group = get_parent_group();
+        if (group && group->get_file_format_version() < 25)
+            throw IllegalOperation(util::format("Sorted index not supported by the file format of this Realm: %1",
+                                                get_column_name(col_key)));
+    }
 
     switch (type) {
         case IndexType::None:
@@ -925,7 +945,7 @@ void Table::add_search_index(ColKey col_key, IndexType type)
                 REALM_ASSERT(search_index_type(col_key) == IndexType::Fulltext);
                 return;
             }
-            if (attr.test(col_attr_Indexed)) {
+            if (attr.test(col_attr_Indexed) || attr.test(col_attr_Sorted_Indexed)) {
                 this->remove_search_index(col_key);
             }
             break;
@@ -934,7 +954,16 @@ void Table::add_search_index(ColKey col_key, IndexType type)
                 REALM_ASSERT(search_index_type(col_key) == IndexType::General);
                 return;
             }
-            if (attr.test(col_attr_FullText_Indexed)) {
+            if (attr.test(col_attr_FullText_Indexed) || attr.test(col_attr_Sorted_Indexed)) {
+                this->remove_search_index(col_key);
+            }
+            break;
+        case IndexType::Sorted:
+            if (attr.test(col_attr_Sorted_Indexed)) {
+                REALM_ASSERT(search_index_type(col_key) == IndexType::Sorted);
+                return;
+            }
+            if (attr.test(col_attr_Indexed) || attr.test(col_attr_FullText_Indexed)) {
                 this->remove_search_index(col_key);
             }
             break;
@@ -942,8 +971,21 @@ void Table::add_search_index(ColKey col_key, IndexType type)
 
     do_add_search_index(col_key, type);
 
-    // Update spec
-    attr.set(type == IndexType::Fulltext ? col_attr_FullText_Indexed : col_attr_Indexed);
+    // Update spec, where a replaced index may still be set in `attr`
+    attr.reset(col_attr_Indexed);
+    attr.reset(col_attr_FullText_Indexed);
+    attr.reset(col_attr_Sorted_Indexed);
+    switch (type) {
+        case IndexType::Fulltext:
+            attr.set(col_attr_FullText_Indexed);
+            break;
+        case IndexType::Sorted:
+            attr.set(col_attr_Sorted_Indexed);
+            break;
+        default:
+            attr.set(col_attr_Indexed);
+            break;
+    }
     m_spec.set_column_attr(spec_ndx, attr); // Throws
 }
 
@@ -969,6 +1011,7 @@ void Table::remove_search_index(ColKey col_key)
     auto attr = m_spec.get_column_attr(spec_ndx);
     attr.reset(col_attr_Indexed);
     attr.reset(col_attr_FullText_Indexed);
+    attr.reset(col_attr_Sorted_Indexed);
     m_spec.set_column_attr(spec_ndx, attr); // Throws
 }
 
@@ -1001,6 +1044,50 @@ size_t Table::get_num_unique_values(ColKey col_key) const
     return col.size();
 }
 
+Table::ColumnStatistics Table::get_column_statistics(ColKey col_key) const
+{
+    check_column(col_key);
+    const size_t num_objects = size();
+    // The content version of the allocator is bumped by changes to any table,
+    // so use the version of this table in the file, which only changes when
+    // it is modified, and within a write transaction the number of objects.
+    const uint64_t version = m_in_file_version_at_transaction_boundary;
+
+    std::lock_guard lock(m_statistics_mutex);
+    if (auto it = m_column_statistics.find(col_key); it != m_column_statistics.end()) {
+        size_t sampled = it->second.num_objects;
+        size_t change = std::max(sampled, num_objects) - std::min(sampled, num_objects);
+        if (it->second.version == version && change <= sampled / 10)
+            return it->second;
+    }
+
+    ColumnStatistics stats;
+    stats.num_objects = num_objects;
+    stats.version = version;
+    if (!col_key.is_collection()) {
+        stats.sample_size = std::min(num_objects, ColumnStatistics::max_sample_size);
+        std::unordered_map<Mixed, size_t> counts;
+        for (size_t i = 0; i < stats.sample_size; ++i) {
+            Mixed value = get_object(i * num_objects / stats.sample_size).get_any(col_key);
+            if (value.is_null())
+                ++stats.num_nulls;
+            else
+                ++counts[value];
+        }
+
+        // Values seen only once in the sample are assumed to stand for many
+        // more values which were not sampled (the GEE estimator)
+        size_t seen_once = 0;
+        for (auto& [value, count] : counts) {
+            if (count == 1)
+                ++seen_once;
+        }
+        double scale = stats.sample_size ? std::sqrt(double(num_objects) / stats.sample_size) : 0.0;
+        stats.num_distinct = scale * seen_once + double(counts.size() - seen_once);
+    }
+    m_column_statistics[col_key] = stats;
+    return stats;
+}
 
 void Table::erase_root_column(ColKey col_key)
 {
@@ -1074,6 +1161,10 @@ void Table::do_erase_root_column(ColKey col_key)
     m_opposite_table.set(col_ndx, TableKey().value);
     m_opposite_column.set(col_ndx, ColKey().value);
     m_index_accessors[col_ndx] = nullptr;
+    {
+        std::lock_guard lock(m_statistics_mutex);
+        m_column_statistics.erase(col_key);
+    }
     m_clusters.remove_column(col_key);
     if (m_tombstones)
         m_tombstones->remove_column(col_key);
@@ -1272,6 +1363,8 @@ IndexType Table::search_index_type(ColKey col_key) const noexcept
 {
     if (m_index_accessors[col_key.get_index().val].get()) {
         auto attr = m_spec.get_column_attr(m_leaf_ndx2spec_ndx[col_key.get_index().val]);
+        if (attr.test(col_attr_Sorted_Indexed))
+            return IndexType::Sorted;
         bool fulltext = attr.test(col_attr_FullText_Indexed);
         return fulltext ? IndexType::Fulltext : IndexType::General;
     }
@@ -1646,10 +1739,12 @@ void Table::aggregate(QueryStateBase& st, ColKey column_key) const
         st.m_key_offset = cluster->get_offset();
         st.m_key_values = cluster->get_key_array();
         st.set_payload_column(&leaf);
-        bool cont = true;
         size_t sz = leaf.size();
-        for (size_t local_index = 0; cont && local_index < sz; local_index++) {
-            cont = st.match(local_index);
+        if (!st.match_range(0, sz)) {
+            bool cont = true;
+            for (size_t local_index = 0; cont && local_index < sz; local_index++) {
+                cont = st.match(local_index);
+            }
         }
         return IteratorControl::AdvanceToNext;
     };
@@ -1699,6 +1794,12 @@ StringIndex* Table::get_string_index(ColKey col) const noexcept
     return dynamic_cast<StringIndex*>(m_index_accessors[col.get_index().val].get());
 }
 
+const SortedIndex* Table::get_sorted_index(ColKey col) const noexcept
+{
+    check_column(col);
+    return dynamic_cast<const SortedIndex*>(m_index_accessors[col.get_index().val].get());
+}
+
 template <class T>
 ObjKey Table::find_first(ColKey col_key, T value) const
 {
@@ -2161,15 +2262,26 @@ void Table::refresh_index_accessors()
         else {
             auto attr = m_spec.get_column_attr(m_leaf_ndx2spec_ndx[col_ndx]);
             bool fulltext = attr.test(col_attr_FullText_Indexed);
+            bool sorted = attr.test(col_attr_Sorted_Indexed);
             auto col_key = m_leaf_ndx2colkey[col_ndx];
-            ClusterColumn virtual_col(&m_clusters, col_key, fulltext ? IndexType::Fulltext : IndexType::General);
-
-            if (m_index_accessors[col_ndx]) { // still there, refresh:
-                m_index_accessors[col_ndx]->refresh_accessor_tree(virtual_col);
+            ClusterColumn virtual_col(&m_clusters, col_key,
+                                      sorted     ? IndexType::Sorted
+                                      : fulltext ? IndexType::Fulltext
+                                                 : IndexType::General);
+
+            // The kind of index may have changed along with the ref
+            auto& index = m_index_accessors[col_ndx];
+            if (index && sorted != (dynamic_cast<SortedIndex*>(index.get()) != nullptr))
+                index.reset();
+
+            if (index) { // still there, refresh:
+                index->refresh_accessor_tree(virtual_col);
             }
-            else { // new index!
-                m_index_accessors[col_ndx] =
-                    std::make_unique<StringIndex>(ref, &m_index_refs, col_ndx, virtual_col, get_alloc());
+            else if (sorted) { // new index!
+                index = std::make_unique<SortedIndex>(ref, &m_index_refs, col_ndx, virtual_col, get_alloc());
+            }
+            else {
+                index = std::make_unique<StringIndex>(ref, &m_index_refs, col_ndx, virtual_col, get_alloc());
             }
         }
     }
@@ -2187,6 +2299,15 @@ bool Table::is_cross_table_link_target() const noexcept
     return for_each_backlink_column(is_cross_link);
 }
 
+ref_type Table::typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc) const
+{
+    return Array::write_with_children(ref, alloc, out, [&](size_t ndx, ref_type child_ref) {
+        if (ndx == top_position_for_cluster_tree)
+            return m_clusters.typed_write(child_ref, out, alloc); // Throws
+        return Array::write(child_ref, alloc, out, true);         // Throws
+    });
+}
+
 // LCOV_EXCL_START ignore debug functions
 
 void Table::verify() const
@@ -2930,6 +3051,9 @@ void Table::do_set_primary_key_column(ColKey col_key)
         if (attr.test(col_attr_FullText_Indexed)) {
             throw InvalidColumnKey("primary key cannot have a full text index");
         }
+        if (attr.test(col_attr_Sorted_Indexed)) {
+            throw InvalidColumnKey("primary key cannot have a sorted index");
+        }
     }
 
     if (m_primary_key_col) {
@@ -2954,7 +3078,8 @@ void Table::do_set_primary_key_column(ColKey col_key)
 
 bool Table::contains_unique_values(ColKey col) const
 {
-    if (search_index_type(col) == IndexType::General) {
+    auto index_type = search_index_type(col);
+    if (index_type == IndexType::General || index_type == IndexType::Sorted) {
         auto search_index = get_search_index(col);
         return !search_index->has_duplicate_values();
     }
@@ -57,6 +57,7 @@ class Group;
 class LinkChain;
 class SearchIndex;
 class SortDescriptor;
+class SortedIndex;
 class StringIndex;
 class Subexpr;
 template <class>
@@ -77,6 +78,7 @@ namespace query_parser {
 class Arguments;
 class KeyPathMapping;
 class ParserDriver;
+class PreparedQuery;
 } // namespace query_parser
 
 enum class ExpressionComparisonType : unsigned char {
@@ -227,7 +229,8 @@ public:
     ///
     /// add_search_index() adds a search index to the specified column of the
     /// table. It has no effect if a search index has already been added to the
-    /// specified column (idempotency).
+    /// specified column (idempotency). A sorted index can only be added to a
+    /// Realm with file format 25 or later.
     ///
     /// remove_search_index() removes the search index from the specified column
     /// of the table. It has no effect if the specified column has no search
@@ -260,6 +263,37 @@ public:
     /// debugging purposes.
     size_t get_num_unique_values(ColKey col_key) const;
 
+    /// Estimates of the distribution of the values in a column, made from an
+    /// evenly spread sample of at most `max_sample_size` objects. The query
+    /// engine uses these to estimate how many objects a condition will match.
+    struct ColumnStatistics {
+        static constexpr size_t max_sample_size = 1000;
+
+        size_t num_objects = 0;      // Number of objects in the table when sampled
+        uint64_t version = 0;        // Version of the table in the file when sampled
+        size_t sample_size = 0;
+        size_t num_nulls = 0;       // In the sample
+        double num_distinct = 0.0; // Estimate for the whole table, not counting null
+
+        double null_fraction() const
+        {
+            return sample_size ? double(num_nulls) / sample_size : 0.0;
+        }
+        // Fraction of the objects expected to hold a given value
+        double value_fraction(bool is_null) const
+        {
+            if (is_null)
+                return null_fraction();
+            return num_distinct > 0 ? (1.0 - null_fraction()) / num_distinct : 0.0;
+        }
+    };
+
+    /// The statistics are kept until a newer version of this table is
+    /// committed or read, or the number of objects in the table has changed
+    /// by more than a tenth. Collection columns have no statistics and return
+    /// an empty sample.
+    ColumnStatistics get_column_statistics(ColKey col_key) const;
+
     template <class T>
     Columns<T> column(ColKey col_key, util::Optional<ExpressionComparisonType> = util::none) const;
     template <class T>
@@ -358,6 +392,10 @@ public:
     {
         return m_clusters.traverse(func);
     }
+    bool traverse_clusters(ClusterTree::TraverseFunction func, bool prefetch) const
+    {
+        return m_clusters.traverse(func, prefetch);
+    }
 
     /// remove_object() removes the specified object from the table.
     /// Any links from the specified object into objects residing in an embedded
@@ -439,6 +477,7 @@ public:
     // Will return pointer to search index accessor. Will return nullptr if no index
     SearchIndex* get_search_index(ColKey col) const noexcept;
     StringIndex* get_string_index(ColKey col) const noexcept;
+    const SortedIndex* get_sorted_index(ColKey col) const noexcept;
 
     template <class T>
     ObjKey find_first(ColKey col_key, T value) const;
@@ -604,6 +643,10 @@ public:
                 const query_parser::KeyPathMapping& mapping) const;
     Query query(const std::string& query_string, query_parser::Arguments& arguments,
                 const query_parser::KeyPathMapping&) const;
+    // Run a query string which has already been parsed
+    Query query(const query_parser::PreparedQuery& query, const std::vector<Mixed>& arguments = {}) const;
+    Query query(const query_parser::PreparedQuery& query, query_parser::Arguments& arguments,
+                const query_parser::KeyPathMapping&) const;
 
     //@{
     /// WARNING: The link() and backlink() methods will alter a state on the Table object and return a reference
@@ -732,6 +775,8 @@ private:
     Array m_opposite_table;                    // 7th slot in m_top
     Array m_opposite_column;                   // 8th slot in m_top
     std::vector<std::unique_ptr<SearchIndex>> m_index_accessors;
+    mutable std::mutex m_statistics_mutex; // Queries on frozen tables may run on several threads
+    mutable std::map<ColKey, ColumnStatistics> m_column_statistics;
     ColKey m_primary_key_col;
     Replication* const* m_repl;
     static Replication* g_dummy_replication;
@@ -820,6 +865,11 @@ private:
     /// when the transaction ends.
     void update_from_parent() noexcept;
 
+    /// Called in the context of GroupWriter::write_group() to write the
+    /// modified parts of the table rooted at \a ref using the column types
+    /// known to this accessor. See ClusterTree::typed_write().
+    ref_type typed_write(ref_type ref, _impl::ArrayWriterBase& out, Allocator& alloc) const;
+
     // Detach accessor. This recycles the Table accessor and all subordinate
     // accessors become invalid.
     void detach(LifeCycleCookie) noexcept;
@@ -19,12 +19,66 @@
 #include <realm/table_view.hpp>
 #include <realm/column_integer.hpp>
 #include <realm/index_string.hpp>
+#include <realm/query_cache.hpp>
 #include <realm/transaction.hpp>
 
 #include <unordered_set>
 
 using namespace realm;
 
+namespace {
+
+// Keeps the first `limit` objects in the order of a sort among the matches of
+// a query, so that sorting and limiting a large result only needs to store
+// and sort the objects that are kept.
+class QueryStateSortedLimit : public QueryStateBase {
+public:
+    QueryStateSortedLimit(const BaseDescriptor::Sorter& predicate, size_t limit)
+        : m_predicate(predicate)
+        , m_max_size(limit)
+    {
+    }
+
+    bool match(size_t index, Mixed) noexcept final
+    {
+        return match(index);
+    }
+
+    bool match(size_t index) noexcept final
+    {
+        ObjKey key((m_key_values ? m_key_values->get(index) : index) + m_key_offset);
+        // The position among the matches breaks ties like a stable sort would
+        BaseDescriptor::IndexPair pair(key, m_match_count++);
+        m_predicate.cache_first_column(pair);
+        auto worse = std::ref(m_predicate);
+        if (m_heap.size() < m_max_size) {
+            m_heap.push_back(std::move(pair));
+            std::push_heap(m_heap.begin(), m_heap.end(), worse);
+        }
+        else if (m_max_size && m_predicate(pair, m_heap.front())) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), worse);
+            m_heap.back() = std::move(pair);
+            std::push_heap(m_heap.begin(), m_heap.end(), worse);
+        }
+        return true;
+    }
+
+    // The objects kept, in the order they were found
+    void get_keys(KeyValues& keys)
+    {
+        std::sort(m_heap.begin(), m_heap.end());
+        for (auto& pair : m_heap)
+            keys.add(pair.key_for_object);
+    }
+
+private:
+    const BaseDescriptor::Sorter& m_predicate;
+    size_t m_max_size;
+    std::vector<BaseDescriptor::IndexPair> m_heap;
+};
+
+} // anonymous namespace
+
 TableView::TableView(TableView& src, Transaction* tr, PayloadPolicy policy_mode)
     : m_source_column_key(src.m_source_column_key)
 {
@@ -478,8 +532,39 @@ void TableView::do_sync()
                     limit = l;
             }
         }
-        QueryStateFindAll<std::vector<ObjKey>> st(m_key_values, limit);
-        m_query->do_find_all(st);
+        // The cached result is the one after the descriptors are applied
+        std::string cache_key;
+        uint_fast64_t version;
+        QueryCache* cache = nullptr;
+        if (!m_descriptor_ordering.will_apply_filter()) {
+            cache = m_query->get_result_cache(
+                util::format("find_all %1 %2", int64_t(m_limit), m_descriptor_ordering.get_description(m_table)),
+                cache_key, version);
+        }
+        if (cache) {
+            if (auto result = cache->get(cache_key, version)) {
+                for (ObjKey key : result->keys)
+                    m_key_values.add(key);
+                get_dependencies(m_last_seen_versions);
+                return;
+            }
+        }
+
+        if (!find_sorted_limit(limit)) {
+            QueryStateFindAll<std::vector<ObjKey>> st(m_key_values, limit);
+            m_query->do_find_all(st);
+        }
+        apply_descriptors(m_descriptor_ordering);
+
+        if (cache) {
+            auto result = std::make_shared<QueryCache::Result>();
+            result->keys.reserve(size());
+            for (size_t i = 0; i < size(); ++i)
+                result->keys.push_back(get_key(i));
+            cache->put(cache_key, version, std::move(result));
+        }
+        get_dependencies(m_last_seen_versions);
+        return;
     }
 
     apply_descriptors(m_descriptor_ordering);
@@ -487,6 +572,27 @@ void TableView::do_sync()
     get_dependencies(m_last_seen_versions);
 }
 
+bool TableView::find_sorted_limit(size_t limit)
+{
+    // A sort followed by a small limit only needs the matches which are kept
+    // by the limit. The sort is applied again to those by apply_descriptors().
+    if (limit != size_t(-1) || m_descriptor_ordering.size() < 2 ||
+        m_descriptor_ordering.get_type(0) != DescriptorType::Sort ||
+        m_descriptor_ordering.get_type(1) != DescriptorType::Limit)
+        return false;
+    auto sort = static_cast<const SortDescriptor*>(m_descriptor_ordering[0]);
+    size_t max_size = static_cast<const LimitDescriptor*>(m_descriptor_ordering[1])->get_limit();
+    // Sorting everything is as fast when most of the objects are kept
+    if (sort->has_links() || max_size >= (m_table->size() >> 4))
+        return false;
+
+    BaseDescriptor::Sorter predicate = sort->sorter(*m_table, {});
+    QueryStateSortedLimit st(predicate, max_size);
+    m_query->do_find_all(st);
+    st.get_keys(m_key_values);
+    return true;
+}
+
 void TableView::apply_descriptors(const DescriptorOrdering& ordering)
 {
     if (ordering.is_empty())
@@ -540,6 +646,11 @@ void TableView::apply_descriptors(const DescriptorOrdering& ordering)
                 use_indexpairs();
             }
 
+            if (base_descr->get_type() == DescriptorType::Sort &&
+                static_cast<const SortDescriptor*>(base_descr)->execute_using_index(*m_table, index_pairs, next)) {
+                continue;
+            }
+
             BaseDescriptor::Sorter predicate = base_descr->sorter(*m_table, index_pairs);
 
             // Sorting can be specified by multiple columns, so that if two entries in the first column are
@@ -400,6 +400,7 @@ protected:
     void get_dependencies(TableVersions&) const final;
 
     void do_sync();
+    bool find_sorted_limit(size_t limit);
     void apply_descriptors(const DescriptorOrdering&);
 
     mutable ConstTableRef m_table;
@@ -533,7 +533,7 @@ void Transaction::upgrade_file_format(int target_file_format_version)
     // Be sure to revisit the following upgrade logic when a new file format
     // version is introduced. The following assert attempt to help you not
     // forget it.
-    REALM_ASSERT_EX(target_file_format_version == 24, target_file_format_version);
+    REALM_ASSERT_EX(target_file_format_version == 25, target_file_format_version);
 
     // DB::do_open() must ensure that only supported version are allowed.
     // It does that by asking backup if the current file format version is
@@ -584,6 +584,10 @@ void Transaction::upgrade_file_format(int target_file_format_version)
             t->migrate_col_keys();
         }
     }
+    // Version 25 only adds encodings which are written by new commits, so
+    // nothing has to be converted when upgrading from version 24. The bump
+    // keeps older versions of Realm from opening files that may contain them.
+
     // NOTE: Additional future upgrade steps go here.
 }
 
@@ -904,6 +908,7 @@ public:
             if ((current_node.get_ref() + byte_size) > m_evac_limit) {
                 current_node.copy_on_write();
                 m_moved++;
+                m_moved_bytes += byte_size;
                 m_work_limit -= byte_size;
             }
         }
@@ -934,14 +939,20 @@ public:
         return true;
     }
 
+    size_t get_moved_bytes() const noexcept
+    {
+        return m_moved_bytes;
+    }
+
 private:
     size_t m_evac_limit;
     int64_t m_work_limit;
     size_t m_moved;
+    size_t m_moved_bytes = 0;
 };
 
 
-void Transaction::cow_outliers(std::vector<size_t>& progress, size_t evac_limit, size_t work_limit)
+size_t Transaction::cow_outliers(std::vector<size_t>& progress, size_t evac_limit, size_t work_limit)
 {
     NodeTree node_tree(evac_limit, work_limit);
     if (progress.empty()) {
@@ -949,12 +960,12 @@ void Transaction::cow_outliers(std::vector<size_t>& progress, size_t evac_limit,
     }
     if (progress[0] == s_table_name_ndx) {
         if (!node_tree.trv(m_table_names, 1, progress))
-            return;
+            return node_tree.get_moved_bytes();
         progress.back() = s_table_refs_ndx; // Handle tables next
     }
     if (progress[0] == s_table_refs_ndx) {
         if (!node_tree.trv(m_tables, 1, progress))
-            return;
+            return node_tree.get_moved_bytes();
         progress.back() = s_hist_ref_ndx; // Handle history next
     }
     if (progress[0] == s_hist_ref_ndx && m_top.get(s_hist_ref_ndx)) {
@@ -962,9 +973,10 @@ void Transaction::cow_outliers(std::vector<size_t>& progress, size_t evac_limit,
         hist_arr.set_parent(&m_top, s_hist_ref_ndx);
         hist_arr.init_from_parent();
         if (!node_tree.trv(hist_arr, 1, progress))
-            return;
+            return node_tree.get_moved_bytes();
     }
     progress.clear();
+    return node_tree.get_moved_bytes();
 }
 
 } // namespace realm
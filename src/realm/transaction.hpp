@@ -169,6 +169,11 @@ public:
         return db->m_logger;
     }
 
+    QueryCache* get_query_cache() const noexcept
+    {
+        return db->get_query_cache();
+    }
+
 private:
     enum class AsyncState { Idle, Requesting, HasLock, HasCommits, Syncing };
 
@@ -192,7 +197,7 @@ private:
     void complete_async_commit();
     void acquire_write_lock() REQUIRES(!m_async_mutex);
 
-    void cow_outliers(std::vector<size_t>& progress, size_t evac_limit, size_t work_limit);
+    size_t cow_outliers(std::vector<size_t>& progress, size_t evac_limit, size_t work_limit);
     void close_read_with_lock() REQUIRES(!m_async_mutex, db->m_mutex);
 
     DBRef db;
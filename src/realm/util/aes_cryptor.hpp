@@ -77,6 +77,21 @@ public:
     ReadResult read(FileDesc fd, File::SizeType pos, char* dst, WriteObserver* observer = nullptr);
     void try_read_block(FileDesc fd, File::SizeType pos, char* dst) noexcept;
     void write(FileDesc fd, File::SizeType pos, const char* src, WriteMarker* marker = nullptr) noexcept;
+
+    // A page for read_pages() or write_pages()
+    struct PageIO {
+        File::SizeType pos;
+        char* addr;
+        ReadResult result = ReadResult::Success;
+    };
+    // Read several pages, as read() would, but with the decryption spread over
+    // the worker pool.
+    void read_pages(FileDesc fd, PageIO* pages, size_t count, WriteObserver* observer = nullptr);
+    // Write several pages, as write() would, but with the encryption spread
+    // over the worker pool. The pages are still written to the file in order
+    // by the calling thread.
+    void write_pages(FileDesc fd, const PageIO* pages, size_t count, WriteMarker* marker = nullptr) noexcept;
+
     bool refresh_iv(FileDesc fd, size_t page_ndx);
     void invalidate_ivs() noexcept;
 
@@ -117,6 +132,9 @@ private:
     std::vector<bool> m_iv_blocks_read;
     std::unique_ptr<char[]> m_rw_buffer;
     std::unique_ptr<char[]> m_dst_buffer;
+    // Cryptors with their own contexts and buffers for the worker threads
+    std::vector<std::unique_ptr<AESCryptor>> m_workers;
+    std::unique_ptr<char[]> m_write_batch_buffer;
 
     bool constant_time_equals(const Hmac&, const Hmac&) const;
     void calculate_hmac(Hmac&) const;
@@ -126,6 +144,20 @@ private:
     void read_iv_block(FileDesc fd, File::SizeType data_pos);
     ReadResult attempt_read(FileDesc fd, File::SizeType pos, char* dst, IVLookupMode iv_mode, uint32_t& iv,
                             Hmac& hmac);
+    // Decrypt the page at `pos` using `iv`, which is left unchanged. Returns
+    // Failed if the data does not match hmac1.
+    ReadResult decrypt_page(FileDesc fd, File::SizeType pos, char* dst, const IVTable& iv) noexcept;
+    // Bump the IV and encrypt the page into `dst`
+    void encrypt_page(File::SizeType pos, const char* src, IVTable& iv, char* dst) noexcept;
+    // Split `count` pages into chunks and call func(worker, begin, end) for
+    // each chunk on the worker pool
+    template <class F>
+    void for_each_chunk(size_t count, F&& func);
+    // The parallel part of write_pages(). `written` is the number of pages
+    // written so far, so that the rest can be written by write() if memory
+    // runs out.
+    void write_pages_in_batches(FileDesc fd, const PageIO* pages, size_t count, WriteMarker* marker,
+                                size_t& written);
 };
 } // namespace realm::util
 
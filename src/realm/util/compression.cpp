@@ -20,6 +20,7 @@
 #include <realm/util/safe_int_ops.hpp>
 #include <realm/util/scope_exit.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <map>
@@ -832,13 +833,15 @@ std::error_code compression::decompress_nonportable(InputStream& compressed, App
 
 std::error_code compression::allocate_and_compress(CompressMemoryArena& compress_memory_arena,
                                                    Span<const char> uncompressed_buf,
-                                                   std::vector<char>& compressed_buf)
+                                                   std::vector<char>& compressed_buf, int compression_level)
 {
-    const int compression_level = 1;
     std::size_t compressed_size = 0;
 
-    if (compressed_buf.size() < 256)
-        compressed_buf.resize(256); // Throws
+    // Make room for the worst case up front, as running out of room means
+    // compressing everything again
+    std::size_t bound = compress_bound(uncompressed_buf.size());
+    if (compressed_buf.size() < std::max<std::size_t>(bound, 256))
+        compressed_buf.resize(std::max<std::size_t>(bound, 256)); // Throws
 
     for (;;) {
         init_arena(compress_memory_arena);
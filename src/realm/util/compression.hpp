@@ -153,10 +153,11 @@ std::error_code decompress(InputStream& compressed, Span<char> decompressed_buf)
 /// allocate_and_compress() compresses the data in \a uncompressed_buf using
 /// zlib, storing the result in \a compressed_buf. \a compressed_buf is resized
 /// to the required size, and on non-error return has size equal to the
-/// compressed size. All errors other than std::bad_alloc are returned as an
-/// error code of categrory compression::error_code.
+/// compressed size. \a compression_level is as for compress(). All errors
+/// other than std::bad_alloc are returned as an error code of categrory
+/// compression::error_code.
 std::error_code allocate_and_compress(CompressMemoryArena& compress_memory_arena, Span<const char> uncompressed_buf,
-                                      std::vector<char>& compressed_buf);
+                                      std::vector<char>& compressed_buf, int compression_level = 1);
 
 /// decompress() decompresses data produced by
 /// allocate_and_compress_nonportable() in \a compressed into \a decompressed.
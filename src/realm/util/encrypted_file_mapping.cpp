@@ -28,6 +28,7 @@
 #include <realm/util/errno.hpp>
 #include <realm/util/sha_crypto.hpp>
 #include <realm/util/terminate.hpp>
+#include <realm/util/worker_pool.hpp>
 #include <realm/utilities.hpp>
 
 #include <algorithm>
@@ -153,6 +154,11 @@ constexpr uint8_t aes_block_size = 16;
 constexpr uint16_t encryption_page_size = 4096;
 constexpr uint8_t metadata_size = sizeof(IVTable);
 constexpr uint8_t pages_per_block = encryption_page_size / metadata_size;
+// Batches of fewer pages are not worth handing to the worker pool
+constexpr size_t min_pages_per_worker = 2;
+constexpr size_t min_parallel_pages = 2 * min_pages_per_worker;
+// Maximum number of pages encrypted ahead of being written
+constexpr size_t write_batch_pages = 256;
 static_assert(metadata_size == 64,
               "changing the size of the metadata breaks compatibility with existing Realm files");
 
@@ -564,10 +570,8 @@ void AESCryptor::try_read_block(FileDesc fd, SizeType pos, char* dst) noexcept
     crypt(mode_Decrypt, pos, dst, m_rw_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
 }
 
-void AESCryptor::write(FileDesc fd, SizeType pos, const char* src, WriteMarker* marker) noexcept
+void AESCryptor::encrypt_page(SizeType pos, const char* src, IVTable& iv, char* dst) noexcept
 {
-    IVTable& iv = get_iv_table(fd, pos);
-
     memcpy(&iv.iv2, &iv.iv1, 32); // this is also copying the hmac
     do {
         ++iv.iv1;
@@ -575,13 +579,19 @@ void AESCryptor::write(FileDesc fd, SizeType pos, const char* src, WriteMarker*
         if (iv.iv1 == 0)
             ++iv.iv1;
 
-        crypt(mode_Encrypt, pos, m_rw_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
-        hmac_sha224(Span(reinterpret_cast<uint8_t*>(m_rw_buffer.get()), encryption_page_size), iv.hmac1,
+        crypt(mode_Encrypt, pos, dst, src, reinterpret_cast<const char*>(&iv.iv1));
+        hmac_sha224(Span(reinterpret_cast<uint8_t*>(dst), encryption_page_size), iv.hmac1,
                     Span(m_key).sub_span<32>());
         // In the extremely unlikely case that both the old and new versions have
         // the same hash we won't know which IV to use, so bump the IV until
         // they're different.
     } while (REALM_UNLIKELY(iv.hmac1 == iv.hmac2));
+}
+
+void AESCryptor::write(FileDesc fd, SizeType pos, const char* src, WriteMarker* marker) noexcept
+{
+    IVTable& iv = get_iv_table(fd, pos);
+    encrypt_page(pos, src, iv, m_rw_buffer.get());
 
     if (marker)
         marker->mark(pos);
@@ -595,6 +605,120 @@ void AESCryptor::write(FileDesc fd, SizeType pos, const char* src, WriteMarker*
     m_iv_buffer_cache[page_index(pos)] = iv;
 }
 
+template <class F>
+void AESCryptor::for_each_chunk(size_t count, F&& func)
+{
+    auto& pool = WorkerPool::get_default();
+    size_t num_chunks = std::min<size_t>(pool.get_num_threads() + 1, count / min_pages_per_worker);
+    if (num_chunks <= 1) {
+        func(*this, 0, count);
+        return;
+    }
+    // Each chunk needs its own cipher context and buffers
+    while (m_workers.size() < num_chunks - 1)
+        m_workers.push_back(std::make_unique<AESCryptor>(get_key())); // Throws
+    pool.run(num_chunks, [&](size_t chunk) {                          // Throws
+        AESCryptor& cryptor = chunk == 0 ? *this : *m_workers[chunk - 1];
+        func(cryptor, chunk * count / num_chunks, (chunk + 1) * count / num_chunks);
+    });
+}
+
+void AESCryptor::read_pages(FileDesc fd, PageIO* pages, size_t count, WriteObserver* observer)
+{
+    // The parallel path trusts the cached IVs, so it can only be used if no
+    // other process may be writing to the file
+    if (count >= min_parallel_pages && (!observer || observer->no_concurrent_writer_seen())) {
+        std::vector<IVTable> ivs;
+        ivs.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            ivs.push_back(get_iv_table(fd, pages[i].pos));
+        for_each_chunk(count, [&](AESCryptor& cryptor, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (ivs[i].iv1 == 0)
+                    pages[i].result = ReadResult::Uninitialized;
+                else
+                    pages[i].result = cryptor.decrypt_page(fd, pages[i].pos, pages[i].addr, ivs[i]);
+            }
+        });
+        // Pages which did not verify need the full treatment, which may
+        // update the IV table
+        for (size_t i = 0; i < count; ++i) {
+            if (pages[i].result == ReadResult::Failed)
+                pages[i].result = read(fd, pages[i].pos, pages[i].addr, observer);
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+        pages[i].result = read(fd, pages[i].pos, pages[i].addr, observer);
+}
+
+AESCryptor::ReadResult AESCryptor::decrypt_page(FileDesc fd, SizeType pos, char* dst, const IVTable& iv) noexcept
+{
+    size_t actual = check_read(fd, data_pos_to_file_pos(pos), m_rw_buffer.get());
+    if (actual < encryption_page_size)
+        return ReadResult::Eof;
+    Hmac hmac;
+    calculate_hmac(hmac);
+    if (!constant_time_equals(hmac, iv.hmac1))
+        return ReadResult::Failed;
+    // See attempt_read() for why this goes through a temporary buffer
+    crypt(mode_Decrypt, pos, m_dst_buffer.get(), m_rw_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
+    memcpy_if_changed(dst, m_dst_buffer.get(), encryption_page_size);
+    return ReadResult::Success;
+}
+
+void AESCryptor::write_pages(FileDesc fd, const PageIO* pages, size_t count, WriteMarker* marker) noexcept
+{
+    size_t written = 0;
+    if (count >= min_parallel_pages) {
+        try {
+            write_pages_in_batches(fd, pages, count, marker, written);
+        }
+        catch (const std::bad_alloc&) {
+            // Out of memory for the buffers or the helper cryptors. Nothing
+            // of the batch being prepared has been written, so the remaining
+            // pages take the path which needs no memory.
+        }
+    }
+    for (size_t i = written; i < count; ++i)
+        write(fd, pages[i].pos, pages[i].addr, marker);
+}
+
+void AESCryptor::write_pages_in_batches(FileDesc fd, const PageIO* pages, size_t count, WriteMarker* marker,
+                                        size_t& written)
+{
+    if (!m_write_batch_buffer)
+        m_write_batch_buffer.reset(new char[write_batch_pages * encryption_page_size]); // Throws
+    std::vector<IVTable> ivs;
+    ivs.reserve(std::min(count, write_batch_pages)); // Throws
+    for (size_t batch_begin = 0; batch_begin < count; batch_begin += write_batch_pages) {
+        size_t batch_size = std::min(count - batch_begin, write_batch_pages);
+        const PageIO* batch = pages + batch_begin;
+        ivs.clear();
+        for (size_t i = 0; i < batch_size; ++i)
+            ivs.push_back(get_iv_table(fd, batch[i].pos));
+        for_each_chunk(batch_size, [&](AESCryptor& cryptor, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                cryptor.encrypt_page(batch[i].pos, batch[i].addr, ivs[i],
+                                     m_write_batch_buffer.get() + i * encryption_page_size);
+        });
+        // Write in order, each IV table entry ahead of its page, as write() does
+        for (size_t i = 0; i < batch_size; ++i) {
+            SizeType pos = batch[i].pos;
+            if (marker)
+                marker->mark(pos);
+            File::write_static(fd, iv_table_pos(pos), reinterpret_cast<const char*>(&ivs[i]), sizeof(IVTable));
+            File::write_static(fd, data_pos_to_file_pos(pos), m_write_batch_buffer.get() + i * encryption_page_size,
+                               encryption_page_size);
+            if (marker)
+                marker->unmark();
+            m_iv_buffer[page_index(pos)] = ivs[i];
+            m_iv_buffer_cache[page_index(pos)] = ivs[i];
+        }
+        written = batch_begin + batch_size;
+    }
+}
+
 void AESCryptor::crypt(EncryptionMode mode, SizeType pos, char* dst, const char* src, const char* stored_iv) noexcept
 {
     uint8_t iv[aes_block_size] = {0};
@@ -797,7 +921,29 @@ void EncryptedFileMapping::refresh_page(size_t local_ndx, bool to_modify)
     }
 
     char* addr = page_addr(local_ndx);
-    switch (m_file.cryptor.read(m_file.fd, page_pos(local_ndx), addr, m_observer)) {
+    handle_read_result(local_ndx, m_file.cryptor.read(m_file.fd, page_pos(local_ndx), addr, m_observer), to_modify);
+}
+
+void EncryptedFileMapping::refresh_pages(size_t begin, size_t end, bool to_modify)
+{
+    std::vector<AESCryptor::PageIO> reads;
+    for (size_t local_ndx = begin; local_ndx < end; ++local_ndx) {
+        if (is(m_page_state[local_ndx], UpToDate))
+            continue;
+        REALM_ASSERT(is_not(m_page_state[local_ndx], Dirty));
+        REALM_ASSERT(is_not(m_page_state[local_ndx], Writable));
+        if (copy_up_to_date_page(local_ndx) || check_possibly_stale_page(local_ndx))
+            continue;
+        reads.push_back({page_pos(local_ndx), page_addr(local_ndx)});
+    }
+    m_file.cryptor.read_pages(m_file.fd, reads.data(), reads.size(), m_observer);
+    for (auto& read : reads)
+        handle_read_result(page_index(read.pos) - m_first_page, read.result, to_modify);
+}
+
+void EncryptedFileMapping::handle_read_result(size_t local_ndx, AESCryptor::ReadResult result, bool to_modify)
+{
+    switch (result) {
         case AESCryptor::ReadResult::Eof:
             if (!to_modify)
                 throw_decryption_error(local_ndx, "is out of bounds");
@@ -923,6 +1069,18 @@ void EncryptedFileMapping::validate() noexcept
 
 void EncryptedFileMapping::do_flush(bool skip_validate) noexcept
 {
+    std::vector<AESCryptor::PageIO> writes;
+    size_t num_dirty = std::count_if(m_page_state.begin(), m_page_state.end(), [](auto& state) {
+        return is(state, Dirty);
+    });
+    bool batched = true;
+    try {
+        writes.reserve(num_dirty); // Throws
+    }
+    catch (const std::bad_alloc&) {
+        // Without room for the list, the pages are written one at a time
+        batched = false;
+    }
     for (size_t i = 0; i < m_page_state.size(); ++i) {
         if (is_not(m_page_state[i], Dirty)) {
             if (!skip_validate) {
@@ -930,9 +1088,13 @@ void EncryptedFileMapping::do_flush(bool skip_validate) noexcept
             }
             continue;
         }
-        m_file.cryptor.write(m_file.fd, page_pos(i), page_addr(i), m_marker);
+        if (batched)
+            writes.push_back({page_pos(i), page_addr(i)});
+        else
+            m_file.cryptor.write(m_file.fd, page_pos(i), page_addr(i), m_marker);
         clear(m_page_state[i], Dirty);
     }
+    m_file.cryptor.write_pages(m_file.fd, writes.data(), writes.size(), m_marker);
 
     // some of the tests call flush() on very small writes which results in
     // validating on every flush being unreasonably slow
@@ -1000,6 +1162,15 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, bool to_m
     REALM_ASSERT(size > 0);
     size_t begin = get_local_index_of_address(addr);
     size_t end = get_local_index_of_address(addr, size - 1);
+    if (end - begin >= min_parallel_pages) {
+        // Large ranges are decrypted in parallel
+        refresh_pages(begin, end + 1, to_modify);
+        if (to_modify) {
+            for (size_t local_ndx = begin; local_ndx <= end; ++local_ndx)
+                set(m_page_state[local_ndx], Writable);
+        }
+        return;
+    }
     for (size_t local_ndx = begin; local_ndx <= end; ++local_ndx) {
         PageState& ps = m_page_state[local_ndx];
         if (is_not(ps, UpToDate))
@@ -1009,6 +1180,34 @@ void EncryptedFileMapping::read_barrier(const void* addr, size_t size, bool to_m
     }
 }
 
+void EncryptedFileMapping::prefetch(const void* addr, size_t size) noexcept
+{
+    CheckedLockGuard lock(m_file.mutex);
+    if (size == 0 || addr < m_addr)
+        return;
+    size_t begin = get_local_index_of_address(addr);
+    size_t end = std::min(get_local_index_of_address(addr, size - 1) + 1, m_page_state.size());
+    std::vector<AESCryptor::PageIO> reads;
+    for (size_t local_ndx = begin; local_ndx < end; ++local_ndx) {
+        if (is(m_page_state[local_ndx], UpToDate | Writable | Dirty))
+            continue;
+        if (copy_up_to_date_page(local_ndx) || check_possibly_stale_page(local_ndx))
+            continue;
+        reads.push_back({page_pos(local_ndx), page_addr(local_ndx)});
+    }
+    try {
+        m_file.cryptor.read_pages(m_file.fd, reads.data(), reads.size(), m_observer);
+    }
+    catch (...) {
+        // Any problem will be reported when the data is actually read
+        return;
+    }
+    for (auto& read : reads) {
+        if (read.result == AESCryptor::ReadResult::Success)
+            set(m_page_state[page_index(read.pos) - m_first_page], UpToDate);
+    }
+}
+
 void EncryptedFileMapping::extend_to(SizeType offset, size_t new_size)
 {
     CheckedLockGuard lock(m_file.mutex);
@@ -86,6 +86,11 @@ public:
     // Pages selected must have been marked for modification at an earlier read barrier
     void write_barrier(const void* addr, size_t size) noexcept REQUIRES(!m_file.mutex);
 
+    // Decrypt the pages in the specified range ahead of a read barrier, with
+    // the work spread over the worker pool. Pages which cannot be read are
+    // skipped, so that the error is reported by the read barrier instead.
+    void prefetch(const void* addr, size_t size) noexcept REQUIRES(!m_file.mutex);
+
     // Set this mapping to a new address and size
     // Flushes any remaining dirty pages from the old mapping
     void set(void* new_addr, size_t new_size, File::SizeType new_file_offset) REQUIRES(!m_file.mutex);
@@ -153,6 +158,9 @@ private:
     bool copy_up_to_date_page(size_t local_ndx) noexcept REQUIRES(m_file.mutex);
     bool check_possibly_stale_page(size_t local_ndx) noexcept REQUIRES(m_file.mutex);
     void refresh_page(size_t local_ndx, bool to_modify) REQUIRES(m_file.mutex);
+    void refresh_pages(size_t begin, size_t end, bool to_modify) REQUIRES(m_file.mutex);
+    void handle_read_result(size_t local_ndx, AESCryptor::ReadResult result, bool to_modify)
+        REQUIRES(m_file.mutex);
     void write_and_update_all(size_t local_ndx, uint16_t offset, uint16_t size) noexcept REQUIRES(m_file.mutex);
     void validate_page(size_t local_ndx) noexcept REQUIRES(m_file.mutex);
     void validate() noexcept REQUIRES(m_file.mutex);
@@ -31,6 +31,7 @@
 #else
 #include <cerrno>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #endif
 
 #if REALM_ENABLE_ENCRYPTION
@@ -189,6 +190,49 @@ void* mmap_anon(size_t size)
 #endif
 }
 
+void* mmap_anon(size_t size, HugePages huge_pages)
+{
+#if defined(_WIN32) || !defined(MADV_HUGEPAGE)
+    static_cast<void>(huge_pages);
+    return mmap_anon(size);
+#else
+    if (huge_pages == HugePages::off)
+        return mmap_anon(size);
+    REALM_ASSERT_DEBUG(size % huge_page_size == 0);
+#ifdef MAP_HUGETLB
+    if (huge_pages == HugePages::hugetlb) {
+        void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED)
+            return addr;
+        // The pool of reserved huge pages is empty or not configured
+    }
+#endif
+    // Transparent huge pages are only used for 2MB aligned ranges, so over
+    // allocate and trim the ends to get an aligned range.
+    char* addr = static_cast<char*>(mmap_anon(size + huge_page_size));
+    size_t misalignment = reinterpret_cast<uintptr_t>(addr) & (huge_page_size - 1);
+    size_t head = misalignment ? huge_page_size - misalignment : 0;
+    if (head)
+        ::munmap(addr, head);
+    if (size_t tail = huge_page_size - head)
+        ::munmap(addr + head + size, tail);
+    addr += head;
+    advise_huge_pages(addr, size);
+    return addr;
+#endif
+}
+
+void advise_huge_pages(void* addr, size_t size) noexcept
+{
+#if defined(_WIN32) || !defined(MADV_HUGEPAGE)
+    static_cast<void>(addr);
+    static_cast<void>(size);
+#else
+    auto shift = reinterpret_cast<uintptr_t>(addr) & (page_size() - 1);
+    ::madvise(static_cast<char*>(addr) - shift, size + shift, MADV_HUGEPAGE);
+#endif
+}
+
 #ifndef _WIN32
 void* mmap_fixed(FileDesc fd, void* address_request, size_t size, File::AccessMode access, uint64_t offset)
 {
@@ -248,6 +292,48 @@ void msync(FileDesc fd, void* addr, size_t size)
 #endif
 }
 
+void madvise(void* addr, size_t size, AccessPattern pattern) noexcept
+{
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+    static_cast<void>(addr);
+    static_cast<void>(size);
+    static_cast<void>(pattern);
+#else
+    // madvise() requires a page aligned address
+    auto shift = reinterpret_cast<uintptr_t>(addr) & (page_size() - 1);
+    addr = static_cast<char*>(addr) - shift;
+    size += shift;
+    int advice = MADV_NORMAL;
+    switch (pattern) {
+        case AccessPattern::normal:
+            break;
+        case AccessPattern::sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case AccessPattern::random:
+            advice = MADV_RANDOM;
+            break;
+        case AccessPattern::will_need:
+            advice = MADV_WILLNEED;
+            break;
+    }
+    ::madvise(addr, size, advice);
+#endif
+}
+
+PageFaultCounts get_page_fault_counts() noexcept
+{
+    PageFaultCounts counts;
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        counts.minor = uint64_t(usage.ru_minflt);
+        counts.major = uint64_t(usage.ru_majflt);
+    }
+#endif
+    return counts;
+}
+
 #if REALM_ENABLE_ENCRYPTION
 void do_encryption_read_barrier(const void* addr, size_t size, EncryptedFileMapping* mapping, bool to_modify)
 {
@@ -258,6 +344,11 @@ void do_encryption_write_barrier(const void* addr, size_t size, EncryptedFileMap
 {
     mapping->write_barrier(addr, size);
 }
+
+void do_encryption_prefetch(const void* addr, size_t size, EncryptedFileMapping* mapping) noexcept
+{
+    mapping->prefetch(addr, size);
+}
 #endif // REALM_ENABLE_ENCRYPTION
 
 } // namespace realm::util
@@ -37,6 +37,45 @@ void munmap(void* addr, size_t size);
 void msync(FileDesc fd, void* addr, size_t size);
 void* mmap_anon(size_t size);
 
+enum class HugePages {
+    off,
+    transparent, // Ask for transparent huge pages
+    hugetlb,     // Use the pool of explicitly reserved huge pages, else transparent ones
+};
+
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+/// Map anonymous memory backed by huge pages as requested. The size must be a
+/// multiple of huge_page_size unless \a huge_pages is `off`. Falls back to
+/// normal pages if huge pages are not available, so the only failure is
+/// running out of memory or address space, as for mmap_anon(size).
+void* mmap_anon(size_t size, HugePages huge_pages);
+
+/// Hint that the specified mapped range should be backed by transparent huge
+/// pages where the kernel and filesystem support it. Failures are ignored.
+void advise_huge_pages(void* addr, size_t size) noexcept;
+
+enum class AccessPattern {
+    normal,     // No particular pattern, let the OS decide
+    sequential, // Read ahead aggressively, and drop pages soon after use
+    random,     // Do not read ahead
+    will_need,  // Start reading in the pages now
+};
+
+/// Tell the OS how the specified memory-mapped range is going to be accessed.
+/// This is only a hint, so any failure is ignored. Does nothing on platforms
+/// without madvise().
+void madvise(void* addr, size_t size, AccessPattern pattern) noexcept;
+
+struct PageFaultCounts {
+    uint64_t minor = 0; // Resolved without I/O
+    uint64_t major = 0; // Required reading from the file
+};
+
+/// The page faults incurred by the process so far. Zero on platforms that do
+/// not report them.
+PageFaultCounts get_page_fault_counts() noexcept;
+
 #if REALM_ENABLE_ENCRYPTION
 
 void* mmap_fixed(FileDesc fd, void* address_request, size_t size, File::AccessMode access, uint64_t offset);
@@ -45,11 +84,13 @@ std::unique_ptr<EncryptedFileMapping> reserve_mapping(void* addr, const FileAttr
 
 void do_encryption_read_barrier(const void* addr, size_t size, EncryptedFileMapping* mapping, bool to_modify);
 void do_encryption_write_barrier(const void* addr, size_t size, EncryptedFileMapping* mapping);
+void do_encryption_prefetch(const void* addr, size_t size, EncryptedFileMapping* mapping) noexcept;
 
 #else
 
 inline void do_encryption_read_barrier(const void*, size_t, EncryptedFileMapping*, bool) {}
 inline void do_encryption_write_barrier(const void*, size_t, EncryptedFileMapping*) {}
+inline void do_encryption_prefetch(const void*, size_t, EncryptedFileMapping*) noexcept {}
 
 #endif
 
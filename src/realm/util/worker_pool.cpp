@@ -0,0 +1,210 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/worker_pool.hpp>
+
+#include <realm/util/assert.hpp>
+#include <realm/util/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace realm::util {
+
+struct WorkerPool::Job {
+    Job(size_t c, FunctionRef<void(size_t)> f, unsigned helpers)
+        : count(c)
+        , func(f)
+        , helpers_wanted(helpers)
+    {
+    }
+
+    const size_t count;
+    FunctionRef<void(size_t)> func;
+    std::atomic<size_t> next_index = 0;
+    unsigned helpers_wanted; // Guarded by the pool mutex
+    unsigned active_helpers = 0;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    void work() noexcept
+    {
+        for (;;) {
+            size_t i = next_index.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count)
+                return;
+            try {
+                func(i);
+            }
+            catch (...) {
+                // Skip whatever is left
+                next_index.store(count, std::memory_order_relaxed);
+                std::lock_guard lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    }
+};
+
+WorkerPool::WorkerPool(unsigned num_threads)
+{
+    m_threads.reserve(num_threads);
+    for (unsigned i = 0; i < num_threads; ++i) {
+        m_threads.emplace_back([this] {
+            worker_main();
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() noexcept
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_available.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+WorkerPool& WorkerPool::get_default()
+{
+    // Never destroyed, as the threads may not be joinable at exit, such as
+    // in a child process after fork()
+    static WorkerPool& pool = *new WorkerPool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return pool;
+}
+
+void WorkerPool::worker_main()
+{
+    Thread::set_name("realm-worker");
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_work_available.wait(lock, [&] {
+            return m_stop || !m_jobs.empty();
+        });
+        if (m_stop)
+            return;
+        Job* job = m_jobs.front();
+        if (--job->helpers_wanted == 0)
+            m_jobs.pop_front();
+        ++job->active_helpers;
+        lock.unlock();
+        job->work();
+        lock.lock();
+        if (--job->active_helpers == 0)
+            m_job_done.notify_all();
+    }
+}
+
+void WorkerPool::submit(Job& job, unsigned helpers)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(&job);
+    }
+    for (unsigned i = 0; i < helpers; ++i)
+        m_work_available.notify_one();
+}
+
+void WorkerPool::wait_for(Job& job)
+{
+    // Make sure that no more helpers pick up the job, and wait for the ones
+    // that did to finish
+    std::unique_lock lock(m_mutex);
+    auto it = std::find(m_jobs.begin(), m_jobs.end(), &job);
+    if (it != m_jobs.end())
+        m_jobs.erase(it);
+    m_job_done.wait(lock, [&] {
+        return job.active_helpers == 0;
+    });
+}
+
+void WorkerPool::run(size_t count, FunctionRef<void(size_t)> func, unsigned max_threads)
+{
+    size_t helpers = std::min<size_t>({count, max_threads, size_t(m_threads.size()) + 1});
+    if (helpers <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    Job job(count, func, unsigned(helpers - 1));
+    submit(job, unsigned(helpers - 1));
+    job.work();
+    wait_for(job);
+    if (job.error)
+        std::rethrow_exception(job.error);
+}
+
+struct WorkerPool::Task::State {
+    State(WorkerPool& p, FunctionRef<void()> f)
+        : pool(p)
+        , func(f)
+    {
+    }
+
+    WorkerPool& pool;
+    FunctionRef<void()> func;
+    struct Call {
+        State* state;
+        void operator()(size_t)
+        {
+            state->func();
+        }
+    } call{this};
+    Job job{1, call, 1};
+    bool joined = false;
+};
+
+WorkerPool::Task::Task(std::unique_ptr<State> state) noexcept
+    : m_state(std::move(state))
+{
+}
+
+WorkerPool::Task::Task(Task&&) noexcept = default;
+
+WorkerPool::Task::~Task() noexcept
+{
+    if (m_state && !m_state->joined) {
+        m_state->job.work();
+        m_state->pool.wait_for(m_state->job);
+    }
+}
+
+void WorkerPool::Task::join()
+{
+    REALM_ASSERT(m_state && !m_state->joined);
+    m_state->joined = true;
+    m_state->job.work();
+    m_state->pool.wait_for(m_state->job);
+    if (m_state->job.error)
+        std::rethrow_exception(m_state->job.error);
+}
+
+WorkerPool::Task WorkerPool::start(FunctionRef<void()> func)
+{
+    auto state = std::make_unique<Task::State>(*this, func); // Throws
+    if (!m_threads.empty())
+        submit(state->job, 1);
+    return Task(std::move(state));
+}
+
+} // namespace realm::util
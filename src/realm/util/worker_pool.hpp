@@ -0,0 +1,104 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_WORKER_POOL_HPP
+#define REALM_UTIL_WORKER_POOL_HPP
+
+#include <realm/util/function_ref.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace realm::util {
+
+/// A fixed set of worker threads for splitting CPU bound work into
+/// independent pieces.
+///
+/// The thread calling run() takes part in the work itself, so calls to run()
+/// may be nested, and a pool without any threads simply does all the work on
+/// the calling thread.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned num_threads);
+    ~WorkerPool() noexcept;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /// The pool shared by the whole process. It has one thread less than the
+    /// number of hardware threads, and the threads are started on first use.
+    static WorkerPool& get_default();
+
+    unsigned get_num_threads() const noexcept
+    {
+        return unsigned(m_threads.size());
+    }
+
+    /// Call `func(i)` for every `i` in [0, count), spreading the calls over at
+    /// most `max_threads` threads including the calling one. Returns when all
+    /// the calls have returned. If a call throws, the calls that have not yet
+    /// started are skipped, and the first exception is rethrown here.
+    void run(size_t count, FunctionRef<void(size_t)> func, unsigned max_threads = unsigned(-1));
+
+    /// A call started by start(). join() must be called before the function
+    /// passed to start() goes out of scope; the destructor waits for the call
+    /// as well, but discards any exception.
+    class Task {
+    public:
+        Task(Task&&) noexcept;
+        ~Task() noexcept;
+
+        /// Returns when the call has returned, and rethrows what it threw. If
+        /// no pool thread has picked up the call yet, it is made here.
+        void join();
+
+    private:
+        struct State;
+        std::unique_ptr<State> m_state;
+
+        explicit Task(std::unique_ptr<State>) noexcept;
+        friend class WorkerPool;
+    };
+
+    /// Call `func()` on one of the pool threads and return at once, so the
+    /// calling thread can do other work meanwhile.
+    Task start(FunctionRef<void()> func);
+
+private:
+    struct Job;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_available;
+    std::condition_variable m_job_done;
+    std::deque<Job*> m_jobs; // Jobs that can use more threads
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+
+    void worker_main();
+    void submit(Job&, unsigned helpers);
+    void wait_for(Job&);
+};
+
+} // namespace realm::util
+
+#endif // REALM_UTIL_WORKER_POOL_HPP
@@ -103,6 +103,8 @@ void cpuid_init()
     }
 
     bool avxSupported = false;
+    bool avx2Supported = false;
+    bool avx512Supported = false;
 
 // seems like in jenkins builds, __GNUC__ is defined for clang?! todo fixme
 #if !defined __clang__ && ((defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219) || defined __GNUC__)
@@ -112,19 +114,47 @@ void cpuid_init()
     if (osUsesXSAVE_XRSTORE && cpuAVXSuport) {
         // Check if the OS will save the YMM registers
         unsigned long long xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
-        avxSupported = (xcrFeatureMask & 0x6) || false;
+        avxSupported = (xcrFeatureMask & 0x6) == 0x6;
+
+        // AVX2 and AVX-512 are reported in the extended feature flags (leaf 7)
+        int max_leaf, ext_flags = 0;
+#ifdef _MSC_VER
+        __cpuid(CPUInfo, 0);
+        max_leaf = CPUInfo[0];
+        if (max_leaf >= 7) {
+            __cpuidex(CPUInfo, 7, 0);
+            ext_flags = CPUInfo[1];
+        }
+#else
+        int unused_b, unused_c, unused_d;
+        __asm__ __volatile__("cpuid" : "=a"(max_leaf), "=b"(unused_b), "=c"(unused_c), "=d"(unused_d) : "a"(0));
+        if (max_leaf >= 7) {
+            int unused_a;
+            __asm__ __volatile__("cpuid"
+                                 : "=a"(unused_a), "=b"(ext_flags), "=c"(unused_c), "=d"(unused_d)
+                                 : "a"(7), "c"(0));
+        }
+#endif
+        avx2Supported = avxSupported && (ext_flags & (1 << 5));
+        // AVX-512 Foundation and Byte/Word instructions, with the OS saving the opmask and ZMM registers
+        avx512Supported = avx2Supported && (ext_flags & (1 << 16)) && (ext_flags & (1 << 30)) &&
+                          (xcrFeatureMask & 0xe6) == 0xe6;
     }
 #endif
 
-    if (avxSupported) {
+    if (avx512Supported) {
+        avx_support = 2; // AVX-512 (F and BW) supported
+    }
+    else if (avx2Supported) {
+        avx_support = 1; // AVX2 supported
+    }
+    else if (avxSupported) {
         avx_support = 0; // AVX1 supported
     }
     else {
         avx_support = -1; // No AVX supported
     }
 
-    // 1 is reserved for AVX2
-
 #endif
 }
 } // namespace realm
@@ -2553,26 +2553,34 @@ void run_benchmark_once(Benchmark& benchmark, DBRef sg, Timer& timer)
 /// This little piece of likely over-engineering runs the benchmark a number of times,
 /// with each durability setting, and reports the results for each run.
 template <typename B>
-void run_benchmark(BenchmarkResults& results, bool force_full = false)
+void run_benchmark(BenchmarkResults& results, bool force_full = false, bool with_huge_pages = false)
 {
-    typedef std::pair<DBOptions::Durability, const char*> config_pair;
-    std::vector<config_pair> configs;
+    struct Config {
+        DBOptions::Durability level;
+        const char* key;
+        DBOptions::HugePages huge_pages;
+    };
+    std::vector<Config> configs;
 
     if (force_full) {
-        configs.push_back(config_pair(DBOptions::Durability::Full, nullptr));
+        configs.push_back({DBOptions::Durability::Full, nullptr, DBOptions::HugePages::Off});
 #if REALM_ENABLE_ENCRYPTION
-        configs.push_back(config_pair(DBOptions::Durability::Full, crypt_key(true)));
+        configs.push_back({DBOptions::Durability::Full, crypt_key(true), DBOptions::HugePages::Off});
 #endif
     }
     else {
-        configs.push_back(config_pair(DBOptions::Durability::MemOnly, nullptr));
+        configs.push_back({DBOptions::Durability::MemOnly, nullptr, DBOptions::HugePages::Off});
+    }
+    if (with_huge_pages) {
+        configs.push_back({configs.front().level, nullptr, DBOptions::HugePages::Transparent});
     }
 
     Timer timer(Timer::type_UserTime);
 
     for (auto it = configs.begin(); it != configs.end(); ++it) {
-        DBOptions::Durability level = it->first;
-        const char* key = it->second;
+        DBOptions::Durability level = it->level;
+        const char* key = it->key;
+        bool huge_pages = it->huge_pages != DBOptions::HugePages::Off;
 
         B benchmark;
         if (should_filter_benchmark(benchmark.name()))
@@ -2585,9 +2593,10 @@ void run_benchmark(BenchmarkResults& results, bool force_full = false)
         std::stringstream lead_text_ss;
         std::stringstream ident_ss;
         lead_text_ss << benchmark.name() << " (" << to_lead_cstr(level) << ", "
-                     << (key == nullptr ? "EncryptionOff" : "EncryptionOn") << ")";
+                     << (key == nullptr ? "EncryptionOff" : "EncryptionOn") << (huge_pages ? ", HugePages" : "")
+                     << ")";
         ident_ss << benchmark.name() << "_" << to_ident_cstr(level)
-                 << (key == nullptr ? "_EncryptionOff" : "_EncryptionOn");
+                 << (key == nullptr ? "_EncryptionOff" : "_EncryptionOn") << (huge_pages ? "_HugePages" : "");
         std::string ident = ident_ss.str();
 
         realm::test_util::unit_test::TestDetails test_details;
@@ -2599,8 +2608,10 @@ void run_benchmark(BenchmarkResults& results, bool force_full = false)
         // Open a SharedGroup:
         realm::test_util::DBTestPathGuard realm_path(
             test_util::get_test_path("benchmark_common_tasks_" + ident, ".realm"));
+        DBOptions options(level, key);
+        options.huge_pages = it->huge_pages;
         DBRef group;
-        group = DB::create(realm_path, DBOptions(level, key));
+        group = DB::create(realm_path, options);
         benchmark.before_all(group);
 
         // Warm-up and initial measuring:
@@ -2650,6 +2661,7 @@ int benchmark_common_tasks_main()
 
 #define BENCH(...) run_benchmark<__VA_ARGS__>(results)
 #define BENCH2(B, mode) run_benchmark<B>(results, mode)
+#define BENCH_HUGE_PAGES(B) run_benchmark<B>(results, false, true)
     BENCH2(BenchmarkEmptyCommit, true);
     BENCH2(BenchmarkEmptyCommit, false);
     BENCH2(BenchmarkNonInitiatorOpen, true);
@@ -2771,8 +2783,8 @@ int benchmark_common_tasks_main()
     BENCH(BenchmarkQueryTimestampEqualNull);
     BENCH(BenchmarkQueryIntListSize);
 
-    BENCH(BenchmarkWithIntUIDsRandomOrderSeqAccess);
-    BENCH(BenchmarkWithIntUIDsRandomOrderRandomAccess);
+    BENCH_HUGE_PAGES(BenchmarkWithIntUIDsRandomOrderSeqAccess);
+    BENCH_HUGE_PAGES(BenchmarkWithIntUIDsRandomOrderRandomAccess);
     BENCH(BenchmarkWithIntUIDsRandomOrderRandomDelete);
     BENCH(BenchmarkWithIntUIDsRandomOrderRandomCreate);
 
@@ -2792,6 +2804,7 @@ int benchmark_common_tasks_main()
 
 #undef BENCH
 #undef BENCH2
+#undef BENCH_HUGE_PAGES
     return 0;
 }
 
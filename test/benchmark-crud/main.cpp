@@ -227,6 +227,42 @@ int benchmark_crud_main()
         results.finish(id, desc, "runtime_secs");
     }
 
+    // Create and destroy many small arrays within one write, as when a large
+    // transaction builds cluster leaves and copies them on write
+    {
+        Allocator& alloc = _impl::GroupFriend::get_alloc(*group);
+        std::vector<ref_type> refs(target_size);
+
+        id = "alloc_free_small_arrays";
+        desc = "Alloc/free small arrays";
+        for (int i = 0; i != num_tables; ++i) {
+            timer.reset();
+            for (size_t j = 0; j != target_size; ++j)
+                refs[j] = Array::create_array(Array::type_Normal, false, j % 64, 0, alloc).get_ref();
+            for (ObjKey k : random_order)
+                Array::destroy_deep(refs[k.value], alloc);
+            results.submit(id, timer);
+        }
+        results.finish(id, desc, "runtime_secs");
+
+        id = "alloc_free_interleaved";
+        desc = "Interleaved alloc/free";
+        for (size_t j = 0; j != target_size; ++j)
+            refs[j] = Array::create_array(Array::type_Normal, false, j % 64, 0, alloc).get_ref();
+        for (int i = 0; i != num_tables; ++i) {
+            timer.reset();
+            for (ObjKey k : random_order) {
+                size_t j = size_t(k.value);
+                Array::destroy_deep(refs[j], alloc);
+                refs[j] = Array::create_array(Array::type_Normal, false, (j + i) % 256, 0, alloc).get_ref();
+            }
+            results.submit(id, timer);
+        }
+        results.finish(id, desc, "runtime_secs");
+        for (ref_type ref : refs)
+            Array::destroy_deep(ref, alloc);
+    }
+
     results.submit_single("crud_total_time", "Total time", "runtime_secs", timer_total);
 
     std::cout << "dummy = " << dummy << " (to avoid over-optimization)\n";
@@ -0,0 +1,112 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+// Stress test of the free-space management in the commit path. Runs a long
+// series of small random commits (inserts, updates and deletes of objects
+// with strings of varying length) against a table of bounded size, and
+// reports how the file grows and how long the commits take.
+//
+// Usage: realm-benchmark-freelist [num_commits]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include <realm.hpp>
+#include <realm/disable_sync_to_disk.hpp>
+#include <realm/util/file.hpp>
+
+#include "../util/test_path.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+
+int main(int argc, char* argv[])
+{
+    size_t num_commits = 1000000;
+    if (argc > 1)
+        num_commits = size_t(std::strtoull(argv[1], nullptr, 10));
+    const size_t report_interval = std::max(num_commits / 20, size_t(1));
+    const size_t max_objects = 20000;
+
+    disable_sync_to_disk();
+    TestPathGuard guard("benchmark-freelist.realm");
+    std::string path(guard);
+    DBRef db = DB::create(make_in_realm_history(), path);
+    ColKey col_int, col_str;
+    {
+        WriteTransaction wt(db);
+        auto t = wt.add_table("table");
+        col_int = t->add_column(type_Int, "int");
+        col_str = t->add_column(type_String, "str");
+        wt.commit();
+    }
+
+    std::mt19937 rng(42);
+    std::string str(2000, 'x');
+    std::chrono::nanoseconds total_commit_time{0};
+    std::chrono::nanoseconds interval_commit_time{0};
+    std::chrono::nanoseconds max_commit_time{0};
+
+    std::cout << "commits     file size    free space   used space   avg commit (us)   max commit (us)" << std::endl;
+    for (size_t n = 1; n <= num_commits; ++n) {
+        auto wt = db->start_write();
+        auto t = wt->get_table("table");
+        size_t num_ops = 1 + rng() % 20;
+        for (size_t i = 0; i < num_ops; ++i) {
+            size_t sz = t->size();
+            unsigned op = rng() % 4;
+            if (sz == 0 || (op == 0 && sz < max_objects)) {
+                t->create_object().set(col_int, int64_t(rng())).set(col_str, StringData(str.data(), rng() % 200));
+            }
+            else if (op == 1 || (op == 0 && sz >= max_objects)) {
+                t->remove_object(t->get_object(rng() % sz).get_key());
+            }
+            else if (op == 2) {
+                // Occasionally store a long string to get larger arrays mixed in
+                t->get_object(rng() % sz).set(col_str, StringData(str.data(), rng() % str.size()));
+            }
+            else {
+                t->get_object(rng() % sz).set(col_int, int64_t(rng()));
+            }
+        }
+        auto start = std::chrono::steady_clock::now();
+        wt->commit();
+        auto time = std::chrono::steady_clock::now() - start;
+        total_commit_time += time;
+        interval_commit_time += time;
+        max_commit_time = std::max(max_commit_time, std::chrono::duration_cast<std::chrono::nanoseconds>(time));
+
+        if (n % report_interval == 0 || n == num_commits) {
+            size_t free_space, used_space;
+            db->get_stats(free_space, used_space);
+            auto file_size = util::File::get_size_static(path);
+            size_t commits_in_interval = n % report_interval ? n % report_interval : report_interval;
+            std::cout << std::setw(7) << n << std::setw(14) << file_size << std::setw(14) << free_space
+                      << std::setw(13) << used_space << std::setw(18)
+                      << interval_commit_time.count() / commits_in_interval / 1000 << std::setw(18)
+                      << max_commit_time.count() / 1000 << std::endl;
+            interval_commit_time = std::chrono::nanoseconds{0};
+            max_commit_time = std::chrono::nanoseconds{0};
+        }
+    }
+    std::cout << "Average commit time: " << total_commit_time.count() / num_commits / 1000 << " us" << std::endl;
+}
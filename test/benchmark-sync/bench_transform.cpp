@@ -261,6 +261,148 @@ void connected_objects(TestContext& test_context)
     results->finish(ident, ident, "runtime_secs");
 }
 
+// Two peers have many transactions each, which update objects picked from a
+// shared set of primary keys, so that every local changeset overlaps with
+// many incoming ones. The objects fall in many small conflict groups, which
+// are merged independently of each other.
+template <size_t num_transactions, size_t num_objects>
+void transform_many_to_many(TestContext& test_context)
+{
+    std::string ident = test_context.test_details.test_name;
+
+    for (size_t i = 0; i < 3; ++i) {
+        TEST_CLIENT_DB(db_1);
+        TEST_CLIENT_DB(db_2);
+
+        auto make_transactions = [](DBRef& db, int64_t seed) {
+            ColKey col_ndx;
+            {
+                WriteTransaction wt(db);
+                TableRef t = wt.get_group().add_table_with_primary_key("class_t", type_Int, "pk");
+                col_ndx = t->add_column(type_Int, "i");
+                wt.commit();
+            }
+
+            for (size_t j = 0; j < num_transactions; ++j) {
+                WriteTransaction wt(db);
+                TableRef t = wt.get_table("class_t");
+                for (size_t k = 0; k < 10; ++k) {
+                    int64_t pk = int64_t((j * 7919 + k * 104729 + size_t(seed)) % num_objects);
+                    t->create_object_with_primary_key(pk).set(col_ndx, int64_t(j));
+                }
+                // Let 10% of commits erase an object
+                if (j % 10 == 0) {
+                    if (auto obj = t->get_object_with_primary_key(int64_t(j % num_objects)))
+                        obj.remove();
+                }
+                wt.commit();
+            }
+        };
+
+        make_transactions(db_1, 1);
+        make_transactions(db_2, 2);
+
+        TEST_DIR(dir);
+
+        MultiClientServerFixture::Config config;
+        config.server_public_key_path = "";
+        MultiClientServerFixture fixture(2, 1, dir, test_context, config);
+        Timer t{Timer::type_RealTime};
+
+        Session::Config session_config;
+        session_config.on_sync_client_event_hook = [&](const SyncClientHookData& data) {
+            CHECK(data.batch_state == sync::DownloadBatchState::SteadyState);
+            if (data.num_changesets == 0) {
+                return SyncClientHookAction::NoAction;
+            }
+
+            switch (data.event) {
+                case realm::SyncClientHookEvent::DownloadMessageReceived:
+                    t.reset();
+                    break;
+                case realm::SyncClientHookEvent::DownloadMessageIntegrated:
+                    results->submit(ident.c_str(), t.get_elapsed_time());
+                    break;
+                default:
+                    break;
+            }
+
+            return SyncClientHookAction::NoAction;
+        };
+        Session session_1 = fixture.make_session(0, 0, db_1, "/test", std::move(session_config));
+        Session session_2 = fixture.make_session(1, 0, db_2, "/test");
+
+        // Start server and upload changes of second client.
+        fixture.start_server(0);
+        fixture.start_client(1);
+        session_2.wait_for_upload_complete_or_client_stopped();
+        session_2.wait_for_download_complete_or_client_stopped();
+        session_2.detach();
+        fixture.stop_client(1);
+
+        // Upload changes of first client and wait to integrate changes from second client.
+        fixture.start_client(0);
+        session_1.wait_for_upload_complete_or_client_stopped();
+        session_1.wait_for_download_complete_or_client_stopped();
+    }
+
+    results->finish(ident, ident, "runtime_secs");
+}
+
+// One client uploads 1000 transactions to each of 8 Realm files at once. The
+// time until the server has integrated all of them shows how the integration
+// scales with the number of server workers.
+template <unsigned num_workers>
+void upload_to_many_files(TestContext& test_context)
+{
+    std::string ident = test_context.test_details.test_name;
+    constexpr size_t num_files = 8;
+    constexpr size_t num_transactions = 1000;
+
+    for (size_t i = 0; i < 3; ++i) {
+        TEST_DIR(client_dir);
+        std::vector<DBRef> dbs;
+        for (size_t j = 0; j < num_files; ++j) {
+            std::string path = util::File::resolve(util::format("db_%1.realm", j), client_dir);
+            DBRef db = DB::create(make_client_replication(), path);
+            {
+                WriteTransaction wt(db);
+                TableRef t = wt.get_group().add_table_with_primary_key("class_t", type_Int, "pk");
+                t->add_column(type_String, "s");
+                wt.commit();
+            }
+            for (size_t k = 0; k < num_transactions; ++k) {
+                WriteTransaction wt(db);
+                TableRef t = wt.get_table("class_t");
+                ColKey col = t->get_column_key("s");
+                t->create_object_with_primary_key(int64_t(k)).set(col, std::string(100, char('a' + k % 26)));
+                wt.commit();
+            }
+            dbs.push_back(std::move(db));
+        }
+
+        TEST_DIR(dir);
+
+        // The server assigns files to workers round-robin as it opens them,
+        // so every worker serves num_files / num_workers files.
+        MultiClientServerFixture::Config config;
+        config.server_public_key_path = "";
+        config.server_num_workers = num_workers;
+        MultiClientServerFixture fixture(1, 1, dir, test_context, config);
+        std::vector<Session> sessions;
+        for (size_t j = 0; j < num_files; ++j)
+            sessions.push_back(fixture.make_session(0, 0, dbs[j], util::format("/test_%1", j)));
+
+        fixture.start();
+        Timer t{Timer::type_RealTime};
+        for (auto& session : sessions)
+            session.wait_for_upload_complete_or_client_stopped();
+        results->submit(ident.c_str(), t.get_elapsed_time());
+    }
+
+    results->finish(ident, ident, "runtime_secs");
+}
+
 } // namespace bench
 
 const int max_lead_text_width = 40;
@@ -330,6 +472,36 @@ TEST(BenchMergeManyConnectedObjects)
     bench::connected_objects<1000>(test_context);
 }
 
+TEST(BenchMerge1000x1000TransactionsManyToMany)
+{
+    bench::transform_many_to_many<1000, 2000>(test_context);
+}
+
+TEST(BenchMerge4000x4000TransactionsManyToMany)
+{
+    bench::transform_many_to_many<4000, 2000>(test_context);
+}
+
+TEST(BenchUpload8Files1Worker)
+{
+    bench::upload_to_many_files<1>(test_context);
+}
+
+TEST(BenchUpload8Files2Workers)
+{
+    bench::upload_to_many_files<2>(test_context);
+}
+
+TEST(BenchUpload8Files4Workers)
+{
+    bench::upload_to_many_files<4>(test_context);
+}
+
+TEST(BenchUpload8Files8Workers)
+{
+    bench::upload_to_many_files<8>(test_context);
+}
+
 #if !REALM_IOS
 int main()
 {
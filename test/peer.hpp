@@ -419,8 +419,8 @@ private:
         m_protocol.make_download_message(sync::get_current_protocol_version(), m_download_message_buffer,
                                          file_ident_type(0), version_type(0), version_type(0), version_type(0), 0,
                                          version_type(0), version_type(0), 0, m_history_entry_count,
-                                         m_history_entries_buffer.data(), m_history_entries_buffer.size(), 0, false,
-                                         logger); // Throws
+                                         m_history_entries_buffer.data(), m_history_entries_buffer.size(), 0,
+                                         sync::BodyCodec::none, logger); // Throws
 
         m_history_entries_buffer.reset();
         m_history_entry_count = 0;
@@ -424,6 +424,7 @@ public:
         milliseconds_type server_connection_reaper_interval = 100000000;
 
         long server_max_open_files = 64;
+        unsigned server_num_workers = 1;
 
         bool enable_server_ssl = false;
 
@@ -438,6 +439,8 @@ public:
         const Clock* history_compaction_clock = nullptr;
 
         size_t max_download_size = 0x1000000; // 16 MB as in Server::Config
+        int server_download_compression_level = 1;
+        std::vector<BodyCodec> server_download_body_codecs = {BodyCodec::zlib};
 
 #if REALM_DISABLE_SYNC_MULTIPLEXING
         bool one_connection_per_session = true;
@@ -516,6 +519,7 @@ public:
                 public_key = PKey::load_public(config.server_public_key_path);
             Server::Config config_2;
             config_2.max_open_files = config.server_max_open_files;
+            config_2.num_workers = config.server_num_workers;
             config_2.logger = m_server_loggers[i];
             config_2.token_expiration_clock = &m_fake_token_expiration_clock;
             config_2.ssl = m_enable_server_ssl;
@@ -524,6 +528,8 @@ public:
             config_2.connection_reaper_timeout = config.server_connection_reaper_timeout;
             config_2.connection_reaper_interval = config.server_connection_reaper_interval;
             config_2.max_download_size = config.max_download_size;
+            config_2.download_compression_level = config.server_download_compression_level;
+            config_2.download_body_codecs = config.server_download_body_codecs;
             config_2.tcp_no_delay = true;
             config_2.authorization_header_name = config.authorization_header_name;
             config_2.encryption_key = config.server_encryption_key;
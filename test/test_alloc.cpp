@@ -312,6 +312,50 @@ TEST(Alloc_Fuzzy)
     }
 }
 
+TEST(Alloc_SizeClasses)
+{
+    // Mix of sizes served from the small block bins and from the large blocks,
+    // freed in random order so that blocks get split and merged again
+    SlabAlloc alloc;
+    alloc.attach_empty();
+    test_util::Random random(test_util::random_int<unsigned long>());
+    std::vector<MemRef> refs;
+
+    auto check_and_free = [&](size_t i) {
+        MemRef r = refs[i];
+        size_t siz = get_capacity(r.get_addr());
+        char expected = static_cast<char>(siz / 8);
+        bool intact = true;
+        for (size_t c = 3; c < siz; c++)
+            intact = intact && r.get_addr()[c] == expected;
+        CHECK(intact);
+        alloc.free_(r.get_ref(), r.get_addr());
+        refs[i] = refs.back();
+        refs.pop_back();
+    };
+
+    for (size_t round = 0; round < 4; ++round) {
+        for (size_t i = 0; i < 2000; ++i) {
+            bool large = random.chance(1, 10);
+            size_t siz = 8 * (large ? random.draw_int<size_t>(128, 1024) : random.draw_int<size_t>(1, 127));
+            MemRef r = alloc.alloc(siz);
+            CHECK_EQUAL(0, r.get_ref() & 0x7);
+            CHECK_EQUAL(static_cast<void*>(r.get_addr()), alloc.translate(r.get_ref()));
+            set_capacity(r.get_addr(), siz);
+            memset(r.get_addr() + 3, static_cast<char>(siz / 8), siz - 3);
+            refs.push_back(r);
+            if (random.chance(1, 3))
+                check_and_free(random.draw_int_mod(refs.size()));
+        }
+        while (refs.size() > 500)
+            check_and_free(random.draw_int_mod(refs.size()));
+    }
+    while (!refs.empty())
+        check_and_free(random.draw_int_mod(refs.size()));
+
+    // SlabAlloc destructor will verify that all is free'd
+}
+
 NONCONCURRENT_TEST_IF(Alloc_MapFailureRecovery, _impl::SimulatedFailure::is_enabled())
 {
     GROUP_TEST_PATH(path);
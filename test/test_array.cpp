@@ -1014,6 +1014,86 @@ TEST(Array_find_sse)
 }
 
 
+namespace {
+
+template <class Cond>
+void check_find_vectorized(TestContext& test_context, const Array& a, int64_t value, size_t start)
+{
+    Cond c;
+    std::vector<ObjKey> expected;
+    for (size_t i = start; i < a.size(); ++i) {
+        if (c(a.get(i), value))
+            expected.push_back(ObjKey(int64_t(i)));
+    }
+
+    std::vector<ObjKey> keys;
+    QueryStateFindAll<std::vector<ObjKey>> find_all(keys);
+    ArrayWithFind(a).find<Cond>(value, start, a.size(), 0, &find_all);
+    CHECK(keys == expected);
+
+    QueryStateCount count;
+    ArrayWithFind(a).find<Cond>(value, start, a.size(), 0, &count);
+    CHECK_EQUAL(count.get_count(), expected.size());
+
+    // A limit must be respected even if it ends in the middle of a block
+    size_t limit = expected.size() / 2 + 1;
+    QueryStateCount limited_count(limit);
+    ArrayWithFind(a).find<Cond>(value, start, a.size(), 0, &limited_count);
+    CHECK_EQUAL(limited_count.get_count(), std::min(limit, expected.size()));
+
+    keys.clear();
+    QueryStateFindAll<std::vector<ObjKey>> limited_find_all(keys, limit);
+    ArrayWithFind(a).find<Cond>(value, start, a.size(), 0, &limited_find_all);
+    CHECK_EQUAL(keys.size(), std::min(limit, expected.size()));
+    CHECK(std::equal(keys.begin(), keys.end(), expected.begin()));
+
+    if (std::is_same_v<Cond, Equal>) {
+        IntegerColumn r(Allocator::get_default());
+        r.create();
+        ArrayWithFind(a).find_all(&r, value, 0, start);
+        CHECK_EQUAL(r.size(), expected.size());
+        for (size_t i = 0; i < r.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(r.get(i), expected[i].value);
+        r.destroy();
+    }
+}
+
+} // anonymous namespace
+
+TEST(Array_FindVectorized)
+{
+    // Exercise every byte-aligned width with enough elements to make use of
+    // the vectorized kernels where the CPU supports them
+    for (int64_t max : {int64_t(100), int64_t(30000), int64_t(2000000000), int64_t(1) << 40}) {
+        Array a(Allocator::get_default());
+        a.create(Array::type_Normal);
+        for (int64_t i = 0; i < 300; ++i)
+            a.add((i * 7919) % 13 == 0 ? -max : max - (i * 7919) % 201);
+        int64_t value = max - 100;
+
+        auto check_all = [&] {
+            for (size_t start : {size_t(0), size_t(3), size_t(70)}) {
+                check_find_vectorized<Equal>(test_context, a, value, start);
+                check_find_vectorized<NotEqual>(test_context, a, value, start);
+                check_find_vectorized<Greater>(test_context, a, value, start);
+                check_find_vectorized<Less>(test_context, a, value, start);
+                check_find_vectorized<Less>(test_context, a, -max + 1, start);
+            }
+        };
+        check_all();
+
+#ifdef REALM_COMPILER_AVX
+        // Also cover the AVX2 kernels on CPUs with AVX-512
+        if (sseavx<512>()) {
+            avx_support = 1;
+            check_all();
+            avx_support = 2;
+        }
+#endif
+        a.destroy();
+    }
+}
+
 TEST(Array_Greater)
 {
     Array a(Allocator::get_default());
@@ -19,6 +19,8 @@
 #include "testsettings.hpp"
 #ifdef TEST_ARRAY_FLOAT
 
+#include <limits>
+
 #include <realm/array_basic.hpp>
 #include <realm/column_integer.hpp>
 
@@ -270,4 +272,46 @@ TEST(ArrayDouble_Insert)
     BasicArray_Insert<ArrayDouble, double>(test_context);
 }
 
+TEST(ArrayDouble_MinMaxSum)
+{
+    ArrayDoubleNull f(Allocator::get_default());
+    f.create();
+    for (int i = 0; i < 103; ++i) {
+        if (i % 5 == 0)
+            f.add(realm::null());
+        else if (i == 17)
+            f.add(std::numeric_limits<double>::quiet_NaN());
+        else
+            f.add(i - 50.5);
+    }
+
+    // Nulls and NaN are left out of all three
+    double expected = 0;
+    size_t expected_count = 0;
+    for (int i = 0; i < 103; ++i) {
+        if (i % 5 != 0 && i != 17) {
+            expected += i - 50.5;
+            ++expected_count;
+        }
+    }
+    size_t count;
+    CHECK_APPROXIMATELY_EQUAL(f.sum(0, 103, count), expected, 1e-12);
+    CHECK_EQUAL(count, expected_count);
+
+    double value;
+    size_t ndx;
+    CHECK(f.minimum(value, 0, 103, &ndx));
+    CHECK_EQUAL(value, -49.5);
+    CHECK_EQUAL(ndx, 1);
+    CHECK(f.maximum(value, 0, 103, &ndx));
+    CHECK_EQUAL(value, 51.5);
+    CHECK_EQUAL(ndx, 102);
+    CHECK(f.maximum(value, 15, 18, &ndx));
+    CHECK_EQUAL(value, -34.5);
+    CHECK_EQUAL(ndx, 16);
+    CHECK(!f.minimum(value, 0, 1));
+
+    f.destroy();
+}
+
 #endif // TEST_ARRAY_FLOAT
@@ -18,6 +18,7 @@
 
 #include "testsettings.hpp"
 
+#include <algorithm>
 #include <limits>
 
 #include <realm/array_integer.hpp>
@@ -25,12 +26,28 @@
 #include <realm/column_integer.hpp>
 #include <realm/array_integer_tpl.hpp>
 #include <realm/query_conditions.hpp>
+#include <realm/impl/array_writer.hpp>
 
 #include "test.hpp"
 
 using namespace realm;
 using namespace realm::test_util;
 
+namespace {
+
+// Writes every array to a separate block in the default allocator
+class DefaultAllocArrayWriter : public _impl::ArrayWriterBase {
+public:
+    ref_type write_array(const char* data, size_t size, uint32_t) override
+    {
+        MemRef mem = Allocator::get_default().alloc(size);
+        std::copy_n(data, size, mem.get_addr());
+        return mem.get_ref();
+    }
+};
+
+} // unnamed namespace
+
 
 TEST(ArrayIntNull_SetNull)
 {
@@ -222,6 +239,206 @@ TEST(ArrayIntNull_Find)
     a.destroy();
 }
 
+TEST(ArrayInteger_OffsetEncoded)
+{
+    const int64_t base = 1700000000000;
+    ArrayInteger a(Allocator::get_default());
+    a.create();
+    for (int64_t i = 0; i < 1000; ++i)
+        a.add(base + (i * 7) % 1000);
+
+    DefaultAllocArrayWriter out;
+    ArrayInteger b(Allocator::get_default());
+    b.init_from_ref(a.write_offset_encoded(out, false));
+    CHECK(b.is_offset_encoded());
+    CHECK_LESS(b.get_byte_size(), a.get_byte_size());
+    CHECK_EQUAL(b.size(), a.size());
+    CHECK_EQUAL(b.get_lower_bound(), base);
+    CHECK_EQUAL(b.get_upper_bound(), base + 999);
+
+    bool all_equal = true;
+    for (size_t i = 0; i < a.size(); ++i)
+        all_equal = all_equal && a.get(i) == b.get(i);
+    CHECK(all_equal);
+    CHECK_EQUAL(Array::get(b.get_header(), 17), a.get(17));
+    CHECK_EQUAL(Array::get_two(b.get_header(), 17).second, a.get(18));
+    CHECK_EQUAL(b.get_sum(), a.get_sum());
+    CHECK_EQUAL(b.get_sum(10, 20), a.get_sum(10, 20));
+
+    int64_t res_a[8], res_b[8];
+    a.get_chunk(995, res_a);
+    b.get_chunk(995, res_b);
+    CHECK(std::equal(res_a, res_a + 8, res_b));
+
+    CHECK_EQUAL(b.find_first(base + 14), a.find_first(base + 14));
+    CHECK_EQUAL(b.find_first(base - 1), not_found);
+    CHECK_EQUAL(b.find_first(base + 1000), not_found);
+    CHECK_EQUAL(b.find_first(std::numeric_limits<int64_t>::min()), not_found);
+    CHECK_EQUAL(b.find_first<Greater>(base + 990), a.find_first<Greater>(base + 990));
+    CHECK_EQUAL(b.find_first<Less>(base + 3), a.find_first<Less>(base + 3));
+    CHECK_EQUAL(b.find_first<NotEqual>(base), a.find_first<NotEqual>(base));
+    CHECK_EQUAL(b.find_first<Greater>(std::numeric_limits<int64_t>::min()), 0);
+    CHECK_EQUAL(b.find_first_in_range(base + 500, base + 501, 0, b.size()),
+                a.find_first_in_range(base + 500, base + 501, 0, a.size()));
+
+    std::vector<ObjKey> keys_a, keys_b;
+    QueryStateFindAll<std::vector<ObjKey>> find_all_a(keys_a), find_all_b(keys_b);
+    a.find<Greater>(base + 900, 0, a.size(), &find_all_a);
+    b.find<Greater>(base + 900, 0, b.size(), &find_all_b);
+    CHECK(!keys_b.empty());
+    CHECK(keys_b == keys_a);
+
+    QueryStateCount count_b(5);
+    b.find<NotEqual>(base, 0, b.size(), &count_b);
+    CHECK_EQUAL(count_b.get_count(), 5);
+
+    // The bounds of the leaf decide these without looking at the values
+    QueryStateCount count_all, count_none;
+    b.find<Greater>(base - 1, 3, b.size(), &count_all);
+    CHECK_EQUAL(count_all.get_count(), b.size() - 3);
+    b.find<Greater>(base + 999, 0, b.size(), &count_none);
+    CHECK_EQUAL(count_none.get_count(), 0);
+
+    // Modifying the leaf expands it back into the regular representation
+    b.set(3, -5);
+    CHECK(!b.is_offset_encoded());
+    CHECK_EQUAL(b.get(3), -5);
+    CHECK_EQUAL(b.get(4), a.get(4));
+    CHECK_EQUAL(b.get(999), a.get(999));
+
+    ArrayInteger c(Allocator::get_default());
+    c.init_from_ref(a.write_offset_encoded(out, false));
+    c.insert(0, 42);
+    CHECK(!c.is_offset_encoded());
+    CHECK_EQUAL(c.get(0), 42);
+    CHECK_EQUAL(c.get(1000), a.get(999));
+
+    a.destroy();
+    b.destroy();
+    c.destroy();
+}
+
+TEST(ArrayInteger_OffsetEncodedCount)
+{
+    // 1001 elements leave a tail after the last full 64-bit chunk
+    const int64_t base = 1000000;
+    ArrayInteger a(Allocator::get_default());
+    a.create();
+    for (int64_t i = 0; i < 1001; ++i)
+        a.add(base + i % 200);
+
+    struct TestArray : public ArrayInteger {
+        using ArrayInteger::ArrayInteger;
+        using Array::count;
+    };
+
+    DefaultAllocArrayWriter out;
+    TestArray b(Allocator::get_default());
+    b.init_from_ref(a.write_offset_encoded(out, false));
+    CHECK(b.is_offset_encoded());
+    CHECK_EQUAL(b.count(base), 6);
+    CHECK_EQUAL(b.count(base + 199), 5);
+    CHECK_EQUAL(b.count(base + 200), 0);
+    for (int64_t v : {base + 1, base + 100, base + 198})
+        CHECK_EQUAL(b.count(v), 5);
+
+    a.destroy();
+    b.destroy();
+}
+
+TEST(ArrayInteger_OffsetEncodedNotSmaller)
+{
+    ArrayInteger a(Allocator::get_default());
+    a.create();
+    a.add(std::numeric_limits<int64_t>::min());
+    a.add(std::numeric_limits<int64_t>::max());
+    a.add(0);
+
+    DefaultAllocArrayWriter out;
+    ArrayInteger b(Allocator::get_default());
+    b.init_from_ref(a.write_offset_encoded(out, false));
+    CHECK(!b.is_offset_encoded());
+    CHECK_EQUAL(b.get(0), std::numeric_limits<int64_t>::min());
+    CHECK_EQUAL(b.get(1), std::numeric_limits<int64_t>::max());
+
+    a.destroy();
+    b.destroy();
+}
+
+TEST(ArrayInteger_MinMaxSum)
+{
+    ArrayInteger a(Allocator::get_default());
+    a.create();
+    for (int64_t i = 0; i < 300; ++i)
+        a.add((i * 37) % 101 - 50);
+
+    int64_t value;
+    size_t ndx;
+    CHECK(a.minimum(value, 0, 300, &ndx));
+    CHECK_EQUAL(value, -50);
+    CHECK_EQUAL(ndx, 0);
+    CHECK(a.maximum(value, 10, 200, &ndx));
+    CHECK_EQUAL(value, 50);
+    CHECK_EQUAL(a.get(ndx), 50);
+    CHECK(!a.minimum(value, 5, 5));
+    size_t count;
+    int64_t expected = 0;
+    for (size_t i = 7; i < 250; ++i)
+        expected += a.get(i);
+    CHECK_EQUAL(a.sum(7, 250, count), expected);
+    CHECK_EQUAL(count, 243);
+
+    // The bounds stored in an encoded leaf are used for the whole leaf
+    DefaultAllocArrayWriter out;
+    ArrayInteger b(Allocator::get_default());
+    for (size_t i = 0; i < a.size(); ++i)
+        a.set(i, a.get(i) + 1700000000000);
+    b.init_from_ref(a.write_offset_encoded(out, false));
+    CHECK(b.is_offset_encoded());
+    CHECK(b.maximum(value, 0, b.size(), &ndx));
+    CHECK_EQUAL(value, 1700000000050);
+    CHECK_EQUAL(b.get(ndx), value);
+    CHECK(b.minimum(value, 3, 4));
+    CHECK_EQUAL(value, a.get(3));
+
+    ArrayIntNull c(Allocator::get_default());
+    c.create();
+    for (int64_t i = 0; i < 100; ++i)
+        c.add(i % 3 ? util::some<int64_t>(i) : util::none);
+    CHECK_EQUAL(c.sum(0, 100, count), 3267);
+    CHECK_EQUAL(count, 66);
+    CHECK(c.minimum(value, 0, 100, &ndx));
+    CHECK_EQUAL(value, 1);
+    CHECK_EQUAL(ndx, 1);
+    CHECK(c.maximum(value, 0, 100, &ndx));
+    CHECK_EQUAL(value, 98);
+    CHECK_EQUAL(ndx, 98);
+    CHECK(!c.maximum(value, 3, 4));
+    CHECK(c.maximum(value, 1, 3, &ndx));
+    CHECK_EQUAL(value, 2);
+    CHECK_EQUAL(ndx, 2);
+
+    // In a 64-bit leaf the null marker is close to the largest value, so
+    // nulls must not be summed at all
+    ArrayIntNull d(Allocator::get_default());
+    d.create();
+    d.add(util::none);
+    d.add(int64_t(1) << 40);
+    d.add(util::none);
+    d.add(util::none);
+    d.add(-5);
+    d.add(util::none);
+    CHECK_EQUAL(d.sum(0, 6, count), (int64_t(1) << 40) - 5);
+    CHECK_EQUAL(count, 2);
+    CHECK_EQUAL(d.sum(2, 4, count), 0);
+    CHECK_EQUAL(count, 0);
+
+    a.destroy();
+    b.destroy();
+    c.destroy();
+    d.destroy();
+}
+
 TEST(ArrayRef_Basic)
 {
     ArrayRef a(Allocator::get_default());
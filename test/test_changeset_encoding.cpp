@@ -298,6 +298,44 @@ TEST(ChangesetEncoding_AccentWords)
     CHECK_NOTHROW(parse_changeset(stream, parsed));
 }
 
+TEST(ChangesetParser_InPlace)
+{
+    Changeset changeset;
+    for (int i = 0; i < 100; ++i) {
+        Update instr;
+        instr.table = changeset.intern_string("Foo");
+        instr.object = int64_t(i);
+        instr.field = changeset.intern_string(util::format("field_%1", i % 10));
+        instr.value = Payload{changeset.append_string(util::format("value_%1", i))};
+        changeset.push_back(instr);
+    }
+    CHECK_EQUAL(changeset.interned_strings().size(), 11);
+    CHECK_EQUAL(changeset.find_string("field_3").value, changeset.intern_string("field_3").value);
+
+    sync::ChangesetEncoder::Buffer buffer;
+    encode_changeset(changeset, buffer);
+    Changeset parsed;
+    sync::parse_changeset_in_place(buffer, parsed);
+    CHECK_EQUAL(parsed.string_data().data(), buffer.data());
+    CHECK_EQUAL(parsed.size(), changeset.size());
+    for (uint32_t i = 0; i < 11; ++i)
+        CHECK_EQUAL(parsed.get_string(sync::InternString{i}), changeset.get_string(sync::InternString{i}));
+    auto& instr = parsed.begin()->get_as<Update>();
+    CHECK_EQUAL(parsed.get_string(instr.value.data.str), "value_0");
+
+    // Adding a string copies the strings out of the buffer
+    CHECK_EQUAL(parsed.intern_string("field_7").value, parsed.find_string("field_7").value);
+    CHECK_EQUAL(parsed.string_data().data(), buffer.data());
+    sync::InternString bar = parsed.intern_string("Bar");
+    CHECK_EQUAL(bar.value, 11);
+    CHECK_NOT_EQUAL(parsed.string_data().data(), buffer.data());
+    std::fill(buffer.data(), buffer.data() + buffer.size(), 0);
+    CHECK_EQUAL(parsed.get_string(instr.value.data.str), "value_0");
+    CHECK_EQUAL(parsed.get_string(instr.field), "field_0");
+    CHECK_EQUAL(parsed.find_string("Bar").value, bar.value);
+    CHECK_NOT(parsed.find_string("Baz"));
+}
+
 void encode_instruction(util::AppendBuffer<char>& buffer, char instr)
 {
     buffer.append(&instr, 1);
@@ -204,6 +204,144 @@ TEST_TYPES(Compaction_Large, std::true_type, std::false_type)
     }
 }
 
+TEST(Compaction_Incremental)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options;
+    options.truncate_file_online = true;
+    DBRef db = DB::create(make_in_realm_history(), path, options);
+    std::string big_string(0x10000, 'a');
+    ColKey col_bin, col_int;
+    {
+        auto tr = db->start_write();
+        auto table_foo = tr->add_table("foo");
+        col_bin = table_foo->add_column(type_Binary, "bin", true);
+        for (int i = 0; i < 200; ++i) {
+            table_foo->create_object().set(col_bin, BinaryData(big_string.data(), big_string.size()));
+        }
+        auto table_bar = tr->add_table("bar");
+        col_int = table_bar->add_column(type_Int, "int");
+        for (int i = 0; i < 1000; ++i) {
+            table_bar->create_object(ObjKey(i)).set(col_int, i);
+        }
+        tr->commit();
+    }
+    {
+        // Get 'bar' written after 'foo' in the file
+        auto tr = db->start_write();
+        for (auto o : *tr->get_table("bar")) {
+            o.set(col_int, o.get<Int>(col_int) * 2);
+        }
+        tr->commit();
+    }
+    {
+        auto tr = db->start_write();
+        tr->get_table("foo")->clear();
+        tr->commit();
+    }
+    // Nothing to do yet
+    CHECK(db->get_evacuation_stage() == DB::EvacStage::idle);
+    CHECK_NOT(db->compact_incrementally(0x1000));
+
+    // The space freed is only available once no version refers to it
+    int n = 10;
+    do {
+        db->start_write()->commit();
+    } while (db->get_evacuation_stage() != DB::EvacStage::evacuating && --n > 0);
+    CHECK(db->get_evacuation_stage() == DB::EvacStage::evacuating);
+    auto size_before = File::get_size_static(path);
+
+    // Readers are not blocked, and keep seeing their snapshot
+    auto rt = db->start_read();
+    auto bar = rt->get_table("bar");
+    for (int i = 0; i < 3; ++i) {
+        db->compact_incrementally(0x1000);
+        CHECK_EQUAL(bar->get_object(ObjKey(999)).get<Int>(col_int), 1998);
+    }
+    rt = nullptr;
+
+    n = 100;
+    while (db->compact_incrementally(0x10000) && --n > 0)
+        ;
+    CHECK(db->get_evacuation_stage() == DB::EvacStage::idle);
+    auto progress = db->get_compaction_progress();
+    CHECK_GREATER(progress.bytes_moved, 0);
+    CHECK_GREATER(progress.bytes_truncated, 0);
+#ifndef _WIN32
+    CHECK_LESS(File::get_size_static(path), size_before);
+    CHECK_EQUAL(File::get_size_static(path), progress.logical_file_size);
+#endif
+
+    {
+        // The file can grow again
+        auto tr = db->start_write();
+        auto table_foo = tr->get_table("foo");
+        for (int i = 0; i < 50; ++i) {
+            table_foo->create_object().set(col_bin, BinaryData(big_string.data(), big_string.size()));
+        }
+        tr->commit();
+    }
+    rt = db->start_read();
+    rt->verify();
+    CHECK_EQUAL(rt->get_table("foo")->size(), 50);
+    bar = rt->get_table("bar");
+    CHECK_EQUAL(bar->size(), 1000);
+    CHECK_EQUAL(bar->get_object(ObjKey(999)).get<Int>(col_int), 1998);
+}
+
+TEST(Compaction_IncrementalNotTruncatedWhileShared)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options;
+    options.truncate_file_online = true;
+    DBRef db = DB::create(make_in_realm_history(), path, options);
+    std::string big_string(0x10000, 'a');
+    {
+        auto tr = db->start_write();
+        auto table_foo = tr->add_table("foo");
+        auto col_bin = table_foo->add_column(type_Binary, "bin", true);
+        for (int i = 0; i < 200; ++i) {
+            table_foo->create_object().set(col_bin, BinaryData(big_string.data(), big_string.size()));
+        }
+        auto table_bar = tr->add_table("bar");
+        auto col_int = table_bar->add_column(type_Int, "int");
+        for (int i = 0; i < 1000; ++i) {
+            table_bar->create_object(ObjKey(i)).set(col_int, i);
+        }
+        tr->commit();
+    }
+    {
+        auto tr = db->start_write();
+        tr->get_table("foo")->clear();
+        tr->commit();
+    }
+
+    // Another DB object has the file mapped, as another process would
+    DBRef db_2 = DB::create(make_in_realm_history(), path);
+    auto size_before = File::get_size_static(path);
+    int n = 10;
+    do {
+        db->start_write()->commit();
+    } while (db->get_evacuation_stage() != DB::EvacStage::evacuating && --n > 0);
+    CHECK(db->get_evacuation_stage() == DB::EvacStage::evacuating);
+    n = 100;
+    while (db->compact_incrementally(0x10000) && --n > 0)
+        ;
+    CHECK(db->get_evacuation_stage() == DB::EvacStage::idle);
+    CHECK_GREATER(db->get_compaction_progress().bytes_moved, 0);
+    CHECK_EQUAL(db->get_compaction_progress().bytes_truncated, 0);
+    CHECK_EQUAL(File::get_size_static(path), size_before);
+    CHECK_EQUAL(db_2->start_read()->get_table("bar")->size(), 1000);
+
+    // Once it is the only one left, the next commit truncates the file
+    db_2 = nullptr;
+    db->start_write()->commit();
+#ifndef _WIN32
+    CHECK_GREATER(db->get_compaction_progress().bytes_truncated, 0);
+    CHECK_LESS(File::get_size_static(path), size_before);
+#endif
+}
+
 NONCONCURRENT_TEST(Compaction_Performance)
 {
     auto old_disable_sync_to_disk = get_disable_sync_to_disk();
@@ -366,6 +366,54 @@ TEST(EncryptedFile_MultipleWriterMappings)
     }
 }
 
+TEST(EncryptedFile_ManyPagesAtOnce)
+{
+    // Large enough for the pages to be decrypted and encrypted in parallel
+    const size_t count = 4096 * 64 * 3 + 4096 * 5;
+    TEST_PATH(path);
+
+    {
+        File w(path, File::mode_Write);
+        w.set_encryption_key(test_util::crypt_key(true));
+        w.resize(count);
+        File::Map<char> map(w, File::access_ReadWrite, count);
+        util::encryption_read_barrier(map, 0, count);
+        for (size_t i = 0; i < count; ++i)
+            map.get_addr()[i] = char(i % 251);
+        util::encryption_write_barrier(map, 0, count);
+        map.flush();
+
+        // Rewrite every other page so that the pages written are not contiguous
+        for (size_t i = 0; i < count; i += 4096 * 2) {
+            util::encryption_read_barrier(map, i, 1);
+            map.get_addr()[i] = 1;
+            util::encryption_write_barrier(map, i);
+        }
+    }
+
+    auto check = [&](const char* data) {
+        for (size_t i = 0; i < count; ++i) {
+            char expected = (i % (4096 * 2) == 0) ? 1 : char(i % 251);
+            if (!CHECK_EQUAL(int(data[i]), int(expected)))
+                return;
+        }
+    };
+
+    File reader(path, File::mode_Read);
+    reader.set_encryption_key(test_util::crypt_key(true));
+    {
+        File::Map<char> read(reader, File::access_ReadOnly, count);
+        util::encryption_read_barrier(read, 0, count);
+        check(read.get_addr());
+    }
+    {
+        File::Map<char> read(reader, File::access_ReadOnly, count);
+        util::do_encryption_prefetch(read.get_addr() + 4096, count - 4096, read.get_encrypted_mapping());
+        util::encryption_read_barrier(read, 0, count);
+        check(read.get_addr());
+    }
+}
+
 TEST(EncryptedFile_MultipleWriterFiles)
 {
     const size_t count = 4096 * 64 * 2; // i.e. two metablocks of data
@@ -0,0 +1,300 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_INDEX_SORTED
+
+#include <realm.hpp>
+#include <realm/index_sorted.hpp>
+#include <realm/history.hpp>
+
+#include "test.hpp"
+#include "util/random.hpp"
+
+using namespace realm;
+using namespace realm::test_util;
+
+// Test independence and thread-safety
+// -----------------------------------
+//
+// All tests must be thread safe and independent of each other. This
+// is required because it allows for both shuffling of the execution
+// order and for parallelized testing.
+//
+// In particular, avoid using std::rand() since it is not guaranteed
+// to be thread safe. Instead use the API offered in
+// `test/util/random.hpp`.
+//
+// All files created in tests must use the TEST_PATH macro (or one of
+// its friends) to obtain a suitable file system path. See
+// `test/util/test_path.hpp`.
+//
+//
+// Debugging and the ONLY() macro
+// ------------------------------
+//
+// A simple way of disabling all tests except one called `Foo`, is to
+// replace TEST(Foo) with ONLY(Foo) and then recompile and rerun the
+// test suite. Note that you can also use filtering by setting the
+// environment varible `UNITTEST_FILTER`. See `README.md` for more on
+// this.
+
+namespace {
+
+std::vector<ObjKey> get_keys(const TableView& tv)
+{
+    std::vector<ObjKey> keys;
+    for (size_t i = 0; i < tv.size(); ++i)
+        keys.push_back(tv.get_key(i));
+    return keys;
+}
+
+} // anonymous namespace
+
+TEST(SortedIndex_NotSupported)
+{
+    Table table;
+    auto col_pk = table.add_column(type_Int, "pk");
+    auto col_list = table.add_column_list(type_Int, "list");
+    auto col_float = table.add_column(type_Float, "float");
+    table.set_primary_key_column(col_pk);
+
+    CHECK_THROW(table.add_search_index(col_pk, IndexType::Sorted), InvalidColumnKey);
+    CHECK_THROW(table.add_search_index(col_list, IndexType::Sorted), IllegalOperation);
+    CHECK_THROW(table.add_search_index(col_float, IndexType::Sorted), IllegalOperation);
+    CHECK_EQUAL(table.search_index_type(col_float), IndexType::None);
+}
+
+TEST(SortedIndex_Maintained)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Table table;
+    auto col_int = table.add_column(type_Int, "int", true);
+    auto col_str = table.add_column(type_String, "str", true);
+
+    auto random_value = [&]() -> Mixed {
+        if (random.draw_int_mod(10) == 0)
+            return Mixed();
+        return random.draw_int<int64_t>(-100, 100);
+    };
+    for (int i = 0; i < 1000; ++i) {
+        Mixed value = random_value();
+        std::string str = value.is_null() ? "" : "s" + util::to_string(value.get_int());
+        table.create_object().set_any(col_int, value).set(col_str, value.is_null() ? StringData() : StringData(str));
+    }
+
+    // Built from the existing objects
+    table.add_search_index(col_int, IndexType::Sorted);
+    table.add_search_index(col_str, IndexType::Sorted);
+    CHECK_EQUAL(table.search_index_type(col_int), IndexType::Sorted);
+    CHECK_NOT(table.has_search_index(col_int));
+    CHECK(table.get_sorted_index(col_int));
+    table.verify();
+
+    for (int i = 0; i < 1000; ++i) {
+        switch (random.draw_int_mod(3)) {
+            case 0:
+                table.create_object().set_any(col_int, random_value()).set(col_str, "x");
+                break;
+            case 1:
+                table.get_object(random.draw_int_mod(table.size())).set_any(col_int, random_value());
+                break;
+            case 2:
+                table.get_object(random.draw_int_mod(table.size())).remove();
+                break;
+        }
+    }
+    table.verify();
+
+    const SortedIndex* index = table.get_sorted_index(col_int);
+    CHECK_EQUAL(index->size(), table.size());
+    for (size_t i = 1; i < index->size(); ++i)
+        CHECK_LESS_EQUAL(index->get_value(i - 1).compare(index->get_value(i)), 0);
+    CHECK_EQUAL(table.count_int(col_int, 7), table.where().equal(col_int, 7).count());
+
+    table.remove_search_index(col_int);
+    CHECK_EQUAL(table.search_index_type(col_int), IndexType::None);
+    table.add_search_index(col_int, IndexType::General);
+    table.add_search_index(col_int, IndexType::Sorted);
+    CHECK_EQUAL(table.search_index_type(col_int), IndexType::Sorted);
+    table.clear();
+    table.verify();
+    CHECK_EQUAL(table.get_sorted_index(col_int)->size(), 0);
+}
+
+TEST(SortedIndex_RangeQueries)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Table table;
+    auto col_int = table.add_column(type_Int, "int", true);
+    auto col_int_plain = table.add_column(type_Int, "int_plain", true);
+    auto col_date = table.add_column(type_Timestamp, "date", true);
+    auto col_date_plain = table.add_column(type_Timestamp, "date_plain", true);
+    table.add_search_index(col_int, IndexType::Sorted);
+    table.add_search_index(col_date, IndexType::Sorted);
+
+    for (int i = 0; i < 3000; ++i) {
+        auto obj = table.create_object();
+        if (random.draw_int_mod(10)) {
+            int64_t value = random.draw_int<int64_t>(-1000, 1000);
+            obj.set(col_int, value).set(col_int_plain, value);
+            obj.set(col_date, Timestamp(value, 0)).set(col_date_plain, Timestamp(value, 0));
+        }
+    }
+
+    for (int64_t value : {-2000, -1000, -990, -500, 0, 500, 990, 1000, 2000}) {
+        CHECK_EQUAL(get_keys(table.where().greater(col_int, value).find_all()),
+                    get_keys(table.where().greater(col_int_plain, value).find_all()));
+        CHECK_EQUAL(get_keys(table.where().greater_equal(col_int, value).find_all()),
+                    get_keys(table.where().greater_equal(col_int_plain, value).find_all()));
+        CHECK_EQUAL(get_keys(table.where().less(col_int, value).find_all()),
+                    get_keys(table.where().less(col_int_plain, value).find_all()));
+        CHECK_EQUAL(get_keys(table.where().less_equal(col_int, value).find_all()),
+                    get_keys(table.where().less_equal(col_int_plain, value).find_all()));
+        CHECK_EQUAL(table.where().less(col_int, value).greater(col_int_plain, -600).count(),
+                    table.where().less(col_int_plain, value).greater(col_int_plain, -600).count());
+
+        Timestamp ts(value, 0);
+        CHECK_EQUAL(get_keys(table.where().greater(col_date, ts).find_all()),
+                    get_keys(table.where().greater(col_date_plain, ts).find_all()));
+        CHECK_EQUAL(get_keys(table.where().less_equal(col_date, ts).find_all()),
+                    get_keys(table.where().less_equal(col_date_plain, ts).find_all()));
+    }
+    CHECK_EQUAL(table.where().greater(col_date, Timestamp()).count(), 0);
+
+    // A narrow range is served from the index, a wide one by scanning
+    CHECK(table.where().greater(col_int, 950).explain().find("INDEX") == 0);
+    CHECK(table.where().less(col_date, Timestamp(-950, 0)).explain().find("INDEX") == 0);
+    CHECK(table.where().greater(col_int, 0).explain().find("SCAN") == 0);
+}
+
+TEST(SortedIndex_Sort)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Table table;
+    auto col_int = table.add_column(type_Int, "int", true);
+    auto col_int_plain = table.add_column(type_Int, "int_plain", true);
+    auto col_str = table.add_column(type_String, "str", true);
+    auto col_str_plain = table.add_column(type_String, "str_plain", true);
+    table.add_search_index(col_int, IndexType::Sorted);
+    table.add_search_index(col_str, IndexType::Sorted);
+
+    for (int i = 0; i < 2000; ++i) {
+        auto obj = table.create_object();
+        if (random.draw_int_mod(10)) {
+            int64_t value = random.draw_int<int64_t>(0, 300);
+            std::string str = "str" + util::to_string(value);
+            obj.set(col_int, value).set(col_int_plain, value);
+            obj.set(col_str, StringData(str)).set(col_str_plain, StringData(str));
+        }
+    }
+
+    auto check = [&](ColKey col, ColKey col_plain, bool ascending, size_t limit) {
+        DescriptorOrdering ordering;
+        DescriptorOrdering ordering_plain;
+        ordering.append_sort(SortDescriptor({{col}}, {ascending}));
+        ordering_plain.append_sort(SortDescriptor({{col_plain}}, {ascending}));
+        if (limit != size_t(-1)) {
+            ordering.append_limit(limit);
+            ordering_plain.append_limit(limit);
+        }
+        auto tv = table.where().find_all(ordering);
+        auto tv_plain = table.where().find_all(ordering_plain);
+        CHECK_EQUAL(get_keys(tv), get_keys(tv_plain));
+    };
+    for (bool ascending : {true, false}) {
+        for (size_t limit : {size_t(0), size_t(10), size_t(1500), size_t(-1)}) {
+            check(col_int, col_int_plain, ascending, limit);
+            check(col_str, col_str_plain, ascending, limit);
+        }
+    }
+
+    // Sorted twice, with a distinct in between
+    TableView tv = table.where().less(col_int_plain, 250).find_all();
+    TableView tv_plain = tv;
+    tv.sort(col_int, false);
+    tv.distinct(col_str);
+    tv.sort(col_int);
+    tv_plain.sort(col_int_plain, false);
+    tv_plain.distinct(col_str_plain);
+    tv_plain.sort(col_int_plain);
+    CHECK_EQUAL(get_keys(tv), get_keys(tv_plain));
+}
+
+TEST(SortedIndex_Transactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path, DBOptions(crypt_key()));
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col = table->add_column(type_Int, "int");
+        for (int i = 0; i < 100; ++i)
+            table->create_object().set(col, i);
+        table->add_search_index(col, IndexType::Sorted);
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    CHECK_EQUAL(table->search_index_type(col), IndexType::Sorted);
+    CHECK_EQUAL(table->where().greater_equal(col, 95).count(), 5);
+
+    {
+        auto wt = db->start_write();
+        auto t = wt->get_table("table");
+        for (int i = 100; i < 200; ++i)
+            t->create_object().set(col, i);
+        t->get_object(0).set(col, 1000);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(table->where().greater_equal(col, 195).count(), 6);
+    table->verify();
+
+    // The kind of index changes under the reader
+    {
+        auto wt = db->start_write();
+        wt->get_table("table")->add_search_index(col, IndexType::General);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(table->search_index_type(col), IndexType::General);
+    CHECK_EQUAL(table->where().equal(col, 1000).count(), 1);
+    {
+        auto wt = db->start_write();
+        wt->get_table("table")->add_search_index(col, IndexType::Sorted);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(table->search_index_type(col), IndexType::Sorted);
+    CHECK_EQUAL(table->where().less(col, 3).count(), 2);
+    table->verify();
+
+    // Survives compaction
+    rt = nullptr;
+    table = nullptr;
+    CHECK(db->compact());
+    rt = db->start_read();
+    rt->verify();
+    CHECK_EQUAL(rt->get_table("table")->where().greater(col, 198).count(), 2);
+}
+
+#endif // TEST_INDEX_SORTED
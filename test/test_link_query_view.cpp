@@ -1728,4 +1728,106 @@ TEST(BackLink_Query_MultipleLevelsAndTables)
     CHECK_TABLE_VIEW(q.find_all(), {saved1});
 }
 
+
+TEST(LinkList_QueryConditionOnTargets)
+{
+    Group group;
+    TableRef owners = group.add_table("owners");
+    TableRef dogs = group.add_table("dogs");
+    auto col_name = owners->add_column(type_String, "name", true);
+    auto col_age = owners->add_column(type_Int, "age");
+    auto col_friend = owners->add_column(*owners, "friend");
+    auto col_owner = dogs->add_column(*owners, "owner");
+    auto col_owners = dogs->add_column_list(*owners, "owners");
+
+    std::vector<ObjKey> owner_keys;
+    for (int i = 0; i < 40; ++i) {
+        auto obj = owners->create_object().set(col_age, i);
+        if (i % 7)
+            obj.set(col_name, StringData("o" + util::to_string(i % 10)));
+        owner_keys.push_back(obj.get_key());
+    }
+    for (int i = 0; i < 40; ++i)
+        owners->get_object(owner_keys[i]).set(col_friend, owner_keys[(i * 3) % 40]);
+    for (int i = 0; i < 400; ++i) {
+        auto obj = dogs->create_object();
+        if (i % 9)
+            obj.set(col_owner, owner_keys[(i * 7) % 40]);
+        auto list = obj.get_linklist(col_owners);
+        for (int j = 0; j < i % 4; ++j)
+            list.add(owner_keys[(i + j * 13) % 40]);
+    }
+
+    // Checks the query against the condition evaluated on each object
+    auto check = [&](Query q, util::FunctionRef<bool(Obj)> matches) {
+        std::vector<ObjKey> expected;
+        for (auto obj : *dogs) {
+            if (matches(obj))
+                expected.push_back(obj.get_key());
+        }
+        TableView tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected[i]);
+        CHECK_EQUAL(q.count(), expected.size());
+    };
+    auto any_owner = [&](Obj obj, util::FunctionRef<bool(Obj)> cond) {
+        auto list = obj.get_linklist(col_owners);
+        for (size_t i = 0; i < list.size(); ++i) {
+            if (cond(list.get_object(i)))
+                return true;
+        }
+        return false;
+    };
+
+    // Few matches, found through the backlinks
+    check(dogs->link(col_owner).column<String>(col_name) == "o3", [&](Obj obj) {
+        auto owner = obj.get_linked_object(col_owner);
+        return owner && owner.get<String>(col_name) == "o3";
+    });
+    check(dogs->link(col_owners).column<Int>(col_age) < 2, [&](Obj obj) {
+        return any_owner(obj, [&](Obj owner) {
+            return owner.get<Int>(col_age) < 2;
+        });
+    });
+    // Many matches, looked up among the links of each object
+    check(dogs->link(col_owner).column<Int>(col_age) > 5, [&](Obj obj) {
+        auto owner = obj.get_linked_object(col_owner);
+        return owner && owner.get<Int>(col_age) > 5;
+    });
+    check(dogs->link(col_owners).column<String>(col_name).equal("O1", false), [&](Obj obj) {
+        return any_owner(obj, [&](Obj owner) {
+            return owner.get<String>(col_name) == "o1";
+        });
+    });
+    check(dogs->link(col_owner).link(col_friend).column<Int>(col_age) >= 10, [&](Obj obj) {
+        auto owner = obj.get_linked_object(col_owner);
+        return owner && owner.get_linked_object(col_friend).get<Int>(col_age) >= 10;
+    });
+    check(20 > dogs->link(col_owner).column<Int>(col_age), [&](Obj obj) {
+        auto owner = obj.get_linked_object(col_owner);
+        return owner && owner.get<Int>(col_age) < 20;
+    });
+    // Null links give a null value, so these look at every object
+    check(dogs->link(col_owner).column<String>(col_name) == realm::null(), [&](Obj obj) {
+        auto owner = obj.get_linked_object(col_owner);
+        return !owner || owner.is_null(col_name);
+    });
+    check(dogs->link(col_owner).column<String>(col_name) != "o3", [&](Obj obj) {
+        auto owner = obj.get_linked_object(col_owner);
+        return !owner || owner.get<String>(col_name) != "o3";
+    });
+
+    // Restricted to a view
+    TableView view = dogs->where().find_all(100);
+    Query q = dogs->where(&view).and_query(dogs->link(col_owner).column<Int>(col_age) > 30);
+    size_t count = 0;
+    for (size_t i = 0; i < view.size(); ++i) {
+        auto owner = view.get_object(i).get_linked_object(col_owner);
+        if (owner && owner.get<Int>(col_age) > 30)
+            ++count;
+    }
+    CHECK_EQUAL(q.count(), count);
+}
+
 #endif
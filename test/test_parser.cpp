@@ -4464,6 +4464,123 @@ TEST(Parser_TimestampNullable)
 }
 
 
+TEST(Parser_ColumnComparisons)
+{
+    Group g;
+    TableRef table = g.add_table("table");
+    ColKey int_a = table->add_column(type_Int, "int_a", true);
+    ColKey int_b = table->add_column(type_Int, "int_b", true);
+    ColKey int_c = table->add_column(type_Int, "int_c");
+    ColKey bool_a = table->add_column(type_Bool, "bool_a", true);
+    ColKey bool_b = table->add_column(type_Bool, "bool_b", true);
+    ColKey date_a = table->add_column(type_Timestamp, "date_a", true);
+    ColKey date_b = table->add_column(type_Timestamp, "date_b", true);
+
+    for (int i = 0; i < 300; ++i) {
+        auto obj = table->create_object().set(int_c, i % 7);
+        if (i % 5)
+            obj.set(int_a, i % 11).set(bool_a, i % 3 == 0).set(date_a, Timestamp(i % 11, 0));
+        if (i % 7)
+            obj.set(int_b, i % 13).set(bool_b, i % 2 == 0).set(date_b, Timestamp(i % 13, 0));
+    }
+
+    // Compared by a typed node, with the same result as the expression
+    verify_query(test_context, table, "int_a > int_b",
+                 (table->column<Int>(int_a) > table->column<Int>(int_b)).count());
+    verify_query(test_context, table, "int_a == int_b",
+                 (table->column<Int>(int_a) == table->column<Int>(int_b)).count());
+    verify_query(test_context, table, "int_a != int_b",
+                 (table->column<Int>(int_a) != table->column<Int>(int_b)).count());
+    verify_query(test_context, table, "int_c <= int_a",
+                 (table->column<Int>(int_c) <= table->column<Int>(int_a)).count());
+    verify_query(test_context, table, "int_b >= int_c",
+                 (table->column<Int>(int_b) >= table->column<Int>(int_c)).count());
+    verify_query(test_context, table, "bool_a == bool_b",
+                 (table->column<Bool>(bool_a) == table->column<Bool>(bool_b)).count());
+    verify_query(test_context, table, "bool_a != bool_b",
+                 (table->column<Bool>(bool_a) != table->column<Bool>(bool_b)).count());
+    verify_query(test_context, table, "date_a < date_b",
+                 (table->column<Timestamp>(date_a) < table->column<Timestamp>(date_b)).count());
+    verify_query(test_context, table, "date_a == date_b",
+                 (table->column<Timestamp>(date_a) == table->column<Timestamp>(date_b)).count());
+    verify_query(test_context, table, "int_a > int_b && int_c == 3",
+                 (table->column<Int>(int_a) > table->column<Int>(int_b)).equal(int_c, 3).count());
+
+    // The constant on the left is the same condition turned around
+    verify_query(test_context, table, "5 < int_a", table->where().greater(int_a, 5).count());
+    verify_query(test_context, table, "5 >= int_c", table->where().less_equal(int_c, 5).count());
+    verify_query(test_context, table, "3 == int_b", table->where().equal(int_b, 3).count());
+    verify_query(test_context, table, "T5:0 > date_a", table->where().less(date_a, Timestamp(5, 0)).count());
+    verify_query(test_context, table, "NULL == int_a", table->where().equal(int_a, null()).count());
+}
+
+TEST(Parser_PreparedQuery)
+{
+    Group g;
+    TableRef target = g.add_table("class_Target");
+    TableRef table = g.add_table("class_Table");
+    ColKey col_value = target->add_column(type_Int, "value");
+    ColKey col_int = table->add_column(type_Int, "int");
+    ColKey col_str = table->add_column(type_String, "str");
+    ColKey col_list = table->add_column_list(type_Int, "list");
+    ColKey col_links = table->add_column_list(*target, "links");
+
+    for (int i = 0; i < 10; ++i)
+        target->create_object().set(col_value, i);
+    for (int i = 0; i < 100; ++i) {
+        auto obj = table->create_object().set(col_int, i % 10).set(col_str, util::to_string(i % 3));
+        auto list = obj.get_list<Int>(col_list);
+        for (int j = 0; j < i % 4; ++j)
+            list.add(j);
+        auto links = obj.get_linklist(col_links);
+        for (int j = 0; j < i % 5; ++j)
+            links.add(target->get_object(j).get_key());
+    }
+
+    // Run again from the cache with other arguments
+    for (int64_t value : {0, 3, 7, 3, 0}) {
+        std::vector<Mixed> args{value, StringData("1")};
+        CHECK_EQUAL(table->query("int > $0 && str == $1", args).count(),
+                    table->where().greater(col_int, value).equal(col_str, "1").count());
+        CHECK_EQUAL(table->query("list.@size == $0 || links.@sum.value > $0", args).count(),
+                    (table->column<Lst<Int>>(col_list).size() == value ||
+                     table->column<Link>(col_links).column<Int>(col_value).sum() > value)
+                        .count());
+        size_t expected = 0;
+        for (auto& obj : *table) {
+            size_t matches = 0;
+            auto links = obj.get_linklist(col_links);
+            for (size_t i = 0; i < links.size(); ++i)
+                matches += links.get_object(i).get<Int>(col_value) >= value;
+            expected += matches > 1;
+        }
+        CHECK_EQUAL(table->query("SUBQUERY(links, $x, $x.value >= $0).@count > 1", args).count(), expected);
+        CHECK_EQUAL(target->query("@links.Table.links.@count > $0", args).count(),
+                    target->query("@links.@count > " + util::to_string(value)).count());
+    }
+
+    // Arguments which are part of the path
+    CHECK_EQUAL(table->query("$K0 == 3", std::vector<Mixed>{Mixed("int")}).count(), 10);
+    CHECK_EQUAL(table->query("$K0 == 3", std::vector<Mixed>{Mixed("links.value")}).count(), 20);
+    CHECK_EQUAL(table->query("list[$0] == 2", std::vector<Mixed>{Mixed(2)}).count(), 25);
+    CHECK_EQUAL(table->query("list[$0] == 1", std::vector<Mixed>{Mixed(1)}).count(), 50);
+
+    // A prepared query is run on tables with other columns of the same name
+    query_parser::PreparedQuery prepared("int BETWEEN {$0, $1} SORT(int DESC) LIMIT(5)");
+    auto tv = table->query(prepared, {Mixed(2), Mixed(4)}).find_all();
+    CHECK_EQUAL(tv.size(), 5);
+    CHECK_EQUAL(tv.get_object(0).get<Int>(col_int), 4);
+    Table other;
+    ColKey col_other = other.add_column(type_Double, "int");
+    for (int i = 0; i < 10; ++i)
+        other.create_object().set(col_other, i / 2.0);
+    CHECK_EQUAL(other.query(prepared, {Mixed(1), Mixed(2.5)}).count(), 4);
+    CHECK_THROW_ANY(target->query(prepared, {Mixed(1), Mixed(2)}));
+    CHECK_THROW_ANY(query_parser::PreparedQuery("list[$0] == 1"));
+    CHECK_THROW_ANY(query_parser::PreparedQuery("int >"));
+}
+
+
 TEST(Parser_ObjectId)
 {
     using util::serializer::print_value;
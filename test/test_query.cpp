@@ -31,6 +31,7 @@ using namespace std::chrono;
 #include <realm/array_bool.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/index_string.hpp>
+#include <realm/query_cache.hpp>
 #include <realm/query_expression.hpp>
 #include "test.hpp"
 #include "test_table_helper.hpp"
@@ -3689,6 +3690,138 @@ TEST(Query_AggregateSingleCond)
     CHECK_EQUAL(9, s);
 }
 
+TEST(Query_AggregateWholeLeaves)
+{
+    // Enough objects to span several clusters, with conditions that match
+    // everything, runs of objects and scattered objects
+    Table t;
+    auto col_int = t.add_column(type_Int, "int");
+    auto col_int_null = t.add_column(type_Int, "int_null", true);
+    auto col_double = t.add_column(type_Double, "double", true);
+    auto col_float = t.add_column(type_Float, "float");
+    constexpr int64_t num_objects = 3000;
+    for (int64_t i = 0; i < num_objects; ++i) {
+        auto obj = t.create_object();
+        obj.set(col_int, (i * 7919) % 1000 - 400);
+        if (i % 7)
+            obj.set(col_int_null, i - 1000);
+        if (i % 11)
+            obj.set(col_double, i == 2345 ? std::numeric_limits<double>::quiet_NaN() : i * 0.5);
+        obj.set(col_float, i == 1234 ? std::numeric_limits<float>::quiet_NaN() : float(i % 100));
+    }
+
+    auto check = [&](Query q, util::FunctionRef<bool(int64_t)> matches) {
+        int64_t sum_int = 0, sum_null = 0;
+        double sum_double = 0, sum_float = 0;
+        size_t count_null = 0, count_double = 0, count_float = 0;
+        std::optional<int64_t> min_int, max_null;
+        std::optional<double> min_double;
+        float max_float = 0;
+        for (int64_t i = 0; i < num_objects; ++i) {
+            if (!matches(i))
+                continue;
+            int64_t v = (i * 7919) % 1000 - 400;
+            sum_int += v;
+            min_int = min_int ? std::min(*min_int, v) : v;
+            if (i % 7) {
+                sum_null += i - 1000;
+                ++count_null;
+                max_null = max_null ? std::max(*max_null, i - 1000) : i - 1000;
+            }
+            if (i % 11 && i != 2345) {
+                sum_double += i * 0.5;
+                ++count_double;
+                min_double = min_double ? std::min(*min_double, i * 0.5) : i * 0.5;
+            }
+            if (i != 1234) {
+                sum_float += i % 100;
+                ++count_float;
+                max_float = std::max(max_float, float(i % 100));
+            }
+        }
+        CHECK_EQUAL(q.sum(col_int)->get_int(), sum_int);
+        CHECK_EQUAL(q.sum(col_int_null)->get_int(), sum_null);
+        CHECK_EQUAL(q.sum(col_double)->get_double(), sum_double);
+        CHECK_EQUAL(q.sum(col_float)->get_double(), sum_float);
+        size_t count;
+        q.avg(col_int_null, &count);
+        CHECK_EQUAL(count, count_null);
+        q.avg(col_double, &count);
+        CHECK_EQUAL(count, count_double);
+        q.avg(col_float, &count);
+        CHECK_EQUAL(count, count_float);
+
+        ObjKey key;
+        auto min = q.min(col_int, &key);
+        CHECK_EQUAL(min->get_int(), *min_int);
+        CHECK_EQUAL(t.get_object(key).get<int64_t>(col_int), *min_int);
+        auto max = q.max(col_int_null, &key);
+        CHECK_EQUAL(max->get_int(), *max_null);
+        CHECK_EQUAL(t.get_object(key).get<std::optional<int64_t>>(col_int_null), *max_null);
+        min = q.min(col_double, &key);
+        CHECK_EQUAL(min->get_double(), *min_double);
+        CHECK_EQUAL(t.get_object(key).get<std::optional<double>>(col_double), *min_double);
+        max = q.max(col_float, &key);
+        CHECK_EQUAL(max->get_float(), max_float);
+        CHECK_EQUAL(t.get_object(key).get<float>(col_float), max_float);
+    };
+
+    check(t.where(), [](int64_t) {
+        return true;
+    });
+    check(t.where().greater_equal(col_int, -400), [](int64_t) {
+        return true;
+    });
+    check(t.where().less(col_float, 50.f), [](int64_t i) {
+        return i != 1234 && i % 100 < 50;
+    });
+    check(t.where().not_equal(col_int, 0), [](int64_t i) {
+        return (i * 7919) % 1000 != 400;
+    });
+}
+
+TEST(Query_Explain)
+{
+    Table t;
+    auto col_indexed = t.add_column(type_Int, "indexed");
+    auto col_value = t.add_column(type_Int, "value");
+    auto col_name = t.add_column(type_String, "name");
+    t.add_search_index(col_indexed);
+    for (int64_t i = 0; i < 2000; ++i)
+        t.create_object().set_all(i % 2 ? i : 0, i, util::format("name%1", i));
+
+    // The index finds a single object
+    Query q = t.where().contains(col_name, StringData("7")).equal(col_indexed, 7);
+    auto plan = q.explain();
+    CHECK(plan.find("INDEX indexed == 7") == 0);
+    CHECK_NOT_EQUAL(plan.find("\nFILTER name CONTAINS \"7\""), std::string::npos);
+    CHECK_EQUAL(q.count(), 1);
+
+    // The index matches half the table, so scanning another column is cheaper
+    q = t.where().equal(col_indexed, 0).equal(col_value, 10);
+    plan = q.explain();
+    CHECK(plan.find("SCAN value == 10") == 0);
+    CHECK_NOT_EQUAL(plan.find("\nFILTER indexed == 0"), std::string::npos);
+    CHECK_EQUAL(q.count(), 1);
+    CHECK_EQUAL(q.find_all().size(), 1);
+
+    // A selective condition drives the search even when added last
+    q = t.where().contains(col_name, StringData("5")).greater(col_value, 100).equal(col_value, 1500);
+    plan = q.explain();
+    CHECK(plan.find("SCAN value == 1500") == 0);
+    CHECK_EQUAL(q.count(), 1);
+    CHECK_EQUAL(q.sum(col_value)->get_int(), 1500);
+
+    // Running a query records the time spent in each condition
+    q = t.where().contains(col_name, StringData("1")).greater(col_value, 100);
+    CHECK_EQUAL(q.count(), size_t(t.where().contains(col_name, StringData("1")).count()) - 20);
+    plan = q.explain();
+    CHECK(plan.find("SCAN ") == 0);
+    CHECK_NOT_EQUAL(plan.find("\nFILTER "), std::string::npos);
+
+    CHECK_EQUAL(t.where().explain(), "SCAN TRUEPREDICATE\n");
+}
+
 TEST(Query_FindAllRangeOr)
 {
     Table ttt;
@@ -3710,6 +3843,114 @@ TEST(Query_FindAllRangeOr)
     CHECK_EQUAL(4, tv1.size());
 }
 
+TEST(Query_ManyOrConditions)
+{
+    Table t;
+    auto col_int = t.add_column(type_Int, "int");
+    auto col_indexed = t.add_column(type_Int, "indexed");
+    auto col_str = t.add_column(type_String, "str");
+    auto col_double = t.add_column(type_Double, "double");
+    t.add_search_index(col_indexed);
+    for (int64_t i = 0; i < 3000; ++i)
+        t.create_object().set_all(i, i % 100, util::format("s%1", i % 37), double(i % 50));
+
+    auto check = [&](Query q, auto expected) {
+        std::vector<ObjKey> keys;
+        for (auto& obj : t) {
+            if (expected(obj))
+                keys.push_back(obj.get_key());
+        }
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), keys.size());
+        for (size_t i = 0; i < std::min(tv.size(), keys.size()); ++i)
+            CHECK_EQUAL(tv.get_key(i), keys[i]);
+        CHECK_EQUAL(q.count(), keys.size());
+        if (!keys.empty())
+            CHECK_EQUAL(q.find(), keys[0]);
+    };
+
+    // Conditions on different columns, one of them an AND group
+    Query q = t.where()
+                  .equal(col_int, 17)
+                  .Or()
+                  .greater(col_int, 2990)
+                  .Or()
+                  .equal(col_indexed, 42)
+                  .Or()
+                  .equal(col_str, "s5")
+                  .Or()
+                  .group()
+                  .less(col_double, 1.0)
+                  .less(col_int, 1000)
+                  .end_group();
+    check(q, [&](const Obj& obj) {
+        int64_t i = obj.get<Int>(col_int);
+        return i == 17 || i > 2990 || i % 100 == 42 || i % 37 == 5 || (i % 50 < 1 && i < 1000);
+    });
+    // Also when ANDed with another condition, and within a view
+    check(t.where().greater(col_int, 1500).and_query(q), [&](const Obj& obj) {
+        int64_t i = obj.get<Int>(col_int);
+        return i > 1500 && (i > 2990 || i % 100 == 42 || i % 37 == 5);
+    });
+    auto tv = t.where().less(col_int, 2000).find_all();
+    q = t.where(&tv).equal(col_int, 1).Or().equal(col_int, 3).Or().equal(col_int, 1999).Or().equal(col_int, 2500);
+    CHECK_EQUAL(q.count(), 3);
+
+    // Few values looked up in the index
+    std::vector<Mixed> values{3, 5, 1000, 97};
+    check(t.where().in(col_indexed, values.data(), values.data() + values.size()), [&](const Obj& obj) {
+        int64_t v = obj.get<Int>(col_indexed);
+        return v == 3 || v == 5 || v == 97;
+    });
+    // Many values checked against a set
+    values.clear();
+    for (int64_t i = 2000; i < 2500; i += 3)
+        values.push_back(i);
+    check(t.where().in(col_int, values.data(), values.data() + values.size()), [&](const Obj& obj) {
+        int64_t i = obj.get<Int>(col_int);
+        return i >= 2000 && i < 2500 && (i - 2000) % 3 == 0;
+    });
+    check(t.where().in(col_indexed, values.data(), values.data() + values.size()), [&](const Obj&) {
+        return false;
+    });
+}
+
+TEST(Query_ManyOrConditionsBoundedRange)
+{
+    Group g;
+    auto t = g.add_table("table");
+    auto col_int = t->add_column(type_Int, "int");
+    auto col_str = t->add_column(type_String, "str");
+    auto col_double = t->add_column(type_Double, "double");
+    auto col_bool = t->add_column(type_Bool, "bool");
+    for (int64_t i = 0; i < 200; ++i)
+        t->create_object().set_all(i == 150 ? 7 : 0, "a", 0.0, false);
+
+    // Conditions on different columns and types can not be combined, so the
+    // OR node collects their matches in a bitmap
+    OrNode node(std::make_unique<IntegerNode<ArrayInteger, Equal>>(7, col_int));
+    node.m_conditions.emplace_back(std::make_unique<StringNode<Equal>>("b", col_str));
+    node.m_conditions.emplace_back(std::make_unique<FloatDoubleNode<ArrayDouble, Equal>>(1.0, col_double));
+    node.m_conditions.emplace_back(std::make_unique<BoolNode<Equal>>(true, col_bool));
+    node.set_table(t);
+    node.init(true);
+    CHECK_EQUAL(node.m_conditions.size(), 4);
+
+    t->traverse_clusters([&](const Cluster* cluster) {
+        if (cluster->node_size() != 200)
+            return IteratorControl::Stop;
+        node.set_cluster(cluster);
+        CHECK_EQUAL(node.find_first_local(0, 100), not_found);
+        CHECK_EQUAL(node.find_first_local(0, 200), 150);
+        // The bitmap now covers the whole cluster, but a match past the end
+        // of a narrower range must not be reported
+        CHECK_EQUAL(node.find_first_local(0, 100), not_found);
+        CHECK_EQUAL(node.find_first_local(100, 150), not_found);
+        CHECK_EQUAL(node.find_first_local(100, 151), 150);
+        return IteratorControl::Stop;
+    });
+}
+
 
 TEST(Query_SimpleStr)
 {
@@ -5795,4 +6036,219 @@ TEST(Query_NestedLinkCount)
     CHECK_EQUAL(q.count(), 3);
 }
 
+TEST(Query_SkipClustersByLeafBounds)
+{
+    // Timestamps increasing with the object key, so every cluster holds a
+    // narrow range that the leaf summaries written at commit describe
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.offset_encode_integer_leaves = true;
+    auto db = DB::create(path, options);
+    const int64_t base = 1700000000000;
+    const size_t num_objects = 5 * REALM_MAX_BPNODE_SIZE;
+    ColKey col_time, col_val;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("series");
+        col_time = table->add_column(type_Int, "time");
+        col_val = table->add_column(type_Int, "value");
+        for (size_t i = 0; i < num_objects; ++i) {
+            auto obj = table->create_object(ObjKey(int64_t(i)));
+            obj.set(col_time, base + int64_t(i) * 10).set(col_val, int64_t(i % 7));
+        }
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("series");
+    auto count_brute_force = [&](auto pred) {
+        size_t n = 0;
+        for (auto& o : *table)
+            n += pred(o.get<Int>(col_time), o.get<Int>(col_val)) ? 1 : 0;
+        return n;
+    };
+
+    int64_t t = base + 10 * int64_t(num_objects / 2);
+    CHECK_EQUAL(table->where().greater(col_time, t).count(),
+                count_brute_force([&](int64_t v, int64_t) { return v > t; }));
+    CHECK_EQUAL(table->where().less(col_time, base + 25).count(), 3);
+    CHECK_EQUAL(table->where().equal(col_time, t).find(), ObjKey(int64_t(num_objects / 2)));
+    CHECK_EQUAL(table->where().equal(col_time, t + 1).count(), 0);
+    CHECK_EQUAL(table->where().between(col_time, t, t + 100).count(), 11);
+    CHECK_EQUAL(table->where().greater(col_time, base + 10 * int64_t(num_objects)).count(), 0);
+    CHECK_EQUAL(table->where().greater(col_time, base - 1).count(), num_objects);
+
+    auto q = table->where().greater_equal(col_time, t).equal(col_val, 3);
+    CHECK_EQUAL(q.count(), count_brute_force([&](int64_t v, int64_t x) { return v >= t && x == 3; }));
+    auto tv = q.find_all();
+    CHECK_EQUAL(tv.size(), q.count());
+    for (size_t i = 0; i < tv.size(); ++i) {
+        CHECK_GREATER_EQUAL(tv.get_object(i).get<Int>(col_time), t);
+        CHECK_EQUAL(tv.get_object(i).get<Int>(col_val), 3);
+    }
+    CHECK_EQUAL(table->where().less(col_time, base + 100).sum(col_val)->get_int(),
+                0 + 1 + 2 + 3 + 4 + 5 + 6 + 0 + 1 + 2);
+    CHECK_EQUAL(table->where().greater(col_time, t).max(col_time)->get_int(),
+                base + 10 * int64_t(num_objects - 1));
+}
+
+TEST(Query_Parallel)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(path);
+
+    constexpr size_t num_objects = 25000;
+    ColKey col_int, col_double, col_str;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("Foo");
+        col_int = table->add_column(type_Int, "int", true);
+        col_double = table->add_column(type_Double, "double");
+        col_str = table->add_column(type_String, "str");
+        std::vector<ObjKey> to_remove;
+        for (size_t i = 0; i < num_objects; ++i) {
+            auto obj = table->create_object();
+            if (i % 7)
+                obj.set(col_int, int64_t(i % 1000));
+            obj.set(col_double, double(i % 100) / 4);
+            obj.set(col_str, util::to_string(i % 13));
+            if (i % 11 == 0)
+                to_remove.push_back(obj.get_key());
+        }
+        for (auto key : to_remove)
+            table->remove_object(key);
+        wt->commit();
+    }
+
+    auto check = [&](Query serial) {
+        Query parallel = Query(serial).set_threads(0);
+        CHECK_EQUAL(parallel.count(), serial.count());
+
+        TableView tv_serial = serial.find_all();
+        TableView tv_parallel = parallel.find_all();
+        if (CHECK_EQUAL(tv_parallel.size(), tv_serial.size())) {
+            for (size_t i = 0; i < tv_serial.size(); ++i) {
+                if (!CHECK_EQUAL(tv_parallel.get_key(i), tv_serial.get_key(i)))
+                    break;
+            }
+        }
+
+        ObjKey key_serial, key_parallel;
+        CHECK_EQUAL(*parallel.min(col_int, &key_parallel), *serial.min(col_int, &key_serial));
+        CHECK_EQUAL(key_parallel, key_serial);
+        CHECK_EQUAL(*parallel.max(col_double, &key_parallel), *serial.max(col_double, &key_serial));
+        CHECK_EQUAL(key_parallel, key_serial);
+        CHECK_EQUAL(*parallel.sum(col_int), *serial.sum(col_int));
+        CHECK_EQUAL(*parallel.sum(col_double), *serial.sum(col_double));
+        size_t count_serial = 0, count_parallel = 0;
+        CHECK_EQUAL(*parallel.avg(col_int, &count_parallel), *serial.avg(col_int, &count_serial));
+        CHECK_EQUAL(count_parallel, count_serial);
+    };
+
+    auto run_queries = [&](ConstTableRef table) {
+        check(table->where());
+        check(table->where().greater(col_int, 500));
+        check(table->where().equal(col_str, "3").Or().less(col_double, 2.0));
+        check(table->where().equal(col_int, 12345));
+    };
+
+    // Only frozen tables are searched in parallel, but others must give the same results
+    auto frozen = db->start_frozen();
+    run_queries(frozen->get_table("Foo"));
+    auto rt = db->start_read();
+    run_queries(rt->get_table("Foo"));
+}
+
+TEST(Query_ResultCache)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.query_cache_size = 3;
+    auto hist = make_in_realm_history();
+    DBRef db = DB::create(*hist, path, options);
+    QueryCache* cache = db->get_query_cache();
+    CHECK(cache);
+
+    ColKey col_int, col_str;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("Foo");
+        col_int = table->add_column(type_Int, "int", true);
+        col_str = table->add_column(type_String, "str");
+        for (int i = 0; i < 100; ++i)
+            table->create_object().set(col_int, i % 10).set(col_str, util::to_string(i % 3));
+        wt->add_table("Bar");
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("Foo");
+    Query q = table->where().greater(col_int, 6);
+    CHECK_EQUAL(q.count(), 30);
+    CHECK_EQUAL(q.count(), 30);
+    CHECK_EQUAL(cache->hit_count(), 1);
+
+    // An identical query in another transaction on the same version
+    auto frozen = db->start_frozen();
+    CHECK_EQUAL(frozen->get_table("Foo")->where().greater(col_int, 6).count(), 30);
+    CHECK_EQUAL(cache->hit_count(), 2);
+
+    // Views, sorted or not
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col_str}}, {false}));
+    ordering.append_limit(5);
+    TableView tv = q.find_all(ordering);
+    TableView tv2 = table->where().greater(col_int, 6).find_all(ordering);
+    CHECK_EQUAL(cache->hit_count(), 3);
+    CHECK_EQUAL(tv2.size(), 5);
+    for (size_t i = 0; i < tv.size(); ++i) {
+        CHECK_EQUAL(tv2.get_key(i), tv.get_key(i));
+        CHECK_EQUAL(tv2.get_object(i).get<String>(col_str), "2");
+    }
+    CHECK_EQUAL(q.find_all().size(), 30);
+
+    // Aggregates
+    ObjKey key;
+    CHECK_EQUAL(q.max(col_int, &key)->get_int(), 9);
+    key = ObjKey();
+    CHECK_EQUAL(q.max(col_int, &key)->get_int(), 9);
+    CHECK_EQUAL(table->get_object(key).get<Int>(col_int), 9);
+    size_t value_count = 0;
+    CHECK_EQUAL(q.avg(col_int, &value_count)->get_double(), 8.0);
+    value_count = 0;
+    CHECK_EQUAL(q.avg(col_int, &value_count)->get_double(), 8.0);
+    CHECK_EQUAL(value_count, 30);
+    CHECK_LESS_EQUAL(cache->size(), 3);
+
+    // A commit to any table gives a new version
+    size_t hits = cache->hit_count();
+    {
+        auto wt = db->start_write();
+        wt->get_table("Foo")->create_object().set(col_int, 8);
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(q.count(), 31);
+    tv.sync_if_needed();
+    CHECK_EQUAL(tv.size(), 5);
+    CHECK_EQUAL(q.sum(col_int)->get_int(), 248);
+    CHECK_EQUAL(cache->hit_count(), hits);
+    // The frozen transaction still sees its own version
+    CHECK_EQUAL(frozen->get_table("Foo")->where().greater(col_int, 6).count(), 30);
+
+    // Nothing is cached in a write transaction
+    {
+        auto wt = db->start_write();
+        auto t = wt->get_table("Foo");
+        t->create_object().set(col_int, 9);
+        CHECK_EQUAL(t->where().greater(col_int, 6).count(), 32);
+        CHECK_EQUAL(t->where().greater(col_int, 6).count(), 32);
+        CHECK_EQUAL(cache->hit_count(), hits);
+    }
+
+    cache->clear();
+    CHECK_EQUAL(cache->size(), 0);
+    CHECK_EQUAL(q.count(), 31);
+}
+
 #endif // TEST_QUERY
@@ -4570,4 +4570,209 @@ TEST(Shared_ClearOnError_CannotClearWhileFileIsOpen)
 }
 #endif
 
+TEST(Shared_OffsetEncodedIntegerLeaves)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.offset_encode_integer_leaves = true;
+    const int64_t base = 1700000000;
+    ColKey col_int, col_str;
+    {
+        auto db = DB::create(path, options);
+        WriteTransaction wt(db);
+        auto table = wt.add_table("table");
+        col_int = table->add_column(type_Int, "int");
+        col_str = table->add_column(type_String, "str");
+        for (int64_t i = 0; i < 1000; ++i)
+            table->create_object(ObjKey(i)).set(col_int, base + i).set(col_str, "foo");
+        wt.commit();
+    }
+    {
+        auto db = DB::create(path, options);
+        auto rt = db->start_read();
+        rt->verify();
+        auto table = rt->get_table("table");
+        CHECK_EQUAL(table->size(), 1000);
+        CHECK_EQUAL(table->get_object(ObjKey(10)).get<Int>(col_int), base + 10);
+        CHECK_EQUAL(table->get_object(ObjKey(10)).get<String>(col_str), "foo");
+        CHECK_EQUAL(table->where().greater(col_int, base + 989).count(), 10);
+        CHECK_EQUAL(table->where().less(col_int, base + 5).count(), 5);
+        CHECK_EQUAL(table->where().equal(col_int, base + 500).find(), ObjKey(500));
+        CHECK_EQUAL(table->where().equal(col_int, int64_t(500)).count(), 0);
+        CHECK_EQUAL(table->sum(col_int)->get_int(), 1000 * base + 999 * 1000 / 2);
+        CHECK_EQUAL(table->max(col_int)->get_int(), base + 999);
+        CHECK_EQUAL(table->min(col_int)->get_int(), base);
+
+    }
+    {
+        // Modifying an encoded leaf expands it again
+        auto db = DB::create(path, options);
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        table->get_object(ObjKey(10)).set(col_int, -1);
+        table->create_object(ObjKey(1000)).set(col_int, base);
+        wt->commit_and_continue_as_read();
+        wt->verify();
+        CHECK_EQUAL(table->get_object(ObjKey(10)).get<Int>(col_int), -1);
+        CHECK_EQUAL(table->get_object(ObjKey(11)).get<Int>(col_int), base + 11);
+        CHECK_EQUAL(table->where().equal(col_int, base).count(), 2);
+    }
+    {
+        auto db = DB::create(path, options);
+        auto rt = db->start_read();
+        rt->verify();
+        auto table = rt->get_table("table");
+        CHECK_EQUAL(table->size(), 1001);
+        CHECK_EQUAL(table->sum(col_int)->get_int(), 1001 * base + 999 * 1000 / 2 - base - 10 - 1);
+    }
+}
+
+TEST(Shared_ParallelCommitWriter)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.commit_writer_threads = 4;
+    ColKey col_int, col_bin;
+    // Large enough for the staged arrays to be written in more than one batch
+    const size_t num_blobs = 400;
+    std::string blob(100000, 'x');
+    {
+        auto db = DB::create(path, options);
+        WriteTransaction wt(db);
+        auto table = wt.add_table("table");
+        col_int = table->add_column(type_Int, "int");
+        col_bin = table->add_column(type_Binary, "bin");
+        for (size_t i = 0; i < num_blobs; ++i) {
+            blob[0] = char('a' + i % 26);
+            table->create_object(ObjKey(i)).set(col_int, int64_t(i)).set(col_bin, BinaryData(blob));
+        }
+        for (size_t i = num_blobs; i < 100000; ++i)
+            table->create_object(ObjKey(i)).set(col_int, int64_t(i));
+        wt.commit();
+    }
+    {
+        auto db = DB::create(path, options);
+        auto wt = db->start_write();
+        auto table = wt->get_table("table");
+        for (int64_t i = 0; i < 100000; i += 100)
+            table->get_object(ObjKey(i)).set(col_int, -i);
+        wt->commit();
+    }
+    {
+        auto db = DB::create(path, options);
+        auto rt = db->start_read();
+        rt->verify();
+        auto table = rt->get_table("table");
+        CHECK_EQUAL(table->size(), 100000);
+        CHECK_EQUAL(table->get_object(ObjKey(200)).get<Int>(col_int), -200);
+        CHECK_EQUAL(table->get_object(ObjKey(99999)).get<Int>(col_int), 99999);
+        for (size_t i = 0; i < num_blobs; i += 37) {
+            BinaryData bin = table->get_object(ObjKey(i)).get<Binary>(col_bin);
+            CHECK_EQUAL(bin.size(), blob.size());
+            CHECK_EQUAL(bin[0], char('a' + i % 26));
+            CHECK_EQUAL(bin[bin.size() - 1], 'x');
+        }
+        CHECK_EQUAL(table->get_object(ObjKey(num_blobs)).get<Binary>(col_bin).size(), 0);
+    }
+}
+
+TEST(Shared_ReadAheadAndPrefetch)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.read_ahead = DBOptions::ReadAhead::Sequential;
+    options.prefetch_clusters = true;
+    ColKey col_int, col_str;
+    {
+        auto db = DB::create(path, options);
+        WriteTransaction wt(db);
+        auto table = wt.add_table("table");
+        col_int = table->add_column(type_Int, "int");
+        col_str = table->add_column(type_String, "str");
+        for (int64_t i = 0; i < 50000; ++i)
+            table->create_object(ObjKey(i)).set(col_int, i % 100).set(col_str, util::to_string(i));
+        wt.commit();
+    }
+    for (auto read_ahead : {DBOptions::ReadAhead::Sequential, DBOptions::ReadAhead::Random}) {
+        options.read_ahead = read_ahead;
+        auto db = DB::create(path, options);
+        auto before = DB::get_page_fault_counts();
+        auto rt = db->start_read();
+        auto table = rt->get_table("table");
+        CHECK(table->get_alloc().get_prefetch_clusters());
+
+        Query q = table->where().equal(col_int, 7);
+        CHECK_EQUAL(q.count(), 500);
+        CHECK_EQUAL(q.find(), ObjKey(7));
+        CHECK_EQUAL(*q.sum(col_int), 3500);
+        auto tv = q.find_all();
+        CHECK_EQUAL(tv.size(), 500);
+        CHECK_EQUAL(tv.get_object(499).get<String>(col_str), "49907");
+
+        // Disabling prefetch for a single query must not change the result
+        Query q2(q);
+        q2.prefetch_clusters(false);
+        CHECK_EQUAL(q2.count(), 500);
+        CHECK_EQUAL(table->where().greater(col_int, 97).prefetch_clusters(false).count(), 1000);
+
+        auto after = DB::get_page_fault_counts();
+        CHECK_GREATER_EQUAL(after.minor, before.minor);
+        CHECK_GREATER_EQUAL(after.major, before.major);
+    }
+}
+
+TEST_TYPES(Shared_HugePages, std::integral_constant<DBOptions::HugePages, DBOptions::HugePages::Transparent>,
+           std::integral_constant<DBOptions::HugePages, DBOptions::HugePages::Explicit>)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBOptions options(crypt_key());
+    options.huge_pages = TEST_TYPE::value;
+    auto fill = [&](DBRef db) {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        auto col_int = table->add_column(type_Int, "int");
+        auto col_str = table->add_column(type_String, "str");
+        // Enough data to need several slabs
+        for (int64_t i = 0; i < 100000; ++i)
+            table->create_object(ObjKey(i)).set(col_int, i * 3).set(col_str, util::to_string(i));
+        wt->commit();
+    };
+    auto check = [&](DBRef db) {
+        auto rt = db->start_read();
+        rt->verify();
+        auto table = rt->get_table("table");
+        CHECK_EQUAL(table->size(), 100000);
+        for (int64_t i = 0; i < 100000; i += 997) {
+            auto obj = table->get_object(ObjKey(i));
+            CHECK_EQUAL(obj.get<Int>("int"), i * 3);
+            CHECK_EQUAL(obj.get<String>("str"), util::to_string(i));
+        }
+    };
+    {
+        auto db = DB::create(path, options);
+        fill(db);
+        check(db);
+        // Small transactions keep reusing the retained slab
+        for (int i = 0; i < 10; ++i) {
+            auto wt = db->start_write();
+            wt->get_table("table")->get_object(ObjKey(i)).set("int", -1);
+            wt->commit();
+        }
+    }
+    {
+        auto db = DB::create(path, options);
+        auto rt = db->start_read();
+        CHECK_EQUAL(rt->get_table("table")->get_object(ObjKey(9)).get<Int>("int"), -1);
+        CHECK_EQUAL(rt->get_table("table")->get_object(ObjKey(10)).get<Int>("int"), 30);
+    }
+    {
+        // In-memory Realms keep the whole database in huge page backed buffers
+        DBOptions in_memory_options;
+        in_memory_options.huge_pages = TEST_TYPE::value;
+        auto db = DB::create(make_in_realm_history(), in_memory_options);
+        fill(db);
+        check(db);
+    }
+}
+
 #endif // TEST_SHARED
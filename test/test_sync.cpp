@@ -2252,6 +2252,133 @@ TEST_IF(Sync_ReadOnlyClient, false)
 }
 
 
+TEST(Sync_DownloadCompressionLevel)
+{
+    // Clients read DOWNLOAD bodies whether or not, and however hard, the server compresses them
+    for (int level : {0, 1, 9}) {
+        TEST_CLIENT_DB(db_1);
+        TEST_CLIENT_DB(db_2);
+
+        TEST_DIR(server_dir);
+        MultiClientServerFixture::Config config;
+        config.server_download_compression_level = level;
+        MultiClientServerFixture fixture(2, 1, server_dir, test_context, config);
+        fixture.start();
+
+        {
+            WriteTransaction wt(db_1);
+            auto table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+            auto col = table->add_column(type_String, "s");
+            for (int i = 0; i < 1000; ++i)
+                table->create_object_with_primary_key(i).set(col, util::format("string %1 at level %2", i, level));
+            wt.commit();
+        }
+
+        Session session_1 = fixture.make_bound_session(0, db_1, 0, "/test");
+        Session session_2 = fixture.make_bound_session(1, db_2, 0, "/test");
+        session_1.wait_for_upload_complete_or_client_stopped();
+        session_2.wait_for_download_complete_or_client_stopped();
+
+        ReadTransaction rt_1(db_1);
+        ReadTransaction rt_2(db_2);
+        CHECK(compare_groups(rt_1, rt_2));
+        CHECK_EQUAL(rt_2.get_table("class_foo")->size(), 1000);
+    }
+
+    // Levels outside what zlib accepts are rejected up front
+    for (int level : {-1, 10}) {
+        TEST_DIR(server_dir);
+        Server::Config server_config;
+        server_config.logger = std::make_shared<util::PrefixLogger>("Server: ", test_context.logger);
+        server_config.download_compression_level = level;
+        CHECK_THROW(Server(server_dir, PKey::load_public(test_server_key_path()), server_config), std::runtime_error);
+    }
+}
+
+
+TEST(Sync_DownloadBodyCodec)
+{
+    // Servers preferring no codec, or a codec the client accepts, interoperate
+    // with it in both directions
+    using Codecs = std::vector<BodyCodec>;
+    for (const Codecs& codecs : {Codecs{}, Codecs{BodyCodec::zlib}, Codecs{BodyCodec::none, BodyCodec::zlib}}) {
+        TEST_CLIENT_DB(db_1);
+        TEST_CLIENT_DB(db_2);
+
+        TEST_DIR(server_dir);
+        MultiClientServerFixture::Config config;
+        config.server_download_body_codecs = codecs;
+        MultiClientServerFixture fixture(2, 1, server_dir, test_context, config);
+        fixture.start();
+
+        auto write = [&](DBRef db, int begin, int end) {
+            WriteTransaction wt(db);
+            auto table = wt.get_group().get_or_add_table_with_primary_key("class_foo", type_Int, "id");
+            auto col = table->get_column_key("s");
+            if (!col)
+                col = table->add_column(type_String, "s");
+            for (int i = begin; i < end; ++i)
+                table->create_object_with_primary_key(i).set(col, util::format("string %1", i));
+            wt.commit();
+        };
+
+        write(db_1, 0, 1000);
+        Session session_1 = fixture.make_bound_session(0, db_1, 0, "/test");
+        Session session_2 = fixture.make_bound_session(1, db_2, 0, "/test");
+        session_1.wait_for_upload_complete_or_client_stopped();
+        session_2.wait_for_download_complete_or_client_stopped();
+
+        // The second client uploads after having received compressed downloads
+        write(db_2, 1000, 2000);
+        session_2.wait_for_upload_complete_or_client_stopped();
+        session_1.wait_for_download_complete_or_client_stopped();
+
+        ReadTransaction rt_1(db_1);
+        ReadTransaction rt_2(db_2);
+        CHECK(compare_groups(rt_1, rt_2));
+        CHECK_EQUAL(rt_1.get_table("class_foo")->size(), 2000);
+    }
+}
+
+
+TEST(Sync_ServerMultipleWorkers)
+{
+    // Uploads to files served by different workers are integrated in parallel
+    constexpr int num_files = 8;
+    TEST_DIR(client_dir);
+    TEST_DIR(server_dir);
+    MultiClientServerFixture::Config config;
+    config.server_num_workers = 4;
+    MultiClientServerFixture fixture(2, 1, server_dir, test_context, config);
+    fixture.start();
+
+    std::vector<DBRef> dbs_1, dbs_2;
+    std::vector<Session> sessions_1, sessions_2;
+    for (int i = 0; i < num_files; ++i) {
+        std::string server_path = util::format("/test_%1", i);
+        dbs_1.push_back(DB::create(make_client_replication(),
+                                   util::File::resolve(util::format("db_1_%1.realm", i), client_dir)));
+        dbs_2.push_back(DB::create(make_client_replication(),
+                                   util::File::resolve(util::format("db_2_%1.realm", i), client_dir)));
+        WriteTransaction wt(dbs_1[i]);
+        auto table = wt.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+        for (int j = 0; j <= i; ++j)
+            table->create_object_with_primary_key(j);
+        wt.commit();
+        sessions_1.push_back(fixture.make_bound_session(0, dbs_1[i], 0, server_path));
+        sessions_2.push_back(fixture.make_bound_session(1, dbs_2[i], 0, server_path));
+    }
+    for (int i = 0; i < num_files; ++i) {
+        sessions_1[i].wait_for_upload_complete_or_client_stopped();
+        sessions_2[i].wait_for_download_complete_or_client_stopped();
+        ReadTransaction rt_1(dbs_1[i]);
+        ReadTransaction rt_2(dbs_2[i]);
+        CHECK(compare_groups(rt_1, rt_2));
+        CHECK_EQUAL(rt_2.get_table("class_foo")->size(), i + 1);
+    }
+}
+
+
 // This test is a performance study. A single client keeps creating
 // transactions that creates new objects and uploads them. The time to perform
 // upload completion is measured and logged at info level.
@@ -7459,6 +7586,85 @@ TEST(Sync_NonIncreasingServerVersions)
                                         DownloadBatchState::SteadyState, *test_context.logger, transact);
 }
 
+TEST(Sync_IntegrateServerChangesetsInBatches)
+{
+    TEST_CLIENT_DB(db);
+
+    auto& history = get_history(db);
+    history.set_client_file_ident(SaltedFileIdent{2, 0x1234567812345678}, false);
+    timestamp_type timestamp{1};
+    history.set_local_origin_timestamp_source([&] {
+        return ++timestamp;
+    });
+
+    auto latest_local_version = [&] {
+        auto tr = db->start_write();
+        tr->add_table_with_primary_key("class_foo", type_String, "_id")->add_column(type_Int, "int_col");
+        return tr->commit();
+    }();
+
+    std::vector<ChangesetEncoder::Buffer> encoded;
+    std::vector<RemoteChangeset> server_changesets_encoded;
+    for (int i = 0; i < 100; ++i) {
+        Changeset changeset;
+        changeset.version = 10 + i;
+        changeset.last_integrated_remote_version = latest_local_version - 1;
+        changeset.origin_timestamp = ++timestamp;
+        changeset.origin_file_ident = 1;
+        instr::PrimaryKey pk{changeset.intern_string(util::format("obj_%1", i))};
+        instr::CreateObject create;
+        create.object = pk;
+        create.table = changeset.intern_string("foo");
+        changeset.push_back(create);
+        instr::Update update;
+        update.table = create.table;
+        update.object = pk;
+        update.field = changeset.intern_string("int_col");
+        update.value = instr::Payload{int64_t(i)};
+        changeset.push_back(update);
+
+        encoded.emplace_back();
+        encode_changeset(changeset, encoded.back());
+        server_changesets_encoded.emplace_back(changeset.version, changeset.last_integrated_remote_version,
+                                               BinaryData(encoded.back().data(), encoded.back().size()),
+                                               changeset.origin_timestamp, changeset.origin_file_ident);
+    }
+
+    SyncProgress progress = {};
+    progress.download.server_version = server_changesets_encoded.back().remote_version;
+    progress.download.last_integrated_client_version = latest_local_version - 1;
+    progress.latest_server_version.version = server_changesets_encoded.back().remote_version;
+    progress.latest_server_version.salt = 0x7876543217654321;
+
+    // A reader sees the changesets integrated so far after each batch
+    std::vector<size_t> sizes;
+    uint_fast64_t downloadable_bytes = 0;
+    VersionInfo version_info;
+    auto transact = db->start_read();
+    history.integrate_server_changesets(
+        progress, downloadable_bytes, server_changesets_encoded, version_info, DownloadBatchState::SteadyState,
+        *test_context.logger, transact,
+        [&](const Transaction& tr, util::Span<Changeset> changesets) {
+            CHECK_GREATER(changesets.size(), 0);
+            sizes.push_back(tr.get_table("class_foo")->size());
+        },
+        512);
+    CHECK_GREATER(sizes.size(), 5);
+    CHECK_EQUAL(sizes.back(), 100);
+    CHECK_EQUAL(version_info.realm_version, latest_local_version + sizes.size());
+
+    auto table = transact->get_table("class_foo");
+    CHECK_EQUAL(table->size(), 100);
+    CHECK_EQUAL(table->get_object_with_primary_key("obj_42").get<Int>("int_col"), 42);
+
+    version_type current_version;
+    SaltedFileIdent file_ident;
+    SyncProgress expected_progress;
+    history.get_status(current_version, file_ident, expected_progress);
+    CHECK_EQUAL(current_version, version_info.realm_version);
+    CHECK_EQUAL(progress.download.server_version, expected_progress.download.server_version);
+}
+
 TEST(Sync_DanglingLinksCountInPriorSize)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -139,7 +139,7 @@ TEST(Protocol_Codec_Upload)
     auto protocol = _impl::ClientProtocol();
     auto out = _impl::ClientProtocol::OutputBuffer();
     {
-        auto upload_message_builder = protocol.make_upload_message_builder(); // Throws
+        auto upload_message_builder = protocol.make_upload_message_builder(sync::BodyCodec::zlib); // Throws
         std::string data1 = "AABBCCDDEEFFGGHHIIJJKKLLMMNNOOPP";
         std::string data2 = "EEFFGGHHIIJJKKLLMMNNOOPPQQRRSSTT";
 
@@ -154,7 +154,7 @@ TEST(Protocol_Codec_Upload)
 
     {
         out.reset();
-        auto upload_message_builder = protocol.make_upload_message_builder(); // Throws
+        auto upload_message_builder = protocol.make_upload_message_builder(sync::BodyCodec::zlib); // Throws
         // Create a changeset that exceeds the compression threshold (1024 bytes)
         std::string data1 = std::string(512, 'A') + std::string(512, 'B') + std::string(512, 'C');
         std::string data2 = std::string(util::format("4 2 259609999999 123999 %1 ", data1.length())) + data1;
@@ -192,6 +192,46 @@ TEST(Protocol_Codec_Upload)
         CHECK_NOT(util::compression::decompress(changeset, decompressed_buf));
         compare_out_string(data2, decompressed_buf, test_context);
     }
+
+    {
+        // Without a codec, the body is sent as is regardless of its size
+        out.reset();
+        auto upload_message_builder = protocol.make_upload_message_builder(sync::BodyCodec::none); // Throws
+        std::string data1 = std::string(512, 'A') + std::string(512, 'B') + std::string(512, 'C');
+        std::string data2 = std::string(util::format("4 2 259609999999 123999 %1 ", data1.length())) + data1;
+
+        std::string expected_out_string = util::format("upload 777123 0 %1 0 4 2 0\n", data2.length()) + data2;
+        upload_message_builder.add_changeset(4, 2, 259609999999, 123999, BinaryData(data1.c_str(), data1.size()));
+        upload_message_builder.make_upload_message(7, out, 777123, 4, 2, 0);
+        compare_out_string(expected_out_string, out, test_context);
+    }
+}
+
+TEST(Protocol_Codec_Body_Codec)
+{
+    std::string body = std::string(512, 'A') + std::string(512, 'B');
+    std::vector<char> compressed;
+    util::compression::CompressMemoryArena arena;
+
+    CHECK(_impl::compress_message_body(sync::BodyCodec::zlib, arena, {body.data(), body.size()}, compressed) ==
+          sync::BodyCodec::zlib);
+    CHECK_LESS(compressed.size(), body.size());
+    Buffer<char> decompressed(body.size());
+    CHECK_NOT(_impl::decompress_message_body(sync::BodyCodec::zlib, {compressed.data(), compressed.size()},
+                                             decompressed));
+    compare_out_string(body, decompressed, test_context);
+
+    // A body that does not get smaller is to be sent as is
+    std::string short_body = "AB";
+    CHECK(_impl::compress_message_body(sync::BodyCodec::zlib, arena, {short_body.data(), short_body.size()},
+                                       compressed) == sync::BodyCodec::none);
+
+    // Codec names as used in the websocket protocol tokens
+    CHECK(sync::parse_body_codec("zlib") == sync::BodyCodec::zlib);
+    CHECK(sync::parse_body_codec("none") == sync::BodyCodec::none);
+    CHECK_NOT(sync::parse_body_codec("lz4"));
+    CHECK(sync::is_valid_body_codec(1));
+    CHECK_NOT(sync::is_valid_body_codec(2));
 }
 
 TEST(Protocol_Codec_Unbind)
@@ -2138,6 +2138,90 @@ TEST(Table_EnumStringInsertEmptyRow)
     CHECK_EQUAL(2, table.get_num_unique_values(col_str));
 }
 
+TEST(Table_ColumnStatistics)
+{
+    Table table;
+    auto col_int = table.add_column(type_Int, "int", true);
+    auto col_str = table.add_column(type_String, "str");
+    auto col_list = table.add_column_list(type_Int, "list");
+    for (int64_t i = 0; i < 10000; ++i) {
+        auto obj = table.create_object();
+        if (i % 13)
+            obj.set(col_int, i % 7);
+        obj.set(col_str, util::format("str %1", i));
+    }
+
+    auto stats = table.get_column_statistics(col_int);
+    CHECK_EQUAL(stats.num_objects, 10000);
+    CHECK_EQUAL(stats.sample_size, Table::ColumnStatistics::max_sample_size);
+    CHECK_APPROXIMATELY_EQUAL(stats.null_fraction(), 1.0 / 13, 0.01);
+    CHECK_EQUAL(stats.num_distinct, 7);
+    CHECK_APPROXIMATELY_EQUAL(stats.value_fraction(false), 12.0 / 13 / 7, 0.01);
+
+    // All the sampled values are unique
+    stats = table.get_column_statistics(col_str);
+    CHECK_EQUAL(stats.num_nulls, 0);
+    CHECK_GREATER(stats.num_distinct, 3000);
+
+    stats = table.get_column_statistics(col_list);
+    CHECK_EQUAL(stats.sample_size, 0);
+
+    // Until the table is committed, sampled again only after a larger change
+    // in the number of objects
+    for (int64_t i = 0; i < 1000; ++i)
+        table.create_object();
+    CHECK_EQUAL(table.get_column_statistics(col_int).num_objects, 10000);
+    table.create_object();
+    stats = table.get_column_statistics(col_int);
+    CHECK_EQUAL(stats.num_objects, 11001);
+    CHECK_GREATER(stats.null_fraction(), 1.0 / 13);
+}
+
+TEST(Table_ColumnStatisticsAcrossVersions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    DBRef db = DB::create(make_in_realm_history(), path, DBOptions(crypt_key()));
+    ColKey col;
+    {
+        auto wt = db->start_write();
+        auto table = wt->add_table("table");
+        col = table->add_column(type_Int, "int");
+        for (int64_t i = 0; i < 100; ++i)
+            table->create_object().set(col, i);
+        wt->commit();
+    }
+
+    auto rt = db->start_read();
+    auto table = rt->get_table("table");
+    auto stats = table->get_column_statistics(col);
+    CHECK_EQUAL(stats.num_distinct, 100);
+
+    // Changes to other tables leave the statistics alone
+    {
+        auto wt = db->start_write();
+        wt->add_table("other")->create_object();
+        wt->commit();
+    }
+    rt->advance_read();
+    CHECK_EQUAL(table->get_column_statistics(col).version, stats.version);
+
+    // A new version of the table is sampled again, even with the same number
+    // of objects
+    {
+        auto wt = db->start_write();
+        auto table_w = wt->get_table("table");
+        CHECK_EQUAL(table_w->get_column_statistics(col).num_distinct, 100);
+        for (auto& obj : *table_w)
+            obj.set(col, 5);
+        CHECK_EQUAL(table_w->get_column_statistics(col).num_distinct, 100);
+        wt->commit_and_continue_as_read();
+        CHECK_EQUAL(table_w->get_column_statistics(col).num_distinct, 1);
+    }
+    rt->advance_read();
+    CHECK_NOT_EQUAL(table->get_column_statistics(col).version, stats.version);
+    CHECK_EQUAL(table->get_column_statistics(col).num_distinct, 1);
+}
+
 TEST(Table_AddColumnWithThreeLevelBptree)
 {
     Table table;
@@ -2339,6 +2339,49 @@ TEST(TableView_SortFollowedByLimit)
     }
 }
 
+TEST(TableView_SortFollowedByLimitInQuery)
+{
+    Table table;
+    auto col_first = table.add_column(type_Int, "first");
+    auto col_second = table.add_column(type_String, "second", true);
+    std::mt19937 rng(unit_test_random_seed);
+    for (int i = 0; i < 5000; ++i) {
+        auto obj = table.create_object().set(col_first, int(rng() % 300));
+        if (i % 7)
+            obj.set(col_second, util::format("s%1", rng() % 20));
+    }
+
+    auto check = [&](Query q, DescriptorOrdering ordering, size_t limit) {
+        // The same as sorting all the matches and then taking the first ones
+        auto expected = q.find_all();
+        expected.apply_descriptor_ordering(ordering);
+        ordering.append_limit(limit);
+        auto tv = q.find_all(ordering);
+        CHECK_EQUAL(tv.size(), std::min(limit, expected.size()));
+        for (size_t i = 0; i < tv.size(); ++i)
+            CHECK_EQUAL(tv.get_key(i), expected.get_key(i));
+    };
+
+    DescriptorOrdering ordering;
+    ordering.append_sort(SortDescriptor({{col_first}}));
+    check(table.where(), ordering, 20);
+    check(table.where().greater(col_first, 100), ordering, 1);
+    check(table.where().greater(col_first, 290), ordering, 50);
+    check(table.where(), ordering, 0);
+
+    ordering = DescriptorOrdering();
+    ordering.append_sort(SortDescriptor({{col_second}, {col_first}}, {false, true}));
+    check(table.where().less(col_first, 200), ordering, 30);
+
+    // Followed by more descriptors
+    ordering.append_limit(100);
+    ordering.append_distinct(DistinctDescriptor({{col_second}}));
+    auto tv = table.where().find_all(ordering);
+    CHECK_LESS_EQUAL(tv.size(), 20);
+    for (size_t i = 1; i < tv.size(); ++i)
+        CHECK_GREATER(tv.get_object(i - 1).get<String>(col_second), tv.get_object(i).get<String>(col_second));
+}
+
 TEST(TableView_Filter)
 {
     Table table;
@@ -3114,4 +3114,53 @@ TEST(Transform_SetNullDefaultVsSetDefault)
     CHECK_EQUAL(obj.get_any(col_int), Mixed(6));
 }
 
+TEST(Transform_ManyConflictGroups)
+{
+    auto changeset_dump_dir_gen = get_changeset_dump_dir_generator(test_context);
+    auto server = Peer::create_server(test_context, changeset_dump_dir_gen.get());
+    auto client_1 = Peer::create_client(test_context, 2, changeset_dump_dir_gen.get());
+    auto client_2 = Peer::create_client(test_context, 3, changeset_dump_dir_gen.get());
+
+    auto create_schema = [](WriteTransaction& tr) {
+        TableRef foo = tr.get_group().add_table_with_primary_key("class_foo", type_Int, "id");
+        foo->add_column(type_Int, "i");
+        foo->add_column(*foo, "link");
+    };
+    client_1->create_schema(create_schema);
+    client_2->create_schema(create_schema);
+    synchronize(server.get(), {client_1.get(), client_2.get()});
+
+    // Both clients change the same objects in many transactions, which are
+    // merged in conflict groups of one or two objects each, with a schema
+    // change in the middle.
+    client_1->history.set_time(1);
+    client_2->history.set_time(2);
+    for (int64_t round = 0; round < 20; ++round) {
+        for (auto& client : {client_1.get(), client_2.get()}) {
+            client->transaction([&](Peer& p) {
+                TableRef foo = p.table("class_foo");
+                for (int64_t id = 0; id < 50; ++id) {
+                    auto obj = foo->create_object_with_primary_key(id);
+                    obj.set("i", round * 100 + id + (client == client_1.get() ? 0 : 10000));
+                    if (id % 10 == round % 10)
+                        obj.set("link", foo->create_object_with_primary_key(id + 1).get_key());
+                }
+                if (round == 10 && client == client_1.get())
+                    foo->add_column(type_String, "s");
+            });
+        }
+    }
+    synchronize(server.get(), {client_1.get(), client_2.get()});
+
+    ReadTransaction read_server(server->shared_group);
+    ReadTransaction read_client_1(client_1->shared_group);
+    ReadTransaction read_client_2(client_2->shared_group);
+    CHECK(compare_groups(read_server, read_client_1));
+    CHECK(compare_groups(read_server, read_client_2, *test_context.logger));
+    auto foo = read_server.get_table("class_foo");
+    CHECK_EQUAL(foo->size(), 51);
+    CHECK(foo->get_column_key("s"));
+    CHECK_EQUAL(foo->get_object_with_primary_key(7).get<Int>("i"), 10000 + 1900 + 7);
+}
+
 } // unnamed namespace
@@ -884,4 +884,59 @@ TEST_IF(Upgrade_Database_23, REALM_MAX_BPNODE_SIZE == 4 || REALM_MAX_BPNODE_SIZE
     g.write(path);
 #endif // TEST_READ_UPGRADE_MODE
 }
+
+NONCONCURRENT_TEST(Upgrade_Database_24)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::string prefix = realm::BackupHandler::get_prefix_from_path(path);
+    File::try_remove(prefix + "v24.backup.realm");
+
+    // Build a realm file with format 24
+    _impl::GroupFriend::fake_target_file_format(24);
+    {
+        auto db = DB::create(path);
+        auto tr = db->start_write();
+        auto table = tr->add_table("table");
+        auto col = table->add_column(type_Int, "int");
+        for (int64_t i = 0; i < 1000; ++i)
+            table->create_object().set(col, 1700000000000 + i);
+        tr->commit();
+    }
+    _impl::GroupFriend::fake_target_file_format({});
+
+    // Without a history the file is not upgraded, so leaves are not offset
+    // encoded when written to it
+    {
+        DBOptions options;
+        options.offset_encode_integer_leaves = true;
+        auto db = DB::create(path, options);
+        auto tr = db->start_write();
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*tr), 24);
+        auto table = tr->get_table("table");
+        table->create_object().set("int", 1700000001000);
+        // Format 24 has no column attribute for a sorted index
+        CHECK_THROW(table->add_search_index(table->get_column_key("int"), IndexType::Sorted), IllegalOperation);
+        CHECK_EQUAL(table->search_index_type(table->get_column_key("int")), IndexType::None);
+        tr->commit();
+    }
+    {
+        Group g(path);
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(g), 24);
+        CHECK_EQUAL(g.get_table("table")->size(), 1001);
+    }
+
+    // Opening it with a history upgrades it to the current format
+    {
+        auto hist = make_in_realm_history();
+        auto db = DB::create(*hist, path);
+        auto rt = db->start_read();
+        CHECK_EQUAL(_impl::GroupFriend::get_file_format_version(*rt), Group::get_current_file_format_version());
+        auto table = rt->get_table("table");
+        CHECK_EQUAL(table->size(), 1001);
+        CHECK_EQUAL(table->get_object(table->size() - 1).get<Int>("int"), 1700000001000);
+    }
+    CHECK(File::exists(prefix + "v24.backup.realm"));
+    File::try_remove(prefix + "v24.backup.realm");
+}
+
 #endif // TEST_GROUP
@@ -0,0 +1,131 @@
+/*************************************************************************
+ *
+ * Copyright 2024 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_UTIL_WORKER_POOL
+
+#include <realm/util/worker_pool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util;
+
+TEST(Util_WorkerPool_Run)
+{
+    for (unsigned num_threads : {0, 1, 3}) {
+        WorkerPool pool(num_threads);
+        CHECK_EQUAL(pool.get_num_threads(), num_threads);
+        for (size_t count : {0, 1, 7, 1000}) {
+            std::vector<std::atomic<int>> calls(count);
+            pool.run(count, [&](size_t i) {
+                ++calls[i];
+            });
+            for (size_t i = 0; i < count; ++i)
+                CHECK_EQUAL(calls[i].load(), 1);
+        }
+    }
+}
+
+TEST(Util_WorkerPool_MaxThreads)
+{
+    WorkerPool pool(3);
+    std::atomic<int> running = 0;
+    std::atomic<int> max_running = 0;
+    pool.run(
+        100,
+        [&](size_t) {
+            int n = ++running;
+            int m = max_running.load();
+            while (n > m && !max_running.compare_exchange_weak(m, n))
+                ;
+            std::this_thread::yield();
+            --running;
+        },
+        2);
+    CHECK_LESS_EQUAL(max_running.load(), 2);
+}
+
+TEST(Util_WorkerPool_Nested)
+{
+    WorkerPool pool(2);
+    std::atomic<size_t> sum = 0;
+    pool.run(10, [&](size_t i) {
+        pool.run(10, [&](size_t j) {
+            sum += i * 10 + j;
+        });
+    });
+    CHECK_EQUAL(sum.load(), 99 * 100 / 2);
+}
+
+TEST(Util_WorkerPool_Exception)
+{
+    WorkerPool pool(2);
+    CHECK_THROW(pool.run(100,
+                         [&](size_t i) {
+                             if (i == 17)
+                                 throw std::runtime_error("failed");
+                         }),
+                std::runtime_error);
+
+    // The pool is still usable afterwards
+    std::atomic<size_t> calls = 0;
+    pool.run(50, [&](size_t) {
+        ++calls;
+    });
+    CHECK_EQUAL(calls.load(), 50);
+}
+
+TEST(Util_WorkerPool_Start)
+{
+    for (unsigned num_threads : {0, 1, 3}) {
+        WorkerPool pool(num_threads);
+        std::thread::id caller = std::this_thread::get_id();
+        std::thread::id callee;
+        auto task = pool.start([&] {
+            callee = std::this_thread::get_id();
+        });
+        task.join();
+        // Without threads in the pool, the call is made by join()
+        if (num_threads == 0)
+            CHECK(callee == caller);
+        else
+            CHECK(callee != std::thread::id());
+
+        auto failing = pool.start([&] {
+            throw std::runtime_error("failed");
+        });
+        CHECK_THROW(failing.join(), std::runtime_error);
+
+        // Destroying a task which is not joined waits for the call
+        std::atomic<bool> done = false;
+        {
+            auto unjoined = pool.start([&] {
+                done = true;
+            });
+        }
+        CHECK(done);
+    }
+}
+
+#endif // TEST_UTIL_WORKER_POOL
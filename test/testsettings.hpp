@@ -57,6 +57,7 @@
 #define TEST_GEO
 #define TEST_GROUP
 #define TEST_UPGRADE
+#define TEST_INDEX_SORTED
 #define TEST_INDEX_STRING
 #define TEST_LANG_BIND_HELPER
 #define TEST_PARSER
@@ -91,6 +92,7 @@
 #define TEST_UTIL_FIXED_SIZE_BUFFER
 #define TEST_UTIL_FUNCTIONAL
 #define TEST_UTIL_FROM_CHARS
+#define TEST_UTIL_WORKER_POOL
 
 #ifndef _WIN32
 #define TEST_UTIL_NETWORK